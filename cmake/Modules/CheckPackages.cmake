@@ -47,6 +47,21 @@ find_package(Boost ${minBoostVersion} REQUIRED)
 find_package(OpenSSL ${minOpenSSLVersion} REQUIRED)
 find_package(ZLIB ${minZlibVersion} REQUIRED)
 find_package(Qt6 ${minQt6Version} REQUIRED COMPONENTS Core Network Sql Xml LinguistTools)
+if (IO_URING AND (LibtorrentRasterbar_VERSION VERSION_LESS ${minLibtorrentVersion}))
+    message(FATAL_ERROR "The IO_URING feature requires LibtorrentRasterbar >= ${minLibtorrentVersion}")
+endif()
+if (ZSTD OR BROTLI OR IO_URING)
+    find_package(PkgConfig REQUIRED)
+endif()
+if (ZSTD)
+    pkg_check_modules(libzstd REQUIRED IMPORTED_TARGET libzstd)
+endif()
+if (BROTLI)
+    pkg_check_modules(libbrotlienc REQUIRED IMPORTED_TARGET libbrotlienc)
+endif()
+if (IO_URING)
+    pkg_check_modules(liburing REQUIRED IMPORTED_TARGET liburing)
+endif()
 if (DBUS)
     find_package(Qt6 ${minQt6Version} REQUIRED COMPONENTS DBus)
     set_package_properties(Qt6DBus PROPERTIES
@@ -243,6 +243,8 @@ Application::Application(int &argc, char **argv)
     , m_storeNotificationTorrentAdded(NOTIFICATIONS_SETTINGS_KEY(u"TorrentAdded"_s))
 #endif
 {
+    m_startupTimer.start();
+
     qRegisterMetaType<Log::Msg>("Log::Msg");
     qRegisterMetaType<Log::Peer>("Log::Peer");
 
@@ -696,6 +698,11 @@ void Application::sendTestEmail() const
     }
 }
 
+qint64 Application::elapsedSinceStartup() const
+{
+    return m_startupTimer.elapsed();
+}
+
 void Application::torrentAdded(const BitTorrent::Torrent *torrent) const
 {
     const Preferences *pref = Preferences::instance();
@@ -34,6 +34,7 @@
 
 #include <QtSystemDetection>
 #include <QCoreApplication>
+#include <QElapsedTimer>
 #include <QPointer>
 #include <QStringList>
 #include <QTranslator>
@@ -129,6 +130,8 @@ public:
 
     void sendTestEmail() const override;
 
+    qint64 elapsedSinceStartup() const override;
+
 #ifdef Q_OS_WIN
     MemoryPriority processMemoryPriority() const override;
     void setProcessMemoryPriority(MemoryPriority priority) override;
@@ -190,6 +193,7 @@ private:
     bool m_isProcessingParamsAllowed = false;
     ShutdownDialogAction m_shutdownAct = ShutdownDialogAction::Exit;
     QBtCommandLineParameters m_commandLineArgs;
+    QElapsedTimer m_startupTimer;
 
     // FileLog
     QPointer<FileLogger> m_fileLogger;
@@ -76,6 +76,7 @@ namespace
     const char KEY_SSL_CERTIFICATE[] = "qBt-sslCertificate";
     const char KEY_SSL_PRIVATE_KEY[] = "qBt-sslPrivateKey";
     const char KEY_SSL_DH_PARAMS[] = "qBt-sslDhParams";
+    const char KEY_FILE_FINGERPRINTS[] = "qBt-fileFingerprints";
 
     template <typename LTStr>
     QString fromLTString(const LTStr &str)
@@ -263,6 +264,7 @@ BitTorrent::LoadResumeDataResult BitTorrent::BencodeResumeDataStorage::loadTorre
 
     torrentParams.stopCondition = Utils::String::toEnum(
             fromLTString(resumeDataRoot.dict_find_string_value("qBt-stopCondition")), Torrent::StopCondition::None);
+    torrentParams.fileFingerprints = fileFingerprintsFromNode(resumeDataRoot.dict_find_list(KEY_FILE_FINGERPRINTS));
     torrentParams.sslParameters =
     {
         .certificate = QSslCertificate(toByteArray(resumeDataRoot.dict_find_string_value(KEY_SSL_CERTIFICATE))),
@@ -435,6 +437,8 @@ void BitTorrent::BencodeResumeDataStorage::Worker::store(const TorrentID &id, co
         data[KEY_SSL_PRIVATE_KEY] = resumeData.sslParameters.privateKey.toPem().toStdString();
     if (!resumeData.sslParameters.dhParams.isEmpty())
         data[KEY_SSL_DH_PARAMS] = resumeData.sslParameters.dhParams.toStdString();
+    if (!resumeData.fileFingerprints.isEmpty())
+        data[KEY_FILE_FINGERPRINTS] = fileFingerprintsToEntry(resumeData.fileFingerprints);
 
     if (!resumeData.useAutoTMM)
     {
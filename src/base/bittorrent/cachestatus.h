@@ -38,6 +38,7 @@ namespace BitTorrent
         qint64 jobQueueLength = 0;
         qint64 averageJobTime = 0;
         qint64 queuedBytes = 0;
-        qreal readRatio = 0;  // TODO: remove when LIBTORRENT_VERSION_NUM >= 20000
+        qreal readRatio = 0;
+        qint64 readCacheSize = 0;
     };
 }
@@ -34,43 +34,108 @@
 #include "common.h"
 
 #ifdef QBT_USES_LIBTORRENT2
-#include <libtorrent/mmap_disk_io.hpp>
-#include <libtorrent/posix_disk_io.hpp>
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <vector>
+
+#include <boost/asio/post.hpp>
+#include <libtorrent/disk_buffer_holder.hpp>
 #include <libtorrent/session.hpp>
+#include <libtorrent/torrent_info.hpp>
 
-std::unique_ptr<lt::disk_interface> customDiskIOConstructor(
-        lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters)
-{
-    return std::make_unique<CustomDiskIOThread>(lt::default_disk_io_constructor(ioContext, settings, counters));
-}
+#include <QCoreApplication>
+#include <QList>
 
-std::unique_ptr<lt::disk_interface> customPosixDiskIOConstructor(
-        lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters)
+#include "base/global.h"
+#include "base/logger.h"
+#include "diskiostatistics.h"
+
+namespace
 {
-    return std::make_unique<CustomDiskIOThread>(lt::posix_disk_io_constructor(ioContext, settings, counters));
+    // Number of read jobs passed to libtorrent at once for single rotational device
+    const int MAX_ROTATIONAL_DEVICE_ACTIVE_JOBS = 4;
+    // Number of blocks read ahead when the sequential reading of piece is detected
+    const int READ_AHEAD_BLOCKS = 4;
+
+    using Clock = std::chrono::steady_clock;
+
+    std::chrono::microseconds elapsedSince(const Clock::time_point startTime)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - startTime);
+    }
+
+    // Frees the buffers of the blocks passed to libtorrent from the read cache
+    class ReadCacheBufferAllocator final : public lt::buffer_allocator_interface
+    {
+    public:
+        void free_disk_buffer(char *buffer) override
+        {
+            delete[] buffer;
+        }
+    };
+
+    ReadCacheBufferAllocator readCacheBufferAllocator;
+
+    BitTorrent::DiskReadCache::BlockKey makeBlockKey(const lt::storage_index_t storage, const lt::piece_index_t piece, const int offset)
+    {
+        return {static_cast<int>(storage), static_cast<int>(piece), offset};
+    }
 }
 
-std::unique_ptr<lt::disk_interface> customMMapDiskIOConstructor(
-        lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters)
+DiskIOConstructor customDiskIOConstructor(DiskIOConstructor nativeDiskIOConstructor
+        , std::shared_ptr<BitTorrent::DiskIOStatistics> statistics
+        , std::shared_ptr<BitTorrent::DiskReadCache> readCache
+        , std::shared_ptr<BitTorrent::FastRecheckRegistry> fastRecheckRegistry
+        , const bool useIOUring)
 {
-    return std::make_unique<CustomDiskIOThread>(lt::mmap_disk_io_constructor(ioContext, settings, counters));
+    return [nativeDiskIOConstructor = std::move(nativeDiskIOConstructor), statistics = std::move(statistics)
+            , readCache = std::move(readCache), fastRecheckRegistry = std::move(fastRecheckRegistry), useIOUring]
+            (lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters)
+    {
+        return std::make_unique<CustomDiskIOThread>(ioContext, nativeDiskIOConstructor(ioContext, settings, counters)
+                , statistics, readCache, fastRecheckRegistry, useIOUring);
+    };
 }
 
-CustomDiskIOThread::CustomDiskIOThread(std::unique_ptr<libtorrent::disk_interface> nativeDiskIOThread)
-    : m_nativeDiskIO {std::move(nativeDiskIOThread)}
+CustomDiskIOThread::CustomDiskIOThread(lt::io_context &ioContext, std::unique_ptr<libtorrent::disk_interface> nativeDiskIOThread
+        , std::shared_ptr<BitTorrent::DiskIOStatistics> statistics
+        , std::shared_ptr<BitTorrent::DiskReadCache> readCache
+        , std::shared_ptr<BitTorrent::FastRecheckRegistry> fastRecheckRegistry
+        , [[maybe_unused]] const bool useIOUring)
+    : m_ioContext {ioContext}
+    , m_nativeDiskIO {std::move(nativeDiskIOThread)}
+    , m_statistics {std::move(statistics)}
+    , m_readCache {std::move(readCache)}
+    , m_fastRecheckRegistry {std::move(fastRecheckRegistry)}
 {
+#ifdef QBT_USES_IO_URING
+    if (useIOUring)
+    {
+        nonstd::expected<std::unique_ptr<BitTorrent::IOUringReader>, QString> ioUringReader = BitTorrent::IOUringReader::create(ioContext);
+        if (ioUringReader)
+        {
+            m_ioUringReader = std::move(ioUringReader.value());
+        }
+        else
+        {
+            LogMsg(QCoreApplication::translate("CustomDiskIOThread", "io_uring is unavailable, files are read using the default disk IO. Reason: \"%1\"")
+                    .arg(ioUringReader.error()), Log::WARNING);
+        }
+    }
+#endif
 }
 
 lt::storage_holder CustomDiskIOThread::new_torrent(const lt::storage_params &storageParams, const std::shared_ptr<void> &torrent)
 {
     lt::storage_holder storageHolder = m_nativeDiskIO->new_torrent(storageParams, torrent);
 
-    const Path savePath {storageParams.path};
     m_storageData[storageHolder] =
     {
-        savePath,
-        storageParams.mapped_files ? *storageParams.mapped_files : storageParams.files,
-        storageParams.priorities
+        .savePath = Path(storageParams.path),
+        .infoHash = storageParams.info_hash,
+        .files = storageParams.mapped_files ? *storageParams.mapped_files : storageParams.files,
+        .filePriorities = storageParams.priorities
     };
 
     return storageHolder;
@@ -78,6 +143,10 @@ lt::storage_holder CustomDiskIOThread::new_torrent(const lt::storage_params &sto
 
 void CustomDiskIOThread::remove_torrent(lt::storage_index_t storage)
 {
+    flushScheduledJobs(storage);
+    removeCachedStorage(storage);
+    closeFiles(storage);
+    m_storageData[storage].fastRecheckPieces.reset();
     m_nativeDiskIO->remove_torrent(storage);
 }
 
@@ -85,28 +154,118 @@ void CustomDiskIOThread::async_read(lt::storage_index_t storage, const lt::peer_
                                     , std::function<void (lt::disk_buffer_holder, const lt::storage_error &)> handler
                                     , lt::disk_job_flags_t flags)
 {
-    m_nativeDiskIO->async_read(storage, peerRequest, std::move(handler), flags);
+    if (!m_readCache->isEnabled())
+    {
+        m_readAheadBlocks.clear();
+    }
+    else if (readFromCache(storage, peerRequest, handler))
+    {
+        readAhead(storage, peerRequest);
+        return;
+    }
+
+    const QString device = storageData(storage).device;
+    m_statistics->addPendingJob(device);
+
+    scheduleJob(storage, peerRequest.piece, peerRequest.start
+            , [this, storage, peerRequest, flags, device, startTime = Clock::now(), handler = std::move(handler)](const QString &queueDevice) mutable
+    {
+        readBlock(storage, peerRequest, flags
+                , [this, storage, peerRequest, device, queueDevice, startTime, handler = std::move(handler)](lt::disk_buffer_holder buffer, const lt::storage_error &error)
+        {
+            m_statistics->addFinishedJob(device, BitTorrent::DiskIOStatistics::JobType::Read, elapsedSince(startTime), (error ? 0 : peerRequest.length));
+            handleScheduledJobFinished(queueDevice);
+
+            if (!error && m_readCache->isEnabled())
+            {
+                m_readCache->insert(makeBlockKey(storage, peerRequest.piece, peerRequest.start)
+                        , QByteArray(buffer.data(), buffer.size()));
+            }
+
+            handler(std::move(buffer), error);
+        });
+    });
+
+    // read ahead after the requested block is scheduled, so it doesn't take the free job slots of the device first
+    if (m_readCache->isEnabled())
+        readAhead(storage, peerRequest);
 }
 
 bool CustomDiskIOThread::async_write(lt::storage_index_t storage, const lt::peer_request &peerRequest
                                      , const char *buf, std::shared_ptr<lt::disk_observer> diskObserver
                                      , std::function<void (const lt::storage_error &)> handler, lt::disk_job_flags_t flags)
 {
-    return m_nativeDiskIO->async_write(storage, peerRequest, buf, std::move(diskObserver), std::move(handler), flags);
+    invalidateCachedBlocks(storage, peerRequest.piece, peerRequest.start, peerRequest.length);
+    dropFastRecheckPiece(storage, peerRequest.piece);
+
+    const QString device = storageData(storage).device;
+    m_statistics->addPendingJob(device);
+
+    return m_nativeDiskIO->async_write(storage, peerRequest, buf, std::move(diskObserver)
+            , [statistics = m_statistics, device, length = peerRequest.length, startTime = Clock::now(), handler = std::move(handler)]
+                    (const lt::storage_error &error)
+    {
+        statistics->addFinishedJob(device, BitTorrent::DiskIOStatistics::JobType::Write, elapsedSince(startTime), (error ? 0 : length));
+        handler(error);
+    }, flags);
 }
 
 void CustomDiskIOThread::async_hash(lt::storage_index_t storage, lt::piece_index_t piece
                                     , lt::span<lt::sha256_hash> hash, lt::disk_job_flags_t flags
                                     , std::function<void (lt::piece_index_t, const lt::sha1_hash &, const lt::storage_error &)> handler)
 {
-    m_nativeDiskIO->async_hash(storage, piece, hash, flags, std::move(handler));
+    // Pieces of unchanged files don't need to be read when torrent is rechecked.
+    // Only v1 hash can be provided this way since v2 one requires the hashes of all the piece blocks.
+    if (hash.empty())
+    {
+        if (const std::optional<lt::sha1_hash> pieceHash = takeFastRecheckPieceHash(storage, piece))
+        {
+            boost::asio::post(m_ioContext, [piece, pieceHash = *pieceHash, handler = std::move(handler)]
+            {
+                handler(piece, pieceHash, lt::storage_error());
+            });
+            return;
+        }
+    }
+
+    const QString device = storageData(storage).device;
+    m_statistics->addPendingJob(device);
+
+    const int length = m_storageData[storage].files.piece_size(piece);
+
+    scheduleJob(storage, piece, 0
+            , [this, storage, piece, hash, flags, device, length, startTime = Clock::now(), handler = std::move(handler)](const QString &queueDevice) mutable
+    {
+        m_nativeDiskIO->async_hash(storage, piece, hash, flags
+                , [this, device, queueDevice, length, startTime, handler = std::move(handler)](lt::piece_index_t piece, const lt::sha1_hash &hash, const lt::storage_error &error)
+        {
+            m_statistics->addFinishedJob(device, BitTorrent::DiskIOStatistics::JobType::Hash, elapsedSince(startTime), (error ? 0 : length));
+            handleScheduledJobFinished(queueDevice);
+            handler(piece, hash, error);
+        });
+    });
 }
 
 void CustomDiskIOThread::async_hash2(lt::storage_index_t storage, lt::piece_index_t piece
                                      , int offset, lt::disk_job_flags_t flags
                                      , std::function<void (lt::piece_index_t, const lt::sha256_hash &, const lt::storage_error &)> handler)
 {
-    m_nativeDiskIO->async_hash2(storage, piece, offset, flags, std::move(handler));
+    const QString device = storageData(storage).device;
+    m_statistics->addPendingJob(device);
+
+    const int length = std::min(lt::default_block_size, (m_storageData[storage].files.piece_size2(piece) - offset));
+
+    scheduleJob(storage, piece, offset
+            , [this, storage, piece, offset, flags, device, length, startTime = Clock::now(), handler = std::move(handler)](const QString &queueDevice) mutable
+    {
+        m_nativeDiskIO->async_hash2(storage, piece, offset, flags
+                , [this, device, queueDevice, length, startTime, handler = std::move(handler)](lt::piece_index_t piece, const lt::sha256_hash &hash, const lt::storage_error &error)
+        {
+            m_statistics->addFinishedJob(device, BitTorrent::DiskIOStatistics::JobType::Hash, elapsedSince(startTime), (error ? 0 : length));
+            handleScheduledJobFinished(queueDevice);
+            handler(piece, hash, error);
+        });
+    });
 }
 
 void CustomDiskIOThread::async_move_storage(lt::storage_index_t storage, std::string path, lt::move_flags_t flags
@@ -117,15 +276,29 @@ void CustomDiskIOThread::async_move_storage(lt::storage_index_t storage, std::st
     if (flags == lt::move_flags_t::dont_replace)
         handleCompleteFiles(storage, newSavePath);
 
+    flushScheduledJobs(storage);
+    closeFiles(storage);
+    m_storageData[storage].fastRecheckPieces.reset();
+
+    const QString device = storageData(storage).device;
+    m_statistics->addPendingJob(device);
+
     m_nativeDiskIO->async_move_storage(storage, path, flags
-            , [=, this, handler = std::move(handler)](lt::status_t status, const std::string &path, const lt::storage_error &error)
+            , [=, this, startTime = Clock::now(), handler = std::move(handler)](lt::status_t status, const std::string &path, const lt::storage_error &error)
     {
+        m_statistics->addFinishedJob(device, BitTorrent::DiskIOStatistics::JobType::MoveStorage, elapsedSince(startTime));
+
 #if LIBTORRENT_VERSION_NUM < 20100
         if ((status != lt::status_t::fatal_disk_error) && (status != lt::status_t::file_exist))
 #else
         if ((status != lt::disk_status::fatal_disk_error) && (status != lt::disk_status::file_exist))
 #endif
-            m_storageData[storage].savePath = newSavePath;
+        {
+            // the jobs keep using the previous device until the new one is known
+            StorageData &storageData = m_storageData[storage];
+            storageData.savePath = newSavePath;
+            storageData.isDeviceResolved = false;
+        }
 
         handler(status, path, error);
     });
@@ -133,6 +306,9 @@ void CustomDiskIOThread::async_move_storage(lt::storage_index_t storage, std::st
 
 void CustomDiskIOThread::async_release_files(lt::storage_index_t storage, std::function<void ()> handler)
 {
+    flushScheduledJobs(storage);
+    closeFiles(storage);
+    m_storageData[storage].fastRecheckPieces.reset();
     m_nativeDiskIO->async_release_files(storage, std::move(handler));
 }
 
@@ -141,17 +317,35 @@ void CustomDiskIOThread::async_check_files(lt::storage_index_t storage, const lt
                                            , std::function<void (lt::status_t, const lt::storage_error &)> handler)
 {
     handleCompleteFiles(storage, m_storageData[storage].savePath);
+    flushScheduledJobs(storage);
+    removeCachedStorage(storage);
+    closeFiles(storage);
+
+    // The unchanged pieces are registered right before the forced recheck (the one
+    // without resume data) is started, and are valid only for the check started here
+    StorageData &storageData = m_storageData[storage];
+    storageData.fastRecheckPieces = m_fastRecheckRegistry->take(storageData.infoHash);
+    if (resume_data)
+        storageData.fastRecheckPieces.reset();
+    storageData.fastRecheckPiecesLeft = storageData.fastRecheckPieces ? storageData.fastRecheckPieces->pieces.count(true) : 0;
+
     m_nativeDiskIO->async_check_files(storage, resume_data, std::move(links), std::move(handler));
 }
 
 void CustomDiskIOThread::async_stop_torrent(lt::storage_index_t storage, std::function<void ()> handler)
 {
+    flushScheduledJobs(storage);
+    closeFiles(storage);
+    m_storageData[storage].fastRecheckPieces.reset();
     m_nativeDiskIO->async_stop_torrent(storage, std::move(handler));
 }
 
 void CustomDiskIOThread::async_rename_file(lt::storage_index_t storage, lt::file_index_t index, std::string name
                                            , std::function<void (const std::string &, lt::file_index_t, const lt::storage_error &)> handler)
 {
+    flushScheduledJobs(storage);
+    closeFiles(storage);
+    m_storageData[storage].fastRecheckPieces.reset();
     m_nativeDiskIO->async_rename_file(storage, index, name
             , [=, this, handler = std::move(handler)](const std::string &name, lt::file_index_t index, const lt::storage_error &error)
     {
@@ -164,12 +358,19 @@ void CustomDiskIOThread::async_rename_file(lt::storage_index_t storage, lt::file
 void CustomDiskIOThread::async_delete_files(lt::storage_index_t storage, lt::remove_flags_t options
                                             , std::function<void (const lt::storage_error &)> handler)
 {
+    flushScheduledJobs(storage);
+    removeCachedStorage(storage);
+    closeFiles(storage);
+    m_storageData[storage].fastRecheckPieces.reset();
     m_nativeDiskIO->async_delete_files(storage, options, std::move(handler));
 }
 
 void CustomDiskIOThread::async_set_file_priority(lt::storage_index_t storage, lt::aux::vector<lt::download_priority_t, lt::file_index_t> priorities
                                                  , std::function<void (const lt::storage_error &, lt::aux::vector<lt::download_priority_t, lt::file_index_t>)> handler)
 {
+    flushScheduledJobs(storage);
+    // the pieces of the files can be moved between the files and the part file
+    closeFiles(storage);
     m_nativeDiskIO->async_set_file_priority(storage, std::move(priorities)
             , [=, this, handler = std::move(handler)](const lt::storage_error &error, const lt::aux::vector<lt::download_priority_t, lt::file_index_t> &priorities)
     {
@@ -181,6 +382,13 @@ void CustomDiskIOThread::async_set_file_priority(lt::storage_index_t storage, lt
 void CustomDiskIOThread::async_clear_piece(lt::storage_index_t storage, lt::piece_index_t index
                                            , std::function<void (lt::piece_index_t)> handler)
 {
+    flushScheduledJobs(storage);
+    m_readCache->removePiece(static_cast<int>(storage), static_cast<int>(index));
+    dropFastRecheckPiece(storage, index);
+    erase_if(m_readAheadBlocks, [storage, index](const BitTorrent::DiskReadCache::BlockKey &key)
+    {
+        return (key.storage == static_cast<int>(storage)) && (key.piece == static_cast<int>(index));
+    });
     m_nativeDiskIO->async_clear_piece(storage, index, std::move(handler));
 }
 
@@ -196,11 +404,18 @@ std::vector<lt::open_file_state> CustomDiskIOThread::get_status(lt::storage_inde
 
 void CustomDiskIOThread::abort(bool wait)
 {
+    for (const lt::storage_index_t storage : asConst(m_storageData.keys()))
+        flushScheduledJobs(storage);
+
     m_nativeDiskIO->abort(wait);
 }
 
 void CustomDiskIOThread::submit_jobs()
 {
+#ifdef QBT_USES_IO_URING
+    if (m_ioUringReader)
+        m_ioUringReader->submit();
+#endif
     m_nativeDiskIO->submit_jobs();
 }
 
@@ -209,6 +424,287 @@ void CustomDiskIOThread::settings_updated()
     m_nativeDiskIO->settings_updated();
 }
 
+CustomDiskIOThread::StorageData &CustomDiskIOThread::storageData(const lt::storage_index_t storage)
+{
+    // the device is looked up in the background since it requires file system access,
+    // meanwhile the jobs of the storage aren't scheduled per device
+    StorageData &storageData = m_storageData[storage];
+    if (!storageData.isDeviceResolved)
+    {
+        if (const std::optional<BitTorrent::DiskIOStatistics::Device> device = m_statistics->findDevice(storageData.savePath))
+        {
+            storageData.device = device->name;
+            storageData.isRotationalDevice = device->isRotational;
+            storageData.isDeviceResolved = true;
+        }
+    }
+
+    return storageData;
+}
+
+void CustomDiskIOThread::scheduleJob(const lt::storage_index_t storage, const lt::piece_index_t piece, const int offset
+        , std::function<void (const QString &queueDevice)> job)
+{
+    // The job is given the device whose queue it is counted in (if any) since the device
+    // of the storage may be resolved or changed before the job is finished
+    const StorageData &storageData = this->storageData(storage);
+    if (!storageData.isRotationalDevice)
+    {
+        job({});
+        return;
+    }
+
+    const QString device = storageData.device;
+    DeviceQueue &deviceQueue = m_deviceQueues[device];
+    if (deviceQueue.activeJobs < MAX_ROTATIONAL_DEVICE_ACTIVE_JOBS)
+    {
+        ++deviceQueue.activeJobs;
+        deviceQueue.headPosition = {storage, piece, offset, m_jobSequenceNumber++};
+        job(device);
+        return;
+    }
+
+    deviceQueue.waitingJobs.emplace(JobPosition(storage, piece, offset, m_jobSequenceNumber++)
+            , [device, job = std::move(job)] { job(device); });
+    updateWaitingJobs(device);
+}
+
+bool CustomDiskIOThread::hasFreeJobSlots(const lt::storage_index_t storage)
+{
+    const StorageData &storageData = this->storageData(storage);
+    if (!storageData.isRotationalDevice)
+        return true;
+
+    const DeviceQueue deviceQueue = m_deviceQueues.value(storageData.device);
+    return (deviceQueue.activeJobs < MAX_ROTATIONAL_DEVICE_ACTIVE_JOBS) && deviceQueue.waitingJobs.empty();
+}
+
+void CustomDiskIOThread::handleScheduledJobFinished(const QString &device)
+{
+    const auto deviceQueueIter = m_deviceQueues.find(device);
+    if (deviceQueueIter == m_deviceQueues.end())
+        return;
+
+    DeviceQueue &deviceQueue = deviceQueueIter.value();
+    --deviceQueue.activeJobs;
+    if (deviceQueue.waitingJobs.empty())
+        return;
+
+    // Continue from the position of the last job passed to libtorrent
+    // and start over from the beginning when the end is reached
+    auto jobIter = deviceQueue.waitingJobs.lower_bound(deviceQueue.headPosition);
+    if (jobIter == deviceQueue.waitingJobs.end())
+        jobIter = deviceQueue.waitingJobs.begin();
+
+    deviceQueue.headPosition = jobIter->first;
+    const std::function<void ()> job = std::move(jobIter->second);
+    deviceQueue.waitingJobs.erase(jobIter);
+    ++deviceQueue.activeJobs;
+    updateWaitingJobs(device);
+
+    job();
+    // libtorrent submits jobs only after its own calls, so the job passed from here needs to be submitted explicitly
+    submit_jobs();
+}
+
+void CustomDiskIOThread::flushScheduledJobs(const lt::storage_index_t storage)
+{
+    // Pass all the waiting jobs of the storage to libtorrent at once,
+    // so they are processed before any subsequent storage operation.
+    // The jobs are queued for the device known so far, so it isn't resolved here.
+    const QString device = m_storageData[storage].device;
+    const auto deviceQueueIter = m_deviceQueues.find(device);
+    if (deviceQueueIter == m_deviceQueues.end())
+        return;
+
+    DeviceQueue &deviceQueue = deviceQueueIter.value();
+    QList<std::function<void ()>> jobs;
+    for (auto jobIter = deviceQueue.waitingJobs.begin(); jobIter != deviceQueue.waitingJobs.end();)
+    {
+        if (std::get<0>(jobIter->first) == storage)
+        {
+            jobs.append(std::move(jobIter->second));
+            jobIter = deviceQueue.waitingJobs.erase(jobIter);
+        }
+        else
+        {
+            ++jobIter;
+        }
+    }
+
+    if (jobs.isEmpty())
+        return;
+
+    deviceQueue.activeJobs += static_cast<int>(jobs.size());
+    updateWaitingJobs(device);
+
+    for (const std::function<void ()> &job : asConst(jobs))
+        job();
+}
+
+void CustomDiskIOThread::updateWaitingJobs(const QString &device)
+{
+    m_statistics->setWaitingJobs(device, static_cast<qint64>(m_deviceQueues[device].waitingJobs.size()));
+}
+
+bool CustomDiskIOThread::readFromCache(const lt::storage_index_t storage, const lt::peer_request &peerRequest
+        , const std::function<void (lt::disk_buffer_holder, const lt::storage_error &)> &handler)
+{
+    const QByteArray data = m_readCache->find(makeBlockKey(storage, peerRequest.piece, peerRequest.start), peerRequest.length);
+    if (data.isEmpty())
+        return false;
+
+    auto *buffer = new char[peerRequest.length];
+    std::copy_n(data.cbegin(), peerRequest.length, buffer);
+
+    // libtorrent doesn't expect the handler to be invoked before the job is submitted
+    boost::asio::post(m_ioContext
+            , [handler, bufferHolder = lt::disk_buffer_holder(readCacheBufferAllocator, buffer, peerRequest.length)]() mutable
+    {
+        handler(std::move(bufferHolder), lt::storage_error());
+    });
+
+    return true;
+}
+
+void CustomDiskIOThread::readAhead(const lt::storage_index_t storage, const lt::peer_request &peerRequest)
+{
+    StorageData &storageData = this->storageData(storage);
+    const bool isSequentialRead = ((peerRequest.piece == storageData.nextReadPiece) && (peerRequest.start == storageData.nextReadOffset));
+    const int pieceSize = storageData.files.piece_size(peerRequest.piece);
+    int offset = peerRequest.start + peerRequest.length;
+    storageData.nextReadPiece = (offset < pieceSize) ? peerRequest.piece : lt::piece_index_t(static_cast<int>(peerRequest.piece) + 1);
+    storageData.nextReadOffset = (offset < pieceSize) ? offset : 0;
+    if (!isSequentialRead)
+        return;
+
+    // Read ahead only the rest of the current piece since the following pieces may be missing.
+    // The blocks that were not requested yet are less important than the requested ones,
+    // so they are read only using the free job slots of the rotational device and never wait in its queue.
+    for (int i = 0; (i < READ_AHEAD_BLOCKS) && (offset < pieceSize) && hasFreeJobSlots(storage); ++i, offset += lt::default_block_size)
+    {
+        const BitTorrent::DiskReadCache::BlockKey key = makeBlockKey(storage, peerRequest.piece, offset);
+        if (m_readAheadBlocks.contains(key) || m_readCache->contains(key))
+            continue;
+
+        m_readAheadBlocks.insert(key);
+
+        const lt::peer_request blockRequest {peerRequest.piece, offset, std::min(lt::default_block_size, (pieceSize - offset))};
+        const QString device = storageData.device;
+        m_statistics->addPendingJob(device);
+
+        scheduleJob(storage, blockRequest.piece, blockRequest.start
+                , [this, storage, blockRequest, key, device, startTime = Clock::now()](const QString &queueDevice)
+        {
+            readBlock(storage, blockRequest, lt::disk_interface::sequential_access
+                    , [this, key, device, queueDevice, length = blockRequest.length, startTime]
+                            (const lt::disk_buffer_holder &buffer, const lt::storage_error &error)
+            {
+                m_statistics->addFinishedJob(device, BitTorrent::DiskIOStatistics::JobType::Read, elapsedSince(startTime), (error ? 0 : length));
+                handleScheduledJobFinished(queueDevice);
+
+                if (m_readAheadBlocks.remove(key) && !error && m_readCache->isEnabled())
+                    m_readCache->insert(key, QByteArray(buffer.data(), buffer.size()));
+            });
+        });
+    }
+}
+
+void CustomDiskIOThread::readBlock(const lt::storage_index_t storage, const lt::peer_request &peerRequest, const lt::disk_job_flags_t flags
+        , std::function<void (lt::disk_buffer_holder, const lt::storage_error &)> handler)
+{
+#ifdef QBT_USES_IO_URING
+    // Only the blocks within single regular file are read using io_uring. The files
+    // with priority 0 are skipped since their pieces may be stored in the part file.
+    if (m_ioUringReader)
+    {
+        const StorageData &storageData = m_storageData[storage];
+        const std::vector<lt::file_slice> fileSlices = storageData.files.map_block(peerRequest.piece, peerRequest.start, peerRequest.length);
+        if (fileSlices.size() == 1)
+        {
+            const lt::file_index_t fileIndex = fileSlices.front().file_index;
+            const bool isPartFile = (storageData.filePriorities.end_index() > fileIndex)
+                    && (storageData.filePriorities[fileIndex] == lt::dont_download);
+            if (!isPartFile && !storageData.files.pad_file_at(fileIndex))
+            {
+                const Path filePath {storageData.files.file_path(fileIndex, storageData.savePath.toString().toStdString())};
+                if (m_ioUringReader->read(static_cast<int>(storage), static_cast<int>(fileIndex), filePath
+                        , fileSlices.front().offset, peerRequest.length, handler))
+                {
+                    return;
+                }
+            }
+        }
+    }
+#endif
+
+    m_nativeDiskIO->async_read(storage, peerRequest, std::move(handler), flags);
+}
+
+void CustomDiskIOThread::closeFiles([[maybe_unused]] const lt::storage_index_t storage)
+{
+#ifdef QBT_USES_IO_URING
+    if (m_ioUringReader)
+        m_ioUringReader->closeFiles(static_cast<int>(storage));
+#endif
+}
+
+void CustomDiskIOThread::removeCachedStorage(const lt::storage_index_t storage)
+{
+    // the storage index can be reused for another torrent, so the blocks that are still being
+    // read ahead must not get into the cache under it either
+    m_readCache->removeStorage(static_cast<int>(storage));
+    erase_if(m_readAheadBlocks, [storage](const BitTorrent::DiskReadCache::BlockKey &key)
+    {
+        return (key.storage == static_cast<int>(storage));
+    });
+}
+
+void CustomDiskIOThread::invalidateCachedBlocks(const lt::storage_index_t storage, const lt::piece_index_t piece
+        , const int offset, const int length)
+{
+    // The blocks are read as they are requested by peers, so any of them can overlap the range.
+    // The blocks being read ahead are never longer than the default block size.
+    erase_if(m_readAheadBlocks, [storage, piece, offset, length](const BitTorrent::DiskReadCache::BlockKey &key)
+    {
+        return (key.storage == static_cast<int>(storage)) && (key.piece == static_cast<int>(piece))
+                && (key.offset < (offset + length)) && ((key.offset + lt::default_block_size) > offset);
+    });
+    m_readCache->removeRange(static_cast<int>(storage), static_cast<int>(piece), offset, length);
+}
+
+std::optional<lt::sha1_hash> CustomDiskIOThread::takeFastRecheckPieceHash(const lt::storage_index_t storage, const lt::piece_index_t piece)
+{
+    const StorageData &storageData = m_storageData[storage];
+    if (!storageData.fastRecheckPieces)
+        return std::nullopt;
+
+    const BitTorrent::FastRecheckRegistry::TorrentPieces &fastRecheckPieces = *storageData.fastRecheckPieces;
+    const int pieceIndex = static_cast<int>(piece);
+    if ((pieceIndex >= fastRecheckPieces.pieces.size()) || !fastRecheckPieces.pieces.testBit(pieceIndex))
+        return std::nullopt;
+
+    const lt::sha1_hash pieceHash = fastRecheckPieces.torrentInfo->hash_for_piece(piece);
+    dropFastRecheckPiece(storage, piece);
+    return pieceHash;
+}
+
+void CustomDiskIOThread::dropFastRecheckPiece(const lt::storage_index_t storage, const lt::piece_index_t piece)
+{
+    StorageData &storageData = m_storageData[storage];
+    if (!storageData.fastRecheckPieces)
+        return;
+
+    QBitArray &pieces = storageData.fastRecheckPieces->pieces;
+    const int pieceIndex = static_cast<int>(piece);
+    if ((pieceIndex >= pieces.size()) || !pieces.testBit(pieceIndex))
+        return;
+
+    pieces.clearBit(pieceIndex);
+    if (--storageData.fastRecheckPiecesLeft == 0)
+        storageData.fastRecheckPieces.reset();
+}
+
 void CustomDiskIOThread::handleCompleteFiles(lt::storage_index_t storage, const Path &savePath)
 {
     const StorageData storageData = m_storageData[storage];
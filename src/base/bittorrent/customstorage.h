@@ -36,27 +36,52 @@
 #include "base/path.h"
 
 #ifdef QBT_USES_LIBTORRENT2
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <tuple>
+
 #include <libtorrent/disk_interface.hpp>
 #include <libtorrent/file_storage.hpp>
 #include <libtorrent/io_context.hpp>
 
 #include <QHash>
+#include <QSet>
+
+#include "diskreadcache.h"
+#include "fastrecheckregistry.h"
+
+#ifdef QBT_USES_IO_URING
+#include "iouringreader.h"
+#endif
+
+namespace BitTorrent
+{
+    class DiskIOStatistics;
+}
 #else
 #include <libtorrent/storage.hpp>
 #endif
 
 #ifdef QBT_USES_LIBTORRENT2
-std::unique_ptr<lt::disk_interface> customDiskIOConstructor(
-        lt::io_context &ioContext, lt::settings_interface const &settings, lt::counters &counters);
-std::unique_ptr<lt::disk_interface> customPosixDiskIOConstructor(
-        lt::io_context &ioContext, lt::settings_interface const &settings, lt::counters &counters);
-std::unique_ptr<lt::disk_interface> customMMapDiskIOConstructor(
-        lt::io_context &ioContext, lt::settings_interface const &settings, lt::counters &counters);
+using DiskIOConstructor = std::function<std::unique_ptr<lt::disk_interface> (
+        lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters)>;
+
+DiskIOConstructor customDiskIOConstructor(DiskIOConstructor nativeDiskIOConstructor
+        , std::shared_ptr<BitTorrent::DiskIOStatistics> statistics
+        , std::shared_ptr<BitTorrent::DiskReadCache> readCache
+        , std::shared_ptr<BitTorrent::FastRecheckRegistry> fastRecheckRegistry
+        , bool useIOUring);
 
 class CustomDiskIOThread final : public lt::disk_interface
 {
 public:
-    explicit CustomDiskIOThread(std::unique_ptr<libtorrent::disk_interface> nativeDiskIOThread);
+    CustomDiskIOThread(lt::io_context &ioContext, std::unique_ptr<libtorrent::disk_interface> nativeDiskIOThread
+            , std::shared_ptr<BitTorrent::DiskIOStatistics> statistics
+            , std::shared_ptr<BitTorrent::DiskReadCache> readCache
+            , std::shared_ptr<BitTorrent::FastRecheckRegistry> fastRecheckRegistry
+            , bool useIOUring);
 
     lt::storage_holder new_torrent(const lt::storage_params &storageParams, const std::shared_ptr<void> &torrent) override;
     void remove_torrent(lt::storage_index_t storageIndex) override;
@@ -90,17 +115,74 @@ public:
     void settings_updated() override;
 
 private:
-    void handleCompleteFiles(libtorrent::storage_index_t storage, const Path &savePath);
+    // Position of the job data on the device approximated by torrent storage, piece and offset.
+    // The last element is the sequence number of the job to keep the jobs at the same position.
+    using JobPosition = std::tuple<lt::storage_index_t, lt::piece_index_t, int, quint64>;
 
+    struct StorageData;
+
+    StorageData &storageData(lt::storage_index_t storage);
+    void handleCompleteFiles(libtorrent::storage_index_t storage, const Path &savePath);
+    void scheduleJob(lt::storage_index_t storage, lt::piece_index_t piece, int offset, std::function<void (const QString &queueDevice)> job);
+    bool hasFreeJobSlots(lt::storage_index_t storage);
+    void handleScheduledJobFinished(const QString &device);
+    void flushScheduledJobs(lt::storage_index_t storage);
+    void updateWaitingJobs(const QString &device);
+    bool readFromCache(lt::storage_index_t storage, const lt::peer_request &peerRequest
+            , const std::function<void (lt::disk_buffer_holder, const lt::storage_error &)> &handler);
+    void readAhead(lt::storage_index_t storage, const lt::peer_request &peerRequest);
+    void readBlock(lt::storage_index_t storage, const lt::peer_request &peerRequest, lt::disk_job_flags_t flags
+            , std::function<void (lt::disk_buffer_holder, const lt::storage_error &)> handler);
+    void closeFiles(lt::storage_index_t storage);
+    void removeCachedStorage(lt::storage_index_t storage);
+    void invalidateCachedBlocks(lt::storage_index_t storage, lt::piece_index_t piece, int offset, int length);
+    std::optional<lt::sha1_hash> takeFastRecheckPieceHash(lt::storage_index_t storage, lt::piece_index_t piece);
+    void dropFastRecheckPiece(lt::storage_index_t storage, lt::piece_index_t piece);
+
+    lt::io_context &m_ioContext;
     std::unique_ptr<lt::disk_interface> m_nativeDiskIO;
+    std::shared_ptr<BitTorrent::DiskIOStatistics> m_statistics;
+    std::shared_ptr<BitTorrent::DiskReadCache> m_readCache;
+    std::shared_ptr<BitTorrent::FastRecheckRegistry> m_fastRecheckRegistry;
+    // Blocks being read ahead. They are removed from here when the block is invalidated
+    // while it's being read, so the outdated data isn't put into the cache.
+    QSet<BitTorrent::DiskReadCache::BlockKey> m_readAheadBlocks;
 
     struct StorageData
     {
         Path savePath;
+        lt::sha1_hash infoHash;
         lt::file_storage files;
         lt::aux::vector<lt::download_priority_t, lt::file_index_t> filePriorities;
+        QString device;
+        bool isRotationalDevice = false;
+        bool isDeviceResolved = false;
+        // Position right after the last read, used to detect sequential reading
+        lt::piece_index_t nextReadPiece {-1};
+        int nextReadOffset = -1;
+        // Pieces that the running forced recheck doesn't need to read. They are dropped
+        // once hashed or when any operation that interrupts the check is requested.
+        std::optional<BitTorrent::FastRecheckRegistry::TorrentPieces> fastRecheckPieces;
+        qsizetype fastRecheckPiecesLeft = 0;
     };
     QHash<lt::storage_index_t, StorageData> m_storageData;
+
+    // Read jobs for rotational devices are queued per device and passed to libtorrent
+    // in elevator order with limited concurrency, so that busy hard disks don't hold
+    // the libtorrent disk threads needed by the other devices
+    struct DeviceQueue
+    {
+        int activeJobs = 0;
+        JobPosition headPosition;
+        std::map<JobPosition, std::function<void ()>> waitingJobs;
+    };
+    QHash<QString, DeviceQueue> m_deviceQueues;
+    quint64 m_jobSequenceNumber = 0;
+
+#ifdef QBT_USES_IO_URING
+    // Reads the blocks of regular files instead of the native disk I/O if io_uring is used
+    std::unique_ptr<BitTorrent::IOUringReader> m_ioUringReader;
+#endif
 };
 
 #else
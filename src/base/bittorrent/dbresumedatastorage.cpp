@@ -74,6 +74,9 @@ namespace
 
     const QString META_VERSION = u"version"_s;
 
+    // File fingerprints are stored along with libtorrent resume data
+    const char KEY_FILE_FINGERPRINTS[] = "qBt-fileFingerprints";
+
     using namespace BitTorrent;
 
     class Job
@@ -272,6 +275,7 @@ namespace
         lt::add_torrent_params &p = resumeData.ltAddTorrentParams;
 
         p = lt::read_resume_data(resumeDataRoot, ec);
+        resumeData.fileFingerprints = fileFingerprintsFromNode(resumeDataRoot.dict_find_list(KEY_FILE_FINGERPRINTS));
 
         if (const QByteArray bencodedMetadata = query.value(DB_COLUMN_METADATA.name).toByteArray()
                 ; !bencodedMetadata.isEmpty())
@@ -821,6 +825,8 @@ namespace
         };
 
         lt::entry data = lt::write_resume_data(p);
+        if (!m_resumeData.fileFingerprints.isEmpty())
+            data[KEY_FILE_FINGERPRINTS] = fileFingerprintsToEntry(m_resumeData.fileFingerprints);
 
         // metadata is stored in separate column
         QByteArray bencodedMetadata;
@@ -0,0 +1,177 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "diskiostatistics.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QStorageInfo>
+#include <QThreadPool>
+
+#include "base/global.h"
+
+using namespace BitTorrent;
+
+namespace
+{
+    void addJobLatency(DiskJobLatencyStatus &latencyStatus, const qint64 time)
+    {
+        ++latencyStatus.count;
+        latencyStatus.totalTime += time;
+        latencyStatus.maxTime = std::max(latencyStatus.maxTime, time);
+
+        const auto bucket = std::min<std::size_t>(std::bit_width(static_cast<std::uint64_t>(time))
+                , (latencyStatus.histogram.size() - 1));
+        ++latencyStatus.histogram[bucket];
+    }
+}
+
+QString DiskIOStatistics::deviceOf(Path path)
+{
+    // Save path can be not created yet, so find its nearest existing ancestor
+    while (!path.isEmpty() && !path.exists())
+    {
+        const Path parentPath = path.parentPath();
+        if (parentPath == path)
+            break;
+
+        path = parentPath;
+    }
+
+    const QStorageInfo storageInfo {path.data()};
+    return storageInfo.isValid() ? QString::fromLocal8Bit(storageInfo.device()) : QString();
+}
+
+bool DiskIOStatistics::isRotationalDevice([[maybe_unused]] const QString &device)
+{
+#ifdef Q_OS_LINUX
+    // Partitions don't provide queue attributes, so look for them at the parent block device as well
+    const QString blockDevicePath = QDir(u"/sys/class/block/"_s + QFileInfo(device).fileName()).canonicalPath();
+    if (blockDevicePath.isEmpty())
+        return false;
+
+    for (const QString &attributePath : {(blockDevicePath + u"/queue/rotational"_s), (blockDevicePath + u"/../queue/rotational"_s)})
+    {
+        QFile attributeFile {attributePath};
+        if (attributeFile.open(QIODevice::ReadOnly))
+            return attributeFile.read(1) == "1";
+    }
+#endif
+
+    return false;
+}
+
+std::optional<DiskIOStatistics::Device> DiskIOStatistics::findDevice(const Path &path)
+{
+    {
+        const QMutexLocker locker {&m_mutex};
+
+        if (const auto iter = m_pathDevices.constFind(path); iter != m_pathDevices.cend())
+            return iter.value();
+
+        if (m_pathsBeingResolved.contains(path))
+            return std::nullopt;
+        m_pathsBeingResolved.insert(path);
+    }
+
+    QThreadPool::globalInstance()->start([self = shared_from_this(), path]
+    {
+        const QString deviceName = deviceOf(path);
+        const Device device {.name = deviceName, .isRotational = isRotationalDevice(deviceName)};
+
+        const QMutexLocker locker {&self->m_mutex};
+
+        self->m_pathsBeingResolved.remove(path);
+        self->m_pathDevices.insert(path, device);
+
+        DiskDeviceIOStatus &deviceStatus = self->m_deviceStatuses[device.name];
+        deviceStatus.device = device.name;
+        deviceStatus.isRotational = device.isRotational;
+    });
+
+    return std::nullopt;
+}
+
+void DiskIOStatistics::setWaitingJobs(const QString &device, const qint64 count)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    DiskDeviceIOStatus &deviceStatus = m_deviceStatuses[device];
+    deviceStatus.device = device;
+    deviceStatus.waitingJobs = count;
+}
+
+void DiskIOStatistics::addPendingJob(const QString &device)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    DiskDeviceIOStatus &deviceStatus = m_deviceStatuses[device];
+    deviceStatus.device = device;
+    ++deviceStatus.queueDepth;
+}
+
+void DiskIOStatistics::addFinishedJob(const QString &device, const JobType type, const std::chrono::microseconds time, const qint64 bytes)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    DiskDeviceIOStatus &deviceStatus = m_deviceStatuses[device];
+    deviceStatus.device = device;
+    if (deviceStatus.queueDepth > 0)
+        --deviceStatus.queueDepth;
+
+    switch (type)
+    {
+    case JobType::Read:
+        deviceStatus.totalRead += bytes;
+        addJobLatency(deviceStatus.readLatency, time.count());
+        break;
+    case JobType::Write:
+        deviceStatus.totalWritten += bytes;
+        addJobLatency(deviceStatus.writeLatency, time.count());
+        break;
+    case JobType::Hash:
+        deviceStatus.totalHashed += bytes;
+        addJobLatency(deviceStatus.hashLatency, time.count());
+        break;
+    case JobType::MoveStorage:
+        addJobLatency(deviceStatus.moveStorageLatency, time.count());
+        break;
+    }
+}
+
+QList<DiskDeviceIOStatus> DiskIOStatistics::status() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_deviceStatuses.values();
+}
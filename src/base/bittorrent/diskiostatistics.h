@@ -0,0 +1,89 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <optional>
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+#include "base/path.h"
+#include "diskiostatus.h"
+
+namespace BitTorrent
+{
+    // Accumulates statistics of the disk jobs per storage device.
+    // Jobs are reported from libtorrent network thread while the
+    // statistics are queried from the main thread.
+    class DiskIOStatistics final : public std::enable_shared_from_this<DiskIOStatistics>
+    {
+        Q_DISABLE_COPY_MOVE(DiskIOStatistics)
+
+    public:
+        enum class JobType
+        {
+            Read,
+            Write,
+            Hash,
+            MoveStorage
+        };
+
+        struct Device
+        {
+            QString name;
+            bool isRotational = false;
+        };
+
+        DiskIOStatistics() = default;
+
+        // Returns the device of the path if it is already known, otherwise the device is looked up
+        // on a worker thread, so the slow or unresponsive mounts don't block the caller
+        std::optional<Device> findDevice(const Path &path);
+
+        void setWaitingJobs(const QString &device, qint64 count);
+        void addPendingJob(const QString &device);
+        void addFinishedJob(const QString &device, JobType type, std::chrono::microseconds time, qint64 bytes = 0);
+
+        QList<DiskDeviceIOStatus> status() const;
+
+    private:
+        static QString deviceOf(Path path);
+        static bool isRotationalDevice(const QString &device);
+
+        mutable QMutex m_mutex;
+        QHash<QString, DiskDeviceIOStatus> m_deviceStatuses;
+        QHash<Path, Device> m_pathDevices;
+        QSet<Path> m_pathsBeingResolved;
+    };
+}
@@ -0,0 +1,70 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <array>
+
+#include <QString>
+#include <QtTypes>
+
+namespace BitTorrent
+{
+    struct DiskJobLatencyStatus
+    {
+        qint64 count = 0;
+        qint64 totalTime = 0;  // microseconds
+        qint64 maxTime = 0;  // microseconds
+        // Number of jobs by their latency. Bucket 0 holds jobs completed in less
+        // than 1 microsecond, bucket N holds jobs completed in [2^(N-1), 2^N) microseconds.
+        // The last bucket also holds all the slower jobs.
+        std::array<qint64, 26> histogram {};
+    };
+
+    struct DiskDeviceIOStatus
+    {
+        QString device;
+        bool isRotational = false;
+
+        qint64 totalRead = 0;
+        qint64 totalWritten = 0;
+        qint64 totalHashed = 0;
+        qint64 readRate = 0;
+        qint64 writeRate = 0;
+        qint64 hashRate = 0;
+        // Number of jobs issued but not completed yet
+        qint64 queueDepth = 0;
+        // Number of jobs held in device queue, waiting to be passed to libtorrent
+        qint64 waitingJobs = 0;
+
+        DiskJobLatencyStatus readLatency;
+        DiskJobLatencyStatus writeLatency;
+        DiskJobLatencyStatus hashLatency;
+        DiskJobLatencyStatus moveStorageLatency;
+    };
+}
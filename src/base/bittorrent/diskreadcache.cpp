@@ -0,0 +1,228 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "diskreadcache.h"
+
+#include <QList>
+#include <QMutexLocker>
+
+#include "base/global.h"
+
+using namespace BitTorrent;
+
+namespace
+{
+    // Share of the cache size that can be occupied by protected segment
+    const int PROTECTED_SEGMENT_RATIO = 80;
+}
+
+std::size_t BitTorrent::qHash(const DiskReadCache::BlockKey &key, const std::size_t seed)
+{
+    return qHashMulti(seed, key.storage, key.piece, key.offset);
+}
+
+DiskReadCache::DiskReadCache(const qint64 maxSize)
+    : m_maxSize {maxSize}
+{
+}
+
+bool DiskReadCache::isEnabled() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return (m_maxSize > 0);
+}
+
+qint64 DiskReadCache::maxSize() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_maxSize;
+}
+
+void DiskReadCache::setMaxSize(const qint64 size)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    m_maxSize = size;
+    shrink();
+}
+
+qint64 DiskReadCache::size() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_size;
+}
+
+qint64 DiskReadCache::hits() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_hits;
+}
+
+qint64 DiskReadCache::misses() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_misses;
+}
+
+QByteArray DiskReadCache::find(const BlockKey &key, const int length)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    const auto blockIndexIter = m_blocks.constFind(key);
+    if ((blockIndexIter == m_blocks.cend()) || ((*blockIndexIter)->data.size() < length))
+    {
+        ++m_misses;
+        return {};
+    }
+
+    ++m_hits;
+
+    const BlockList::iterator blockIter = blockIndexIter.value();
+    if (blockIter->isProtected)
+    {
+        m_protectedBlocks.splice(m_protectedBlocks.begin(), m_protectedBlocks, blockIter);
+    }
+    else
+    {
+        // The block is requested again, so it's popular enough to be protected
+        blockIter->isProtected = true;
+        m_protectedSize += blockIter->data.size();
+        m_protectedBlocks.splice(m_protectedBlocks.begin(), m_probationaryBlocks, blockIter);
+
+        // Demote the least recently used protected blocks if protected segment is overfilled
+        const qint64 maxProtectedSize = m_maxSize * PROTECTED_SEGMENT_RATIO / 100;
+        while ((m_protectedSize > maxProtectedSize) && (m_protectedBlocks.size() > 1))
+        {
+            const auto demotedBlockIter = std::prev(m_protectedBlocks.end());
+            demotedBlockIter->isProtected = false;
+            m_protectedSize -= demotedBlockIter->data.size();
+            m_probationaryBlocks.splice(m_probationaryBlocks.begin(), m_protectedBlocks, demotedBlockIter);
+        }
+    }
+
+    return blockIter->data;
+}
+
+bool DiskReadCache::contains(const BlockKey &key) const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_blocks.contains(key);
+}
+
+void DiskReadCache::insert(const BlockKey &key, QByteArray data)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    if (data.size() > m_maxSize)
+        return;
+
+    if (const auto blockIndexIter = m_blocks.constFind(key); blockIndexIter != m_blocks.cend())
+        removeBlock(blockIndexIter.value());
+
+    m_size += data.size();
+    m_probationaryBlocks.push_front({.key = key, .data = std::move(data)});
+    m_blocks.insert(key, m_probationaryBlocks.begin());
+    m_storageBlocks[key.storage][key.piece].insert(key.offset);
+
+    shrink();
+}
+
+void DiskReadCache::removeRange(const int storage, const int piece, const int offset, const int length)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    // The blocks are cached as they were requested, so they may be not aligned with the range
+    const QSet<int> blockOffsets = m_storageBlocks.value(storage).value(piece);
+    QList<BlockList::iterator> removedBlocks;
+    for (const int blockOffset : blockOffsets)
+    {
+        const BlockList::iterator blockIter = m_blocks.value({storage, piece, blockOffset});
+        if ((blockOffset < (offset + length)) && ((blockOffset + blockIter->data.size()) > offset))
+            removedBlocks.append(blockIter);
+    }
+
+    for (const BlockList::iterator &blockIter : asConst(removedBlocks))
+        removeBlock(blockIter);
+}
+
+void DiskReadCache::removePiece(const int storage, const int piece)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    const QSet<int> blockOffsets = m_storageBlocks.value(storage).value(piece);
+    for (const int blockOffset : blockOffsets)
+        removeBlock(m_blocks.value({storage, piece, blockOffset}));
+}
+
+void DiskReadCache::removeStorage(const int storage)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    const QHash<int, QSet<int>> pieceBlocks = m_storageBlocks.value(storage);
+    for (auto pieceIter = pieceBlocks.cbegin(); pieceIter != pieceBlocks.cend(); ++pieceIter)
+    {
+        for (const int blockOffset : pieceIter.value())
+            removeBlock(m_blocks.value({storage, pieceIter.key(), blockOffset}));
+    }
+}
+
+void DiskReadCache::removeBlock(const BlockList::iterator blockIter)
+{
+    const BlockKey &key = blockIter->key;
+    const auto storageIter = m_storageBlocks.find(key.storage);
+    const auto pieceIter = storageIter->find(key.piece);
+    pieceIter->remove(key.offset);
+    if (pieceIter->isEmpty())
+    {
+        storageIter->erase(pieceIter);
+        if (storageIter->isEmpty())
+            m_storageBlocks.erase(storageIter);
+    }
+
+    m_blocks.remove(key);
+    m_size -= blockIter->data.size();
+    if (blockIter->isProtected)
+    {
+        m_protectedSize -= blockIter->data.size();
+        m_protectedBlocks.erase(blockIter);
+    }
+    else
+    {
+        m_probationaryBlocks.erase(blockIter);
+    }
+}
+
+void DiskReadCache::shrink()
+{
+    while (m_size > m_maxSize)
+    {
+        // Evict probationary blocks first
+        BlockList &blocks = m_probationaryBlocks.empty() ? m_protectedBlocks : m_probationaryBlocks;
+        removeBlock(std::prev(blocks.end()));
+    }
+}
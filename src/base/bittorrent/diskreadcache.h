@@ -0,0 +1,106 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <list>
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+
+namespace BitTorrent
+{
+    // Memory limited cache of the data blocks read from disk.
+    // It is segmented LRU, i.e. blocks are admitted into probationary segment
+    // and only ones requested again are promoted to protected segment,
+    // so popular blocks are not evicted by the blocks read only once.
+    // It is used from libtorrent network thread while its limit and
+    // statistics are accessed from the main thread.
+    class DiskReadCache
+    {
+        Q_DISABLE_COPY_MOVE(DiskReadCache)
+
+    public:
+        struct BlockKey
+        {
+            int storage = 0;
+            int piece = 0;
+            int offset = 0;
+
+            friend bool operator==(const BlockKey &left, const BlockKey &right) = default;
+        };
+
+        explicit DiskReadCache(qint64 maxSize = 0);
+
+        bool isEnabled() const;
+        qint64 maxSize() const;
+        void setMaxSize(qint64 size);
+
+        qint64 size() const;
+        qint64 hits() const;
+        qint64 misses() const;
+
+        // Returns the cached data of the block if it has at least given length
+        QByteArray find(const BlockKey &key, int length);
+        bool contains(const BlockKey &key) const;
+        void insert(const BlockKey &key, QByteArray data);
+        // Removes the blocks of the piece that overlap the given range of it
+        void removeRange(int storage, int piece, int offset, int length);
+        void removePiece(int storage, int piece);
+        void removeStorage(int storage);
+
+    private:
+        struct Block
+        {
+            BlockKey key;
+            QByteArray data;
+            bool isProtected = false;
+        };
+
+        using BlockList = std::list<Block>;
+
+        void removeBlock(BlockList::iterator blockIter);
+        void shrink();
+
+        mutable QMutex m_mutex;
+        qint64 m_maxSize = 0;
+        qint64 m_size = 0;
+        qint64 m_protectedSize = 0;
+        qint64 m_hits = 0;
+        qint64 m_misses = 0;
+        BlockList m_probationaryBlocks;
+        BlockList m_protectedBlocks;
+        QHash<BlockKey, BlockList::iterator> m_blocks;
+        // Offsets of the cached blocks by storage and piece
+        QHash<int, QHash<int, QSet<int>>> m_storageBlocks;
+    };
+
+    std::size_t qHash(const DiskReadCache::BlockKey &key, std::size_t seed = 0);
+}
@@ -0,0 +1,61 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "fastrecheckregistry.h"
+
+#include <QMutexLocker>
+
+using namespace BitTorrent;
+
+void FastRecheckRegistry::add(const lt::sha1_hash &infoHash, std::shared_ptr<const lt::torrent_info> torrentInfo, const QBitArray &pieces)
+{
+    const QMutexLocker locker {&m_mutex};
+    m_torrents.insert(infoHash, {.torrentInfo = std::move(torrentInfo), .pieces = pieces});
+}
+
+void FastRecheckRegistry::remove(const lt::sha1_hash &infoHash)
+{
+    const QMutexLocker locker {&m_mutex};
+    m_torrents.remove(infoHash);
+}
+
+std::optional<FastRecheckRegistry::TorrentPieces> FastRecheckRegistry::take(const lt::sha1_hash &infoHash)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    if (m_torrents.isEmpty())
+        return std::nullopt;
+
+    const auto torrentIter = m_torrents.find(infoHash);
+    if (torrentIter == m_torrents.end())
+        return std::nullopt;
+
+    TorrentPieces torrentPieces = std::move(torrentIter.value());
+    m_torrents.erase(torrentIter);
+    return torrentPieces;
+}
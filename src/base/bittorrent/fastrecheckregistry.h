@@ -0,0 +1,71 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include <libtorrent/fwd.hpp>
+#include <libtorrent/sha1_hash.hpp>
+#include <libtorrent/units.hpp>
+
+#include <QBitArray>
+#include <QHash>
+#include <QMutex>
+
+#include "infohash.h"
+
+namespace BitTorrent
+{
+    // Pieces known to be intact when the torrent is rechecked next time, so hashing
+    // their data can be skipped. The pieces are registered from the main thread right
+    // before the recheck is started and are taken by the disk I/O thread when the check
+    // job of the torrent storage begins, so they are never used outside of that check.
+    class FastRecheckRegistry
+    {
+        Q_DISABLE_COPY_MOVE(FastRecheckRegistry)
+
+    public:
+        struct TorrentPieces
+        {
+            std::shared_ptr<const lt::torrent_info> torrentInfo;
+            QBitArray pieces;
+        };
+
+        FastRecheckRegistry() = default;
+
+        void add(const lt::sha1_hash &infoHash, std::shared_ptr<const lt::torrent_info> torrentInfo, const QBitArray &pieces);
+        void remove(const lt::sha1_hash &infoHash);
+        std::optional<TorrentPieces> take(const lt::sha1_hash &infoHash);
+
+    private:
+        mutable QMutex m_mutex;
+        QHash<SHA1Hash, TorrentPieces> m_torrents;
+    };
+}
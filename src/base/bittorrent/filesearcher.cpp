@@ -27,25 +27,140 @@
  */
 
 #include "filesearcher.h"
+
+#include <algorithm>
+
+#include <QDebug>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QList>
+#include <QThread>
+
 #include "base/bittorrent/common.h"
 #include "base/bittorrent/infohash.h"
+#include "base/global.h"
+
+namespace
+{
+    // directories are listed concurrently only when there are enough of them
+    // to outweigh the overhead of dispatching the work to the other threads
+    const int MIN_DIRS_TO_LIST_CONCURRENTLY = 16;
+    // listing directories only pays off when there are many files to look for,
+    // otherwise checking the files directly requires less file system access
+    const int MIN_FILES_TO_LIST_DIRS = 16;
+
+    // file names are matched the same way as the file system compares them
+    QString normalizeFileName(const QString &fileName)
+    {
+#if defined(Q_OS_WIN) || defined(Q_OS_MACOS)
+        return fileName.toCaseFolded();
+#else
+        return fileName;
+#endif
+    }
+}
+
+FileSearcher::FileSearcher()
+{
+    // listing directories is I/O bound, so more threads than CPU cores can still be useful
+    m_threadPool.setMaxThreadCount(std::max(4, QThread::idealThreadCount()));
+}
+
+QHash<Path, FileSearcher::DirectoryListing> FileSearcher::listDirectories(const Path &rootPath, const PathList &dirPaths)
+{
+    const auto listDirectory = [&rootPath](const Path &dirPath) -> DirectoryListing
+    {
+        DirectoryListing listing;
+        QDirIterator dirIter {(rootPath / dirPath).data(), (QDir::AllEntries | QDir::Hidden | QDir::NoDotAndDotDot)};
+        while (dirIter.hasNext())
+        {
+            dirIter.next();
+            listing.insert(normalizeFileName(dirIter.fileName()));
+        }
+
+        return listing;
+    };
+
+    QList<DirectoryListing> listings;
+    listings.resize(dirPaths.size());
+
+    if (dirPaths.size() < MIN_DIRS_TO_LIST_CONCURRENTLY)
+    {
+        for (qsizetype i = 0; i < dirPaths.size(); ++i)
+            listings[i] = listDirectory(dirPaths[i]);
+    }
+    else
+    {
+        const qsizetype chunkCount = std::min<qsizetype>(m_threadPool.maxThreadCount(), dirPaths.size());
+        for (qsizetype chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            // every task writes to its own items only, so no locking is required
+            m_threadPool.start([&dirPaths, &listings, &listDirectory, chunk, chunkCount]
+            {
+                for (qsizetype i = chunk; i < dirPaths.size(); i += chunkCount)
+                    listings[i] = listDirectory(dirPaths[i]);
+            });
+        }
+        m_threadPool.waitForDone();
+    }
+
+    QHash<Path, DirectoryListing> result;
+    result.reserve(dirPaths.size());
+    for (qsizetype i = 0; i < dirPaths.size(); ++i)
+        result.insert(dirPaths[i], listings[i]);
+    return result;
+}
 
 void FileSearcher::search(const BitTorrent::TorrentID &id, const PathList &originalFileNames
                           , const Path &savePath, const Path &downloadPath, const bool forceAppendExt)
 {
-    const auto findInDir = [](const Path &dirPath, PathList &fileNames, const bool forceAppendExt) -> bool
+    QElapsedTimer elapsedTimer;
+    elapsedTimer.start();
+
+    // each directory is listed once and the file names are matched in memory
+    // instead of querying the file system for every file separately.
+    // The root folder isn't listed since it is the save path itself when torrent
+    // has no root folder, which may contain much more than the torrent files.
+    PathList dirPaths;
+    if (originalFileNames.size() >= MIN_FILES_TO_LIST_DIRS)
     {
+        QSet<Path> uniqueDirPaths;
+        for (const Path &fileName : originalFileNames)
+        {
+            const Path dirPath = fileName.parentPath();
+            if (!dirPath.isEmpty() && !uniqueDirPaths.contains(dirPath))
+            {
+                uniqueDirPaths.insert(dirPath);
+                dirPaths.append(dirPath);
+            }
+        }
+    }
+
+    int listedDirsCount = 0;
+    const auto findInDir = [this, &dirPaths, &listedDirsCount](const Path &rootPath, PathList &fileNames, const bool forceAppendExt) -> bool
+    {
+        const QHash<Path, DirectoryListing> listings = listDirectories(rootPath, dirPaths);
+        listedDirsCount += listings.size();
+
+        const auto fileExists = [&rootPath, &listings](const Path &fileName) -> bool
+        {
+            const auto listingIter = listings.constFind(fileName.parentPath());
+            if (listingIter == listings.cend())
+                return (rootPath / fileName).exists();
+            return listingIter->contains(normalizeFileName(fileName.filename()));
+        };
+
         bool found = false;
         for (Path &fileName : fileNames)
         {
-            if ((dirPath / fileName).exists())
+            if (fileExists(fileName))
             {
                 found = true;
             }
             else
             {
                 const Path incompleteFilename = fileName + QB_EXT;
-                if ((dirPath / incompleteFilename).exists())
+                if (fileExists(incompleteFilename))
                 {
                     found = true;
                     fileName = incompleteFilename;
@@ -69,5 +184,9 @@ void FileSearcher::search(const BitTorrent::TorrentID &id, const PathList &origi
         findInDir(usedPath, adjustedFileNames, forceAppendExt);
     }
 
+    qDebug("Searched for existing files of torrent. Torrent: \"%s\". Files: %lld. Directories listed: %d. Elapsed time: %lld ms"
+            , qUtf8Printable(id.toString()), static_cast<long long>(originalFileNames.size()), listedDirsCount
+            , static_cast<long long>(elapsedTimer.elapsed()));
+
     emit searchFinished(id, usedPath, adjustedFileNames);
 }
@@ -28,7 +28,10 @@
 
 #pragma once
 
+#include <QHash>
 #include <QObject>
+#include <QSet>
+#include <QThreadPool>
 
 #include "base/path.h"
 
@@ -43,7 +46,7 @@ class FileSearcher final : public QObject
     Q_DISABLE_COPY_MOVE(FileSearcher)
 
 public:
-    FileSearcher() = default;
+    FileSearcher();
 
 public slots:
     void search(const BitTorrent::TorrentID &id, const PathList &originalFileNames
@@ -51,4 +54,13 @@ public slots:
 
 signals:
     void searchFinished(const BitTorrent::TorrentID &id, const Path &savePath, const PathList &fileNames);
+
+private:
+    using DirectoryListing = QSet<QString>;
+
+    QHash<Path, DirectoryListing> listDirectories(const Path &rootPath, const PathList &dirPaths);
+
+    // used to list the directories of large torrents concurrently,
+    // since it is mostly waiting for the (possibly remote) file system
+    QThreadPool m_threadPool;
 };
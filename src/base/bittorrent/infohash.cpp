@@ -113,7 +113,7 @@ BitTorrent::TorrentID BitTorrent::TorrentID::fromSHA256Hash(const SHA256Hash &ha
 
 std::size_t BitTorrent::qHash(const BitTorrent::TorrentID &key, const std::size_t seed)
 {
-    return ::qHash(static_cast<TorrentID::BaseType>(key), seed);
+    return ::qHash(static_cast<const TorrentID::BaseType &>(key), seed);
 }
 
 std::size_t BitTorrent::qHash(const InfoHash &key, const std::size_t seed)
@@ -0,0 +1,317 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "iouringreader.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <boost/asio/error.hpp>
+#include <boost/asio/post.hpp>
+#include <libtorrent/disk_interface.hpp>
+#include <libtorrent/operations.hpp>
+
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+
+#include "base/global.h"
+
+namespace
+{
+    // Number of the registered buffers, it also limits the number of reads in flight
+    const int BUFFER_COUNT = 256;
+    // Number of submission queue entries, there are more of them than the reads in flight,
+    // so the entry that stops the completion thread can always be queued
+    const unsigned int QUEUE_DEPTH = 512;
+    // Number of files kept open in the fixed file table of the ring
+    const int MAX_OPEN_FILES = 256;
+
+    QString errorString(const int errorCode)
+    {
+        return QString::fromStdString(std::error_code(errorCode, std::generic_category()).message());
+    }
+}
+
+// The buffers are allocated at once, so they can be registered in the ring as single memory region
+class BitTorrent::IOUringReader::BufferPool final : public lt::buffer_allocator_interface
+{
+public:
+    BufferPool()
+        : m_memory {new char[BUFFER_COUNT * lt::default_block_size]}
+    {
+        m_freeBuffers.reserve(BUFFER_COUNT);
+        for (int i = 0; i < BUFFER_COUNT; ++i)
+            m_freeBuffers.append(m_memory.get() + (i * lt::default_block_size));
+    }
+
+    iovec memoryRegion() const
+    {
+        return {m_memory.get(), static_cast<std::size_t>(BUFFER_COUNT * lt::default_block_size)};
+    }
+
+    char *acquireBuffer()
+    {
+        const QMutexLocker locker {&m_mutex};
+        return !m_freeBuffers.isEmpty() ? m_freeBuffers.takeLast() : nullptr;
+    }
+
+    // the buffers are freed in the thread where libtorrent destroys their holders
+    void free_disk_buffer(char *buffer) override
+    {
+        const QMutexLocker locker {&m_mutex};
+        m_freeBuffers.append(buffer);
+    }
+
+private:
+    const std::unique_ptr<char[]> m_memory;
+    QMutex m_mutex;
+    QList<char *> m_freeBuffers;
+};
+
+struct BitTorrent::IOUringReader::ReadJob
+{
+    char *buffer = nullptr;
+    int length = 0;
+    int file = 0;
+    ReadHandler handler;
+};
+
+nonstd::expected<std::unique_ptr<BitTorrent::IOUringReader>, QString> BitTorrent::IOUringReader::create(lt::io_context &ioContext)
+{
+    std::unique_ptr<IOUringReader> reader {new IOUringReader(ioContext)};
+    if (const std::optional<QString> error = reader->init())
+        return nonstd::make_unexpected(*error);
+
+    return reader;
+}
+
+BitTorrent::IOUringReader::IOUringReader(lt::io_context &ioContext)
+    : m_ioContext {ioContext}
+    , m_bufferPool {std::make_shared<BufferPool>()}
+{
+}
+
+BitTorrent::IOUringReader::~IOUringReader()
+{
+    if (m_completionThread)
+    {
+        // The entry is drained, i.e. it's completed after all the reads submitted before it,
+        // so the completion thread passes their results to the I/O context before it stops
+        io_uring_sqe *sqe = io_uring_get_sqe(&m_ring);
+        if (!sqe)
+        {
+            io_uring_submit(&m_ring);
+            sqe = io_uring_get_sqe(&m_ring);
+        }
+        io_uring_prep_nop(sqe);
+        io_uring_sqe_set_data(sqe, nullptr);
+        io_uring_sqe_set_flags(sqe, IOSQE_IO_DRAIN);
+        io_uring_submit(&m_ring);
+
+        m_completionThread.reset();
+    }
+
+    if (m_isRingInitialized)
+        io_uring_queue_exit(&m_ring);
+}
+
+std::optional<QString> BitTorrent::IOUringReader::init()
+{
+    if (const int ret = io_uring_queue_init(QUEUE_DEPTH, &m_ring, 0); ret < 0)
+        return errorString(-ret);
+    m_isRingInitialized = true;
+
+    const iovec memoryRegion = m_bufferPool->memoryRegion();
+    if (const int ret = io_uring_register_buffers(&m_ring, &memoryRegion, 1); ret < 0)
+        return errorString(-ret);
+
+    // the table is registered empty, the files are put into it once they are read
+    std::vector<int> files(MAX_OPEN_FILES, -1);
+    if (const int ret = io_uring_register_files(&m_ring, files.data(), MAX_OPEN_FILES); ret < 0)
+        return errorString(-ret);
+
+    m_slotFiles.resize(MAX_OPEN_FILES);
+    m_freeSlots.reserve(MAX_OPEN_FILES);
+    for (int slot = (MAX_OPEN_FILES - 1); slot >= 0; --slot)
+        m_freeSlots.append(slot);
+
+    m_completionThread.reset(QThread::create([this] { processCompletions(); }));
+    m_completionThread->start();
+
+    return std::nullopt;
+}
+
+bool BitTorrent::IOUringReader::read(const int storage, const int file, const Path &filePath
+        , const qint64 offset, const int length, ReadHandler handler)
+{
+    if (length > lt::default_block_size)
+        return false;
+
+    const int slot = fileSlot(storage, file, filePath);
+    if (slot < 0)
+        return false;
+
+    char *buffer = m_bufferPool->acquireBuffer();
+    if (!buffer)
+        return false;
+
+    io_uring_sqe *sqe = io_uring_get_sqe(&m_ring);
+    if (!sqe)
+    {
+        submit();
+        sqe = io_uring_get_sqe(&m_ring);
+    }
+
+    if (!sqe)
+    {
+        m_bufferPool->free_disk_buffer(buffer);
+        return false;
+    }
+
+    io_uring_prep_read_fixed(sqe, slot, buffer, length, offset, 0);
+    io_uring_sqe_set_flags(sqe, IOSQE_FIXED_FILE);
+    io_uring_sqe_set_data(sqe, new ReadJob {buffer, length, file, std::move(handler)});
+    ++m_queuedReads;
+
+    return true;
+}
+
+void BitTorrent::IOUringReader::submit()
+{
+    if (m_queuedReads == 0)
+        return;
+
+    // the reads stay queued if they can't be submitted now, so they are submitted next time
+    if (io_uring_submit(&m_ring) >= 0)
+        m_queuedReads = 0;
+}
+
+void BitTorrent::IOUringReader::closeFiles(const int storage)
+{
+    for (int slot = 0; slot < m_slotFiles.size(); ++slot)
+    {
+        const std::optional<FileKey> &slotFile = m_slotFiles[slot];
+        if (slotFile && (slotFile->first == storage))
+            releaseFileSlot(slot);
+    }
+}
+
+int BitTorrent::IOUringReader::fileSlot(const int storage, const int file, const Path &filePath)
+{
+    const FileKey fileKey {storage, file};
+    if (const auto iter = m_fileSlots.constFind(fileKey); iter != m_fileSlots.cend())
+        return iter.value();
+
+    const int fd = ::open(QFile::encodeName(filePath.data()).constData(), (O_RDONLY | O_CLOEXEC));
+    if (fd < 0)
+        return -1;
+
+    if (m_freeSlots.isEmpty())
+    {
+        releaseFileSlot(m_nextEvictedSlot);
+        m_nextEvictedSlot = (m_nextEvictedSlot + 1) % MAX_OPEN_FILES;
+    }
+
+    // The ring holds its own reference to the file, so the descriptor isn't needed anymore.
+    // The reads that are in flight keep using the file even if it's replaced in the table.
+    const int slot = m_freeSlots.takeLast();
+    const int ret = io_uring_register_files_update(&m_ring, slot, &fd, 1);
+    ::close(fd);
+    if (ret < 0)
+    {
+        m_freeSlots.append(slot);
+        return -1;
+    }
+
+    m_slotFiles[slot] = fileKey;
+    m_fileSlots.insert(fileKey, slot);
+    return slot;
+}
+
+void BitTorrent::IOUringReader::releaseFileSlot(const int slot)
+{
+    std::optional<FileKey> &slotFile = m_slotFiles[slot];
+    if (!slotFile)
+        return;
+
+    const int fd = -1;
+    io_uring_register_files_update(&m_ring, slot, &fd, 1);
+    m_fileSlots.remove(*slotFile);
+    slotFile.reset();
+    m_freeSlots.append(slot);
+}
+
+void BitTorrent::IOUringReader::processCompletions()
+{
+    while (true)
+    {
+        io_uring_cqe *cqe = nullptr;
+        if (const int ret = io_uring_wait_cqe(&m_ring, &cqe); ret < 0)
+        {
+            if (ret == -EINTR)
+                continue;
+            break;
+        }
+
+        auto *job = static_cast<ReadJob *>(io_uring_cqe_get_data(cqe));
+        const int result = cqe->res;
+        io_uring_cqe_seen(&m_ring, cqe);
+
+        // the reader is being destroyed
+        if (!job)
+            break;
+
+        // The pool is shared with the handler, so the buffer remains valid
+        // even if the handler is destroyed without being invoked
+        boost::asio::post(m_ioContext, [bufferPool = m_bufferPool, job = std::unique_ptr<ReadJob>(job), result]
+        {
+            if (result == job->length)
+            {
+                job->handler(lt::disk_buffer_holder(*bufferPool, job->buffer, job->length), lt::storage_error());
+                return;
+            }
+
+            bufferPool->free_disk_buffer(job->buffer);
+
+            // the block is expected to be read entirely, as the native disk I/O does
+            lt::storage_error error;
+            error.ec = (result < 0) ? lt::error_code(-result, lt::system_category()) : lt::error_code(boost::asio::error::eof);
+            error.file(lt::file_index_t(job->file));
+            error.operation = lt::operation_t::file_read;
+            job->handler({}, error);
+        });
+    }
+}
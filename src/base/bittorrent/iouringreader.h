@@ -0,0 +1,100 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include <liburing.h>
+
+#include <libtorrent/disk_buffer_holder.hpp>
+#include <libtorrent/error_code.hpp>
+#include <libtorrent/io_context.hpp>
+
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include "base/3rdparty/expected.hpp"
+#include "base/path.h"
+#include "base/utils/thread.h"
+
+namespace BitTorrent
+{
+    // Reads the blocks of torrent files using Linux io_uring. The reads are queued from
+    // the libtorrent network thread and submitted to the kernel in batches, the data is
+    // read into the registered buffers and the opened files are kept in the fixed file
+    // table of the ring, so the kernel doesn't look them up on each read.
+    class IOUringReader final
+    {
+        Q_DISABLE_COPY_MOVE(IOUringReader)
+
+    public:
+        using ReadHandler = std::function<void (lt::disk_buffer_holder buffer, const lt::storage_error &error)>;
+
+        // Returns the error if io_uring isn't available, e.g. when it's disabled by the kernel
+        static nonstd::expected<std::unique_ptr<IOUringReader>, QString> create(lt::io_context &ioContext);
+
+        ~IOUringReader();
+
+        // Returns false if the read can't be queued, e.g. if the file can't be opened, so the caller
+        // can read the block in another way. Otherwise the handler is invoked in the thread
+        // of the I/O context once the read is finished.
+        bool read(int storage, int file, const Path &filePath, qint64 offset, int length, ReadHandler handler);
+        // Submits the queued reads to the kernel at once
+        void submit();
+        // Closes the files of the storage, the reads that are already queued aren't affected
+        void closeFiles(int storage);
+
+    private:
+        class BufferPool;
+        struct ReadJob;
+        using FileKey = std::pair<int, int>;
+
+        explicit IOUringReader(lt::io_context &ioContext);
+
+        std::optional<QString> init();
+        int fileSlot(int storage, int file, const Path &filePath);
+        void releaseFileSlot(int slot);
+        void processCompletions();
+
+        lt::io_context &m_ioContext;
+        io_uring m_ring {};
+        bool m_isRingInitialized = false;
+        std::shared_ptr<BufferPool> m_bufferPool;
+        QHash<FileKey, int> m_fileSlots;
+        QList<std::optional<FileKey>> m_slotFiles;
+        QList<int> m_freeSlots;
+        int m_nextEvictedSlot = 0;
+        int m_queuedReads = 0;
+        Utils::Thread::UniquePtr m_completionThread;
+    };
+}
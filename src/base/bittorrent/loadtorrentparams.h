@@ -30,10 +30,12 @@
 
 #include <libtorrent/add_torrent_params.hpp>
 
+#include <QList>
 #include <QString>
 
 #include "base/path.h"
 #include "base/tagset.h"
+#include "filefingerprint.h"
 #include "sharelimitaction.h"
 #include "sslparameters.h"
 #include "torrent.h"
@@ -66,5 +68,7 @@ namespace BitTorrent
         ShareLimitAction shareLimitAction = ShareLimitAction::Default;
 
         SSLParameters sslParameters;
+
+        QList<FileFingerprint> fileFingerprints;
     };
 }
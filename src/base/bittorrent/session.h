@@ -53,6 +53,7 @@ namespace BitTorrent
     class TorrentID;
     class TorrentInfo;
     struct CacheStatus;
+    struct DiskDeviceIOStatus;
     struct SessionStatus;
 
     enum class TorrentRemoveOption
@@ -94,7 +95,9 @@ namespace BitTorrent
         {
             Default = 0,
             MMap = 1,
-            Posix = 2
+            Posix = 2,
+            // files are read using io_uring, if available, and the rest is done by the default disk IO
+            IOUring = 3
         };
         Q_ENUM_NS(DiskIOType)
 
@@ -258,10 +261,13 @@ namespace BitTorrent
         void trackerEntryStatusesUpdated(Torrent *torrent, const QHash<QString, TrackerEntryStatus> &updatedTrackers);
         virtual bool isPerformanceWarningEnabled() const = 0;
         virtual void setPerformanceWarningEnabled(bool enable) = 0;
+        virtual void registerPeerLogConsumer(const QObject *consumer) = 0;
         virtual int saveResumeDataInterval() const = 0;
         virtual void setSaveResumeDataInterval(int value) = 0;
         virtual int shutdownTimeout() const = 0;
         virtual void setShutdownTimeout(int value) = 0;
+        virtual int metadataCacheSize() const = 0;
+        virtual void setMetadataCacheSize(int size) = 0;
         virtual int ports() const = 0;
         virtual void setPorts(const QMap<QString, QVariant> ports) = 0;
         virtual bool isSSLEnabled() const = 0;
@@ -332,6 +338,14 @@ namespace BitTorrent
         virtual void setDiskCacheSize(int size) = 0;
         virtual int diskCacheTTL() const = 0;
         virtual void setDiskCacheTTL(int ttl) = 0;
+        virtual int readCacheSize() const = 0;
+        virtual void setReadCacheSize(int size) = 0;
+        // Fast recheck trusts the file size and modification time: the pieces of the files
+        // whose size and modification time didn't change since they were verified are reported
+        // as intact without reading them. Anyone who can write to the files can change their
+        // content while keeping both, so such changes are not detected by the recheck.
+        virtual bool isFastRecheckEnabled() const = 0;
+        virtual void setFastRecheckEnabled(bool enabled) = 0;
         virtual qint64 diskQueueSize() const = 0;
         virtual void setDiskQueueSize(qint64 size) = 0;
         virtual DiskIOType diskIOType() const = 0;
@@ -453,6 +467,7 @@ namespace BitTorrent
         virtual qsizetype torrentsCount() const = 0;
         virtual const SessionStatus &status() const = 0;
         virtual const CacheStatus &cacheStatus() const = 0;
+        virtual const QList<DiskDeviceIOStatus> &diskIOStatus() const = 0;
         virtual bool isListening() const = 0;
 
         virtual void banIP(const QString &ip) = 0;
@@ -33,8 +33,10 @@
 #include <chrono>
 #include <cstdint>
 #include <ctime>
+#include <iterator>
 #include <queue>
 #include <string>
+#include <utility>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -47,6 +49,8 @@
 #include <libtorrent/add_torrent_params.hpp>
 #include <libtorrent/address.hpp>
 #include <libtorrent/alert_types.hpp>
+#include <libtorrent/bdecode.hpp>
+#include <libtorrent/entry.hpp>
 #include <libtorrent/error_code.hpp>
 #include <libtorrent/extensions/smart_ban.hpp>
 #include <libtorrent/extensions/ut_metadata.hpp>
@@ -58,6 +62,11 @@
 #include <libtorrent/session_status.hpp>
 #include <libtorrent/torrent_info.hpp>
 
+#ifdef QBT_USES_LIBTORRENT2
+#include <libtorrent/mmap_disk_io.hpp>
+#include <libtorrent/posix_disk_io.hpp>
+#endif
+
 #include <QDeadlineTimer>
 #include <QDebug>
 #include <QDir>
@@ -105,6 +114,7 @@
 #include "torrentcontentremover.h"
 #include "torrentdescriptor.h"
 #include "torrentimpl.h"
+#include "torrentmetadatacache.h"
 #include "tracker.h"
 #include "trackerentry.h"
 
@@ -112,8 +122,13 @@ using namespace std::chrono_literals;
 using namespace BitTorrent;
 
 const Path CATEGORIES_FILE_NAME {u"categories.json"_s};
+const Path SESSION_STATE_FILE_NAME {u"session.state"_s};
 const int MAX_PROCESSING_RESUMEDATA_COUNT = 50;
+const int MAX_LOADING_FILES_STATE_COUNT = 20;
 const int STATISTICS_SAVE_INTERVAL = std::chrono::milliseconds(15min).count();
+const int SESSION_STATE_SAVE_INTERVAL = std::chrono::milliseconds(15min).count();
+// Amount of DHT nodes used to measure how quickly the routing table is populated after startup
+const int DHT_NODES_WARMED_UP_COUNT = 100;
 
 namespace
 {
@@ -121,6 +136,26 @@ namespace
     const auto USER_AGENT = QStringLiteral("qBittorrent/" QBT_VERSION_2);
     const QString DEFAULT_DHT_BOOTSTRAP_NODES = u"dht.libtorrent.org:25401, dht.transmissionbt.com:6881, router.bittorrent.com:6881, router.utorrent.com:6881, dht.aelitis.com:6881"_s;
 
+    struct AlertCategory
+    {
+        lt::alert_category_t category;
+        QString name;
+    };
+
+    // Alert categories that can be enabled in alert mask, used to collect alert rate statistics
+    const AlertCategory ALERT_CATEGORIES[] =
+    {
+        {lt::alert::error_notification, u"error"_s},
+        {lt::alert::file_progress_notification, u"file_progress"_s},
+        {lt::alert::ip_block_notification, u"ip_block"_s},
+        {lt::alert::peer_notification, u"peer"_s},
+        {lt::alert::performance_warning, u"performance_warning"_s},
+        {lt::alert::port_mapping_notification, u"port_mapping"_s},
+        {lt::alert::status_notification, u"status"_s},
+        {lt::alert::storage_notification, u"storage"_s},
+        {lt::alert::tracker_notification, u"tracker"_s}
+    };
+
     void torrentQueuePositionUp(const lt::torrent_handle &handle)
     {
         try
@@ -409,6 +444,8 @@ SessionImpl::SessionImpl(QObject *parent)
     , m_checkingMemUsage(BITTORRENT_SESSION_KEY(u"CheckingMemUsageSize"_s), 32)
     , m_diskCacheSize(BITTORRENT_SESSION_KEY(u"DiskCacheSize"_s), -1)
     , m_diskCacheTTL(BITTORRENT_SESSION_KEY(u"DiskCacheTTL"_s), 60)
+    , m_readCacheSize(BITTORRENT_SESSION_KEY(u"ReadCacheSize"_s), 0, lowerLimited(0))
+    , m_isFastRecheckEnabled(BITTORRENT_SESSION_KEY(u"FastRecheck"_s), false)
     , m_diskQueueSize(BITTORRENT_SESSION_KEY(u"DiskQueueSize"_s), (1024 * 1024))
     , m_diskIOType(BITTORRENT_SESSION_KEY(u"DiskIOType"_s), DiskIOType::Default)
     , m_diskIOReadMode(BITTORRENT_SESSION_KEY(u"DiskIOReadMode"_s), DiskIOReadMode::EnableOSCache)
@@ -484,6 +521,7 @@ SessionImpl::SessionImpl(QObject *parent)
     , m_isPerformanceWarningEnabled(BITTORRENT_SESSION_KEY(u"PerformanceWarning"_s), false)
     , m_saveResumeDataInterval(BITTORRENT_SESSION_KEY(u"SaveResumeDataInterval"_s), 60)
     , m_shutdownTimeout(BITTORRENT_SESSION_KEY(u"ShutdownTimeout"_s), -1)
+    , m_metadataCacheSize(BITTORRENT_SESSION_KEY(u"MetadataCacheSize"_s), 0, lowerLimited(0))
     , m_ports(BITTORRENT_SESSION_KEY(u"Ports"_s))
     , m_portsEnabled(BITTORRENT_SESSION_KEY(u"PortsEnabled"_qs))
     , m_sslEnabled(BITTORRENT_SESSION_KEY(u"SSL/Enabled"_s), false)
@@ -599,12 +637,18 @@ SessionImpl::SessionImpl(QObject *parent)
     m_torrentContentRemover->moveToThread(m_ioThread.get());
     connect(m_ioThread.get(), &QThread::finished, m_torrentContentRemover, &QObject::deleteLater);
     connect(m_torrentContentRemover, &TorrentContentRemover::jobFinished, this, &SessionImpl::torrentContentRemovingFinished);
+    connect(m_torrentContentRemover, &TorrentContentRemover::batchProgressUpdated, this, &SessionImpl::torrentContentRemovingProgressUpdated);
 
     m_ioThread->start();
 
     initMetrics();
     loadStatistics();
 
+    m_diskReadCache->setMaxSize(static_cast<qint64>(readCacheSize()) * 1024 * 1024);
+    m_metadataCache = new TorrentMetadataCache((specialFolderLocation(SpecialFolder::Cache) / Path(u"metadata"_s))
+            , (static_cast<qint64>(metadataCacheSize()) * 1024 * 1024), this);
+    connect(m_metadataCache, &TorrentMetadataCache::loadFinished, this, &SessionImpl::handleCachedMetadataLoaded);
+
     // initialize PortForwarder instance
     new PortForwarderImpl(this);
 
@@ -633,6 +677,7 @@ SessionImpl::~SessionImpl()
     saveResumeData();
 
     saveStatistics();
+    saveSessionState();
 
     // We must delete FilterParserThread
     // before we delete lt::session
@@ -1614,9 +1659,26 @@ void SessionImpl::endStartup(ResumeSessionContext *context)
         m_isRestored = true;
         emit startupProgressUpdated(100);
         emit restored();
+
+        if (!m_torrentsWithDeferredFilesState.isEmpty())
+            QTimer::singleShot(0, Qt::CoarseTimer, this, &SessionImpl::loadDeferredFilesState);
     });
 }
 
+void SessionImpl::loadDeferredFilesState()
+{
+    // Process a small batch at a time so that UI and WebUI requests are still served in between
+    for (int i = 0; (i < MAX_LOADING_FILES_STATE_COUNT) && !m_torrentsWithDeferredFilesState.isEmpty(); ++i)
+    {
+        TorrentImpl *torrent = m_torrents.value(m_torrentsWithDeferredFilesState.takeFirst());
+        if (torrent)
+            torrent->loadFilesState();
+    }
+
+    if (!m_torrentsWithDeferredFilesState.isEmpty())
+        QTimer::singleShot(0, Qt::CoarseTimer, this, &SessionImpl::loadDeferredFilesState);
+}
+
 void SessionImpl::initializeNativeSession()
 {
     lt::settings_pack pack = loadLTSettings();
@@ -1642,18 +1704,32 @@ void SessionImpl::initializeNativeSession()
 
     lt::session_params sessionParams {std::move(pack), {}};
 #ifdef QBT_USES_LIBTORRENT2
+    loadDHTState(sessionParams);
+
+    DiskIOConstructor nativeDiskIOConstructor;
+    bool useIOUring = false;
     switch (diskIOType())
     {
     case DiskIOType::Posix:
-        sessionParams.disk_io_constructor = customPosixDiskIOConstructor;
+        nativeDiskIOConstructor = lt::posix_disk_io_constructor;
         break;
     case DiskIOType::MMap:
-        sessionParams.disk_io_constructor = customMMapDiskIOConstructor;
+        nativeDiskIOConstructor = lt::mmap_disk_io_constructor;
+        break;
+    case DiskIOType::IOUring:
+#ifdef QBT_USES_IO_URING
+        useIOUring = true;
+#else
+        LogMsg(tr("io_uring disk IO isn't supported by this build. Using the default disk IO instead."), Log::WARNING);
+#endif
+        nativeDiskIOConstructor = lt::default_disk_io_constructor;
         break;
     default:
-        sessionParams.disk_io_constructor = customDiskIOConstructor;
+        nativeDiskIOConstructor = lt::default_disk_io_constructor;
         break;
     }
+    sessionParams.disk_io_constructor = customDiskIOConstructor(std::move(nativeDiskIOConstructor)
+            , m_diskIOStatistics, m_diskReadCache, m_fastRecheckRegistry, useIOUring);
 #endif
 
 #if LIBTORRENT_VERSION_NUM < 20100
@@ -1662,6 +1738,11 @@ void SessionImpl::initializeNativeSession()
     m_nativeSession = new lt::session(sessionParams);
     m_nativeSession->pause();
 #endif
+#ifndef QBT_USES_LIBTORRENT2
+    loadDHTState();
+#endif
+    m_sessionStateLastSaveTimer.start();
+    m_dhtWarmUpTimer.start();
 
     LogMsg(tr("Peer ID: \"%1\"").arg(QString::fromStdString(peerId)), Log::INFO);
     LogMsg(tr("HTTP User-Agent: \"%1\"").arg(USER_AGENT), Log::INFO);
@@ -1757,10 +1838,11 @@ lt::settings_pack SessionImpl::loadLTSettings() const
 {
     lt::settings_pack settingsPack;
 
+    // Peer blocked/banned alerts are only used to fill the peer log
+    // so they are requested only while someone is interested in it
     const lt::alert_category_t alertMask = lt::alert::error_notification
         | lt::alert::file_progress_notification
-        | lt::alert::ip_block_notification
-        | lt::alert::peer_notification
+        | (!m_peerLogConsumers.isEmpty() ? (lt::alert::ip_block_notification | lt::alert::peer_notification) : lt::alert_category_t())
         | (isPerformanceWarningEnabled() ? lt::alert::performance_warning : lt::alert_category_t())
         | lt::alert::port_mapping_notification
         | lt::alert::status_notification
@@ -1881,7 +1963,8 @@ lt::settings_pack SessionImpl::loadLTSettings() const
 
     settingsPack.set_int(lt::settings_pack::aio_threads, asyncIOThreads());
 #ifdef QBT_USES_LIBTORRENT2
-    settingsPack.set_int(lt::settings_pack::hashing_threads, hashingThreads());
+    const int hashingThreadsCount = (hashingThreads() > 0) ? hashingThreads() : QThread::idealThreadCount();
+    settingsPack.set_int(lt::settings_pack::hashing_threads, hashingThreadsCount);
 #endif
     settingsPack.set_int(lt::settings_pack::file_pool_size, filePoolSize());
 
@@ -2365,6 +2448,18 @@ void SessionImpl::torrentContentRemovingFinished(const QString &torrentName, con
     }
 }
 
+void SessionImpl::torrentContentRemovingProgressUpdated(const int finishedJobs, const int totalJobs
+        , const qint64 removedFiles, const qint64 elapsedTime)
+{
+    // single removals are already reported by torrentContentRemovingFinished()
+    if ((finishedJobs < totalJobs) || (totalJobs < 2))
+        return;
+
+    const qint64 filesPerSecond = (elapsedTime > 0) ? ((removedFiles * 1000) / elapsedTime) : removedFiles;
+    LogMsg(tr("Finished removing content of torrents. Torrents: %1. Removed files: %2. Elapsed time: %3 ms. Throughput: %4 files/s")
+        .arg(QString::number(totalJobs), QString::number(removedFiles), QString::number(elapsedTime), QString::number(filesPerSecond)));
+}
+
 Torrent *SessionImpl::getTorrent(const TorrentID &id) const
 {
     return m_torrents.value(id);
@@ -2472,6 +2567,8 @@ bool SessionImpl::removeTorrent(const TorrentID &id, const TorrentRemoveOption d
     // Remove it from torrent resume directory
     m_resumeDataStorage->remove(torrentID);
 
+    clearFastRecheckPieces(torrent);
+
     LogMsg(tr("Torrent removed. Torrent: \"%1\"").arg(torrentName));
     delete torrent;
     return true;
@@ -2723,6 +2820,11 @@ bool SessionImpl::addTorrent_impl(const TorrentDescriptor &source, const AddTorr
     // processed or is pending to add to session
     if (m_loadingTorrents.contains(id) || (infoHash.isHybrid() && m_loadingTorrents.contains(altID)))
         return false;
+    if (const auto iter = m_cachedMetadataRequests.constFind(id)
+            ; (iter != m_cachedMetadataRequests.cend()) && iter->addTorrentParams)
+    {
+        return false;
+    }
 
     if (findTorrent(infoHash))
         return false;
@@ -2735,6 +2837,13 @@ bool SessionImpl::addTorrent_impl(const TorrentDescriptor &source, const AddTorr
     if (infoHash.isHybrid())
         cancelDownloadMetadata(altID);
 
+    // Use previously downloaded metadata if available, the torrent is added once it is loaded
+    if (!hasMetadata && m_metadataCache->load(infoHash))
+    {
+        m_cachedMetadataRequests.insert(id, {.torrentDescr = source, .addTorrentParams = addTorrentParams});
+        return true;
+    }
+
     LoadTorrentParams loadTorrentParams = initLoadTorrentParams(addTorrentParams);
     lt::add_torrent_params &p = loadTorrentParams.ltAddTorrentParams;
     p = source.ltAddTorrentParams();
@@ -3004,6 +3113,17 @@ bool SessionImpl::downloadMetadata(const TorrentDescriptor &torrentDescr)
     if (isKnownTorrent(infoHash))
         return false;
 
+    const auto id = TorrentID::fromInfoHash(infoHash);
+
+    // Use previously downloaded metadata if available. It is tracked
+    // as the metadata being downloaded until it is loaded, so it can be canceled.
+    if (m_metadataCache->load(infoHash))
+    {
+        m_cachedMetadataRequests.insert(id, {.torrentDescr = torrentDescr, .addTorrentParams = std::nullopt});
+        m_downloadedMetadata.insert(id, {});
+        return true;
+    }
+
     lt::add_torrent_params p = torrentDescr.ltAddTorrentParams();
 
     if (isAddTrackersEnabled())
@@ -3034,7 +3154,6 @@ bool SessionImpl::downloadMetadata(const TorrentDescriptor &torrentDescr)
     p.max_connections = maxConnectionsPerTorrent();
     p.max_uploads = maxUploadsPerTorrent();
 
-    const auto id = TorrentID::fromInfoHash(infoHash);
     const Path savePath = Utils::Fs::tempPath() / Path(id.toString());
     p.save_path = savePath.toString().toStdString();
 
@@ -3546,6 +3665,25 @@ void SessionImpl::setPerformanceWarningEnabled(const bool enable)
     configureDeferred();
 }
 
+void SessionImpl::registerPeerLogConsumer(const QObject *consumer)
+{
+    Q_ASSERT(consumer);
+
+    if (m_peerLogConsumers.contains(consumer))
+        return;
+
+    m_peerLogConsumers.insert(consumer);
+    connect(consumer, &QObject::destroyed, this, [this, consumer]
+    {
+        m_peerLogConsumers.remove(consumer);
+        if (m_peerLogConsumers.isEmpty())
+            configureDeferred();
+    });
+
+    if (m_peerLogConsumers.size() == 1)
+        configureDeferred();
+}
+
 int SessionImpl::saveResumeDataInterval() const
 {
     return m_saveResumeDataInterval;
@@ -3579,6 +3717,20 @@ void SessionImpl::setShutdownTimeout(const int value)
     m_shutdownTimeout = value;
 }
 
+int SessionImpl::metadataCacheSize() const
+{
+    return m_metadataCacheSize;
+}
+
+void SessionImpl::setMetadataCacheSize(const int size)
+{
+    if (size == m_metadataCacheSize)
+        return;
+
+    m_metadataCacheSize = size;
+    m_metadataCache->setMaxSize(static_cast<qint64>(metadataCacheSize()) * 1024 * 1024);
+}
+
 int SessionImpl::ports() const
 {
     return m_ports;
@@ -4223,7 +4375,7 @@ void SessionImpl::setAsyncIOThreads(const int num)
 
 int SessionImpl::hashingThreads() const
 {
-    return std::clamp(m_hashingThreads.get(), 1, 1024);
+    return std::clamp(m_hashingThreads.get(), 0, 1024);
 }
 
 void SessionImpl::setHashingThreads(const int num)
@@ -4305,6 +4457,30 @@ void SessionImpl::setDiskCacheTTL(const int ttl)
     }
 }
 
+int SessionImpl::readCacheSize() const
+{
+    return m_readCacheSize;
+}
+
+void SessionImpl::setReadCacheSize(const int size)
+{
+    if (size == m_readCacheSize)
+        return;
+
+    m_readCacheSize = size;
+    m_diskReadCache->setMaxSize(static_cast<qint64>(readCacheSize()) * 1024 * 1024);
+}
+
+bool SessionImpl::isFastRecheckEnabled() const
+{
+    return m_isFastRecheckEnabled;
+}
+
+void SessionImpl::setFastRecheckEnabled(const bool enabled)
+{
+    m_isFastRecheckEnabled = enabled;
+}
+
 qint64 SessionImpl::diskQueueSize() const
 {
     return m_diskQueueSize;
@@ -4950,6 +5126,11 @@ bool SessionImpl::isKnownTorrent(const InfoHash &infoHash) const
         return true;
     if (m_downloadedMetadata.contains(id) || (isHybrid && m_downloadedMetadata.contains(altID)))
         return true;
+    if (const auto iter = m_cachedMetadataRequests.constFind(id)
+            ; (iter != m_cachedMetadataRequests.cend()) && iter->addTorrentParams)
+    {
+        return true;
+    }
     return findTorrent(infoHash);
 }
 
@@ -5035,6 +5216,8 @@ void SessionImpl::handleTorrentUrlSeedsRemoved(TorrentImpl *const torrent, const
 
 void SessionImpl::handleTorrentMetadataReceived(TorrentImpl *const torrent)
 {
+    m_metadataCache->store(torrent->info());
+
     if (!torrentExportDirectory().isEmpty())
         exportTorrentFile(torrent, torrentExportDirectory());
 
@@ -5068,6 +5251,16 @@ void SessionImpl::handleTorrentChecked(TorrentImpl *const torrent)
     emit torrentFinishedChecking(torrent);
 }
 
+void SessionImpl::setFastRecheckPieces(const TorrentImpl *torrent, const QBitArray &pieces)
+{
+    m_fastRecheckRegistry->add(torrent->infoHash().v1(), torrent->nativeTorrentInfo(), pieces);
+}
+
+void SessionImpl::clearFastRecheckPieces(const TorrentImpl *torrent)
+{
+    m_fastRecheckRegistry->remove(torrent->infoHash().v1());
+}
+
 void SessionImpl::handleTorrentFinished(TorrentImpl *const torrent)
 {
     m_pendingFinishedTorrents.append(torrent);
@@ -5104,6 +5297,14 @@ void SessionImpl::handleTorrentStorageMovingStateChanged(TorrentImpl *torrent)
     emit torrentsUpdated({torrent});
 }
 
+void SessionImpl::handleTorrentCachedValueLookup(const bool isHit)
+{
+    if (isHit)
+        ++m_torrentCachedValueHits;
+    else
+        ++m_torrentCachedValueMisses;
+}
+
 bool SessionImpl::addMoveTorrentStorageJob(TorrentImpl *torrent, const Path &newPath, const MoveStorageMode mode, const MoveStorageContext context)
 {
     Q_ASSERT(torrent);
@@ -5365,6 +5566,11 @@ const CacheStatus &SessionImpl::cacheStatus() const
     return m_cacheStatus;
 }
 
+const QList<DiskDeviceIOStatus> &SessionImpl::diskIOStatus() const
+{
+    return m_diskIOStatus;
+}
+
 void SessionImpl::enqueueRefresh()
 {
     Q_ASSERT(!m_refreshEnqueued);
@@ -5429,6 +5635,8 @@ void SessionImpl::setTorrentContentLayout(const TorrentContentLayout value)
 // Read alerts sent by libtorrent session
 void SessionImpl::readAlerts()
 {
+    static_assert(std::size(ALERT_CATEGORIES) == std::tuple_size_v<decltype(m_alertCounters)>);
+
     const std::vector<lt::alert *> alerts = getPendingAlerts();
 
     Q_ASSERT(m_loadedTorrents.isEmpty());
@@ -5438,7 +5646,16 @@ void SessionImpl::readAlerts()
         m_loadedTorrents.reserve(MAX_PROCESSING_RESUMEDATA_COUNT);
 
     for (const lt::alert *a : alerts)
+    {
+        const lt::alert_category_t category = a->category();
+        for (std::size_t i = 0; i < std::size(ALERT_CATEGORIES); ++i)
+        {
+            if (category & ALERT_CATEGORIES[i].category)
+                ++m_alertCounters[i];
+        }
+
         handleAlert(a);
+    }
 
     if (m_receivedAddTorrentAlertsCount > 0)
     {
@@ -5676,6 +5893,8 @@ TorrentImpl *SessionImpl::createTorrent(const lt::torrent_handle &nativeHandle,
 {
     auto *const torrent = new TorrentImpl(this, m_nativeSession, nativeHandle, params);
     m_torrents.insert(torrent->id(), torrent);
+    if (!torrent->isFilesStateLoaded())
+        m_torrentsWithDeferredFilesState.append(torrent->id());
     if (const InfoHash infoHash = torrent->infoHash(); infoHash.isHybrid())
         m_hybridTorrentsByAltID.insert(TorrentID::fromSHA1Hash(infoHash.v1()), torrent);
 
@@ -5791,11 +6010,46 @@ void SessionImpl::handleMetadataReceivedAlert(const lt::metadata_received_alert
     {
         const TorrentInfo metadata {*alert->handle.torrent_file()};
         m_nativeSession->remove_torrent(alert->handle, lt::session::delete_files);
+        m_metadataCache->store(metadata);
 
         emit metadataDownloaded(metadata);
     }
 }
 
+void SessionImpl::handleCachedMetadataLoaded(const InfoHash &infoHash, const TorrentInfo &metadata)
+{
+    const auto id = TorrentID::fromInfoHash(infoHash);
+    const auto iter = m_cachedMetadataRequests.find(id);
+    if (iter == m_cachedMetadataRequests.end())
+        return;
+
+    CachedMetadataRequest request = iter.value();
+    m_cachedMetadataRequests.erase(iter);
+
+    if (request.addTorrentParams)
+    {
+        // The cached metadata is removed if it couldn't be loaded, so the torrent is added without it then
+        if (metadata.isValid())
+            request.torrentDescr.setTorrentInfo(metadata);
+        if (!addTorrent_impl(request.torrentDescr, *request.addTorrentParams))
+            emit addTorrentFailed(infoHash, tr("The torrent is already added or is being added"));
+        return;
+    }
+
+    // The metadata download could be canceled meanwhile
+    if (const auto downloadedMetadataIter = m_downloadedMetadata.find(id)
+            ; (downloadedMetadataIter == m_downloadedMetadata.end()) || downloadedMetadataIter->is_valid())
+    {
+        return;
+    }
+
+    m_downloadedMetadata.remove(id);
+    if (metadata.isValid())
+        emit metadataDownloaded(metadata);
+    else
+        downloadMetadata(request.torrentDescr);
+}
+
 void SessionImpl::handleFileErrorAlert(const lt::file_error_alert *alert)
 {
     TorrentImpl *const torrent = m_torrents.value(alert->handle.info_hash());
@@ -5968,6 +6222,9 @@ void SessionImpl::handleSessionStatsAlert(const lt::session_stats_alert *alert)
     m_status.trackerDownloadRate = calcRate(m_status.trackerDownload, trackerDownload);
     m_status.trackerUploadRate = calcRate(m_status.trackerUpload, trackerUpload);
 
+    for (std::size_t i = 0; i < std::size(ALERT_CATEGORIES); ++i)
+        m_status.alertRates[ALERT_CATEGORIES[i].name] = calcRate(0, std::exchange(m_alertCounters[i], 0));
+
     m_status.totalPayloadDownload = totalPayloadDownload;
     m_status.totalPayloadUpload = totalPayloadUpload;
     m_status.ipOverheadDownload = ipOverheadDownload;
@@ -5982,6 +6239,10 @@ void SessionImpl::handleSessionStatsAlert(const lt::session_stats_alert *alert)
     m_status.diskReadQueue = stats[m_metricIndices.peer.numPeersUpDisk];
     m_status.diskWriteQueue = stats[m_metricIndices.peer.numPeersDownDisk];
     m_status.peersCount = stats[m_metricIndices.peer.numPeersConnected];
+    m_status.metadataCacheHits = m_metadataCache->hits();
+    m_status.metadataCacheMisses = m_metadataCache->misses();
+    m_status.torrentCachedValueHits = m_torrentCachedValueHits;
+    m_status.torrentCachedValueMisses = m_torrentCachedValueMisses;
 
     if (totalDownload > m_status.totalDownload)
     {
@@ -6001,6 +6262,17 @@ void SessionImpl::handleSessionStatsAlert(const lt::session_stats_alert *alert)
     if (m_statisticsLastUpdateTimer.hasExpired(STATISTICS_SAVE_INTERVAL))
         saveStatistics();
 
+    if (m_sessionStateLastSaveTimer.hasExpired(SESSION_STATE_SAVE_INTERVAL))
+        saveSessionState();
+
+    if (!m_isDHTWarmUpReported && (m_status.dhtNodes >= DHT_NODES_WARMED_UP_COUNT))
+    {
+        m_isDHTWarmUpReported = true;
+        LogMsg(tr("DHT routing table has reached %1 nodes. Elapsed time: %2 s. Startup type: %3")
+            .arg(QString::number(m_status.dhtNodes), QString::number(m_dhtWarmUpTimer.elapsed() / 1000.0, 'f', 1)
+                , (m_isDHTStateRestored ? tr("restored DHT state") : tr("cold start"))));
+    }
+
     m_cacheStatus.totalUsedBuffers = stats[m_metricIndices.disk.diskBlocksInUse];
     m_cacheStatus.jobQueueLength = stats[m_metricIndices.disk.queuedDiskJobs];
 
@@ -6008,6 +6280,10 @@ void SessionImpl::handleSessionStatsAlert(const lt::session_stats_alert *alert)
     const int64_t numBlocksRead = stats[m_metricIndices.disk.numBlocksRead];
     const int64_t numBlocksCacheHits = stats[m_metricIndices.disk.numBlocksCacheHits];
     m_cacheStatus.readRatio = static_cast<qreal>(numBlocksCacheHits) / std::max<int64_t>((numBlocksCacheHits + numBlocksRead), 1);
+#else
+    const qint64 numReadCacheHits = m_diskReadCache->hits();
+    m_cacheStatus.readRatio = static_cast<qreal>(numReadCacheHits) / std::max<qint64>((numReadCacheHits + m_diskReadCache->misses()), 1);
+    m_cacheStatus.readCacheSize = m_diskReadCache->size();
 #endif
 
     const int64_t totalJobs = stats[m_metricIndices.disk.writeJobs] + stats[m_metricIndices.disk.readJobs]
@@ -6015,6 +6291,20 @@ void SessionImpl::handleSessionStatsAlert(const lt::session_stats_alert *alert)
     m_cacheStatus.averageJobTime = (totalJobs > 0)
                                    ? (stats[m_metricIndices.disk.diskJobTime] / totalJobs) : 0;
 
+    QList<DiskDeviceIOStatus> diskIOStatus = m_diskIOStatistics->status();
+    for (DiskDeviceIOStatus &deviceStatus : diskIOStatus)
+    {
+        const auto prevDeviceStatusIter = std::find_if(m_diskIOStatus.cbegin(), m_diskIOStatus.cend()
+                , [&device = deviceStatus.device](const DiskDeviceIOStatus &prevDeviceStatus) { return (prevDeviceStatus.device == device); });
+        if (prevDeviceStatusIter == m_diskIOStatus.cend())
+            continue;
+
+        deviceStatus.readRate = calcRate(prevDeviceStatusIter->totalRead, deviceStatus.totalRead);
+        deviceStatus.writeRate = calcRate(prevDeviceStatusIter->totalWritten, deviceStatus.totalWritten);
+        deviceStatus.hashRate = calcRate(prevDeviceStatusIter->totalHashed, deviceStatus.totalHashed);
+    }
+    m_diskIOStatus = std::move(diskIOStatus);
+
     emit statsUpdated();
 }
 
@@ -6242,6 +6532,84 @@ void SessionImpl::saveStatistics() const
     m_isStatisticsDirty = false;
 }
 
+#ifdef QBT_USES_LIBTORRENT2
+void SessionImpl::loadDHTState(lt::session_params &sessionParams)
+#else
+void SessionImpl::loadDHTState()
+#endif
+{
+    const Path path = specialFolderLocation(SpecialFolder::Data) / SESSION_STATE_FILE_NAME;
+    if (!path.exists())
+        return;
+
+    const int fileMaxSize = 10 * 1024 * 1024;
+    const auto readResult = Utils::IO::readFile(path, fileMaxSize);
+    if (!readResult)
+    {
+        LogMsg(tr("Failed to load session state. %1").arg(readResult.error().message), Log::WARNING);
+        return;
+    }
+
+    const auto *pref = Preferences::instance();
+
+    lt::error_code ec;
+    const lt::bdecode_node root = lt::bdecode(readResult.value(), ec
+            , nullptr, pref->getBdecodeDepthLimit(), pref->getBdecodeTokenLimit());
+    if (ec || (root.type() != lt::bdecode_node::dict_t))
+    {
+        LogMsg(tr("Failed to parse session state. File: \"%1\". Error: \"%2\"")
+            .arg(path.toString(), (ec ? QString::fromStdString(ec.message()) : tr("Invalid data format"))), Log::WARNING);
+        return;
+    }
+
+#ifdef QBT_USES_LIBTORRENT2
+    // Only DHT state is taken from the loaded parameters, they also contain
+    // default extensions which are added separately depending on settings
+    sessionParams.dht_state = lt::read_session_params(root, lt::session::save_dht_state).dht_state;
+    const qsizetype nodesCount = sessionParams.dht_state.nodes.size() + sessionParams.dht_state.nodes6.size();
+#else
+    // libtorrent 1.2 can restore DHT state only into an already created session
+    m_nativeSession->load_state(root, lt::session::save_dht_state);
+
+    qsizetype nodesCount = 0;
+    if (const lt::bdecode_node dhtState = root.dict_find_dict("dht state"))
+    {
+        if (const lt::bdecode_node nodes = dhtState.dict_find_list("nodes"))
+            nodesCount += nodes.list_size();
+        if (const lt::bdecode_node nodes6 = dhtState.dict_find_list("nodes6"))
+            nodesCount += nodes6.list_size();
+    }
+#endif
+
+    m_isDHTStateRestored = (nodesCount > 0);
+    if (m_isDHTStateRestored)
+        LogMsg(tr("Restored DHT state. Nodes: %1").arg(QString::number(nodesCount)));
+}
+
+void SessionImpl::saveSessionState() const
+{
+    m_sessionStateLastSaveTimer.start();
+
+    if (!isDHTEnabled())
+        return;
+
+#ifdef QBT_USES_LIBTORRENT2
+    const lt::entry sessionState = lt::write_session_params(m_nativeSession->session_state(lt::session::save_dht_state)
+            , lt::session::save_dht_state);
+#else
+    lt::entry sessionState;
+    m_nativeSession->save_state(sessionState, lt::session::save_dht_state);
+#endif
+
+    const Path path = specialFolderLocation(SpecialFolder::Data) / SESSION_STATE_FILE_NAME;
+    const nonstd::expected<void, QString> result = Utils::IO::saveToFile(path, sessionState);
+    if (!result)
+    {
+        LogMsg(tr("Failed to save session state. File: \"%1\". Error: \"%2\"")
+               .arg(path.toString(), result.error()), Log::WARNING);
+    }
+}
+
 void SessionImpl::loadStatistics()
 {
     const std::unique_ptr<QSettings> settings = Profile::instance()->applicationSettings(u"qBittorrent-data"_s);
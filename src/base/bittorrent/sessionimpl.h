@@ -29,6 +29,9 @@
 
 #pragma once
 
+#include <array>
+#include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -51,8 +54,13 @@
 #include "addtorrentparams.h"
 #include "cachestatus.h"
 #include "categoryoptions.h"
+#include "diskiostatistics.h"
+#include "diskiostatus.h"
+#include "diskreadcache.h"
+#include "fastrecheckregistry.h"
 #include "session.h"
 #include "sessionstatus.h"
+#include "torrentdescriptor.h"
 #include "torrentinfo.h"
 #include "trackerentrystatus.h"
 
@@ -76,8 +84,8 @@ namespace BitTorrent
     class ResumeDataStorage;
     class Torrent;
     class TorrentContentRemover;
-    class TorrentDescriptor;
     class TorrentImpl;
+    class TorrentMetadataCache;
     class Tracker;
 
     struct LoadTorrentParams;
@@ -232,10 +240,13 @@ namespace BitTorrent
 
         bool isPerformanceWarningEnabled() const override;
         void setPerformanceWarningEnabled(bool enable) override;
+        void registerPeerLogConsumer(const QObject *consumer) override;
         int saveResumeDataInterval() const override;
         void setSaveResumeDataInterval(int value) override;
         int shutdownTimeout() const override;
         void setShutdownTimeout(int value) override;
+        int metadataCacheSize() const override;
+        void setMetadataCacheSize(int size) override;
         int ports() const override;
         void setPorts(const QMap<QString, QVariant> ports) override;
         bool isSSLEnabled() const override;
@@ -306,6 +317,10 @@ namespace BitTorrent
         void setDiskCacheSize(int size) override;
         int diskCacheTTL() const override;
         void setDiskCacheTTL(int ttl) override;
+        int readCacheSize() const override;
+        void setReadCacheSize(int size) override;
+        bool isFastRecheckEnabled() const override;
+        void setFastRecheckEnabled(bool enabled) override;
         qint64 diskQueueSize() const override;
         void setDiskQueueSize(qint64 size) override;
         DiskIOType diskIOType() const override;
@@ -427,6 +442,7 @@ namespace BitTorrent
         qsizetype torrentsCount() const override;
         const SessionStatus &status() const override;
         const CacheStatus &cacheStatus() const override;
+        const QList<DiskDeviceIOStatus> &diskIOStatus() const override;
         bool isListening() const override;
 
         void banIP(const QString &ip) override;
@@ -455,6 +471,8 @@ namespace BitTorrent
         void handleTorrentStopped(TorrentImpl *torrent);
         void handleTorrentStarted(TorrentImpl *torrent);
         void handleTorrentChecked(TorrentImpl *torrent);
+        void setFastRecheckPieces(const TorrentImpl *torrent, const QBitArray &pieces);
+        void clearFastRecheckPieces(const TorrentImpl *torrent);
         void handleTorrentFinished(TorrentImpl *torrent);
         void handleTorrentTrackersAdded(TorrentImpl *torrent, const QList<TrackerEntry> &newTrackers);
         void handleTorrentTrackersRemoved(TorrentImpl *torrent, const QStringList &deletedTrackers);
@@ -464,6 +482,7 @@ namespace BitTorrent
         void handleTorrentResumeDataReady(TorrentImpl *torrent, const LoadTorrentParams &data);
         void handleTorrentInfoHashChanged(TorrentImpl *torrent, const InfoHash &prevInfoHash);
         void handleTorrentStorageMovingStateChanged(TorrentImpl *torrent);
+        void handleTorrentCachedValueLookup(bool isHit);
 
         bool addMoveTorrentStorageJob(TorrentImpl *torrent, const Path &newPath, MoveStorageMode mode, MoveStorageContext context);
 
@@ -495,6 +514,7 @@ namespace BitTorrent
         void handleIPFilterError();
         void fileSearchFinished(const TorrentID &id, const Path &savePath, const PathList &fileNames);
         void torrentContentRemovingFinished(const QString &torrentName, const QString &errorMessage);
+        void torrentContentRemovingProgressUpdated(int finishedJobs, int totalJobs, qint64 removedFiles, qint64 elapsedTime);
 
     private:
         struct ResumeSessionContext;
@@ -515,6 +535,13 @@ namespace BitTorrent
             TorrentRemoveOption removeOption {};
         };
 
+        struct CachedMetadataRequest
+        {
+            TorrentDescriptor torrentDescr;
+            // not set if only the metadata is requested
+            std::optional<AddTorrentParams> addTorrentParams;
+        };
+
         explicit SessionImpl(QObject *parent = nullptr);
         ~SessionImpl();
 
@@ -546,6 +573,7 @@ namespace BitTorrent
         void handleLoadedResumeData(ResumeSessionContext *context);
         void processNextResumeData(ResumeSessionContext *context);
         void endStartup(ResumeSessionContext *context);
+        void loadDeferredFilesState();
 
         LoadTorrentParams initLoadTorrentParams(const AddTorrentParams &addTorrentParams);
         bool addTorrent_impl(const TorrentDescriptor &source, const AddTorrentParams &addTorrentParams);
@@ -558,6 +586,7 @@ namespace BitTorrent
         void handleAddTorrentAlert(const lt::add_torrent_alert *alert);
         void handleStateUpdateAlert(const lt::state_update_alert *alert);
         void handleMetadataReceivedAlert(const lt::metadata_received_alert *alert);
+        void handleCachedMetadataLoaded(const InfoHash &infoHash, const TorrentInfo &metadata);
         void handleFileErrorAlert(const lt::file_error_alert *alert);
         void handleTorrentRemovedAlert(const lt::torrent_removed_alert *alert);
         void handleTorrentDeletedAlert(const lt::torrent_deleted_alert *alert);
@@ -601,6 +630,12 @@ namespace BitTorrent
 
         void saveStatistics() const;
         void loadStatistics();
+#ifdef QBT_USES_LIBTORRENT2
+        void loadDHTState(lt::session_params &sessionParams);
+#else
+        void loadDHTState();
+#endif
+        void saveSessionState() const;
 
         void updateTrackerEntryStatuses(lt::torrent_handle torrentHandle, QHash<std::string, QHash<lt::tcp::endpoint, QMap<int, int>>> updatedTrackers);
 
@@ -621,6 +656,8 @@ namespace BitTorrent
         CachedSettingValue<int> m_checkingMemUsage;
         CachedSettingValue<int> m_diskCacheSize;
         CachedSettingValue<int> m_diskCacheTTL;
+        CachedSettingValue<int> m_readCacheSize;
+        CachedSettingValue<bool> m_isFastRecheckEnabled;
         CachedSettingValue<qint64> m_diskQueueSize;
         CachedSettingValue<DiskIOType> m_diskIOType;
         CachedSettingValue<DiskIOReadMode> m_diskIOReadMode;
@@ -690,6 +727,7 @@ namespace BitTorrent
         CachedSettingValue<bool> m_isPerformanceWarningEnabled;
         CachedSettingValue<int> m_saveResumeDataInterval;
         CachedSettingValue<int> m_shutdownTimeout;
+        CachedSettingValue<int> m_metadataCacheSize;
         CachedSettingValue<int> m_port;
         CachedSettingValue<bool> m_sslEnabled;
         CachedSettingValue<int> m_sslPort;
@@ -755,6 +793,10 @@ namespace BitTorrent
         // Statistics
         mutable QElapsedTimer m_statisticsLastUpdateTimer;
         mutable bool m_isStatisticsDirty = false;
+        mutable QElapsedTimer m_sessionStateLastSaveTimer;
+        QElapsedTimer m_dhtWarmUpTimer;
+        bool m_isDHTStateRestored = false;
+        bool m_isDHTWarmUpReported = false;
         qint64 m_previouslyUploaded = 0;
         qint64 m_previouslyDownloaded = 0;
 
@@ -773,9 +815,13 @@ namespace BitTorrent
         QThreadPool *m_asyncWorker = nullptr;
         ResumeDataStorage *m_resumeDataStorage = nullptr;
         FileSearcher *m_fileSearcher = nullptr;
+        TorrentMetadataCache *m_metadataCache = nullptr;
+        qint64 m_torrentCachedValueHits = 0;
+        qint64 m_torrentCachedValueMisses = 0;
         TorrentContentRemover *m_torrentContentRemover = nullptr;
 
         QHash<TorrentID, lt::torrent_handle> m_downloadedMetadata;
+        QHash<TorrentID, CachedMetadataRequest> m_cachedMetadataRequests;
 
         QHash<TorrentID, TorrentImpl *> m_torrents;
         QHash<TorrentID, TorrentImpl *> m_hybridTorrentsByAltID;
@@ -787,6 +833,7 @@ namespace BitTorrent
 
         qsizetype m_receivedAddTorrentAlertsCount = 0;
         QList<Torrent *> m_loadedTorrents;
+        QList<TorrentID> m_torrentsWithDeferredFilesState;
 
         // This field holds amounts of peers reported by trackers in their responses to announces
         // (torrent.tracker_name.tracker_local_endpoint.protocol_version.num_peers)
@@ -798,9 +845,15 @@ namespace BitTorrent
 
         SessionMetricIndices m_metricIndices;
         lt::time_point m_statsLastTimestamp = lt::clock_type::now();
+        std::array<qint64, 9> m_alertCounters {};
+        QSet<const QObject *> m_peerLogConsumers;
 
         SessionStatus m_status;
         CacheStatus m_cacheStatus;
+        std::shared_ptr<DiskIOStatistics> m_diskIOStatistics = std::make_shared<DiskIOStatistics>();
+        std::shared_ptr<DiskReadCache> m_diskReadCache = std::make_shared<DiskReadCache>();
+        std::shared_ptr<FastRecheckRegistry> m_fastRecheckRegistry = std::make_shared<FastRecheckRegistry>();
+        QList<DiskDeviceIOStatus> m_diskIOStatus;
 
         QList<MoveStorageJob> m_moveStorageQueue;
 
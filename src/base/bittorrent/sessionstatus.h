@@ -29,6 +29,8 @@
 #pragma once
 
 #include <QtTypes>
+#include <QMap>
+#include <QString>
 
 namespace BitTorrent
 {
@@ -73,5 +75,12 @@ namespace BitTorrent
         qint64 diskWriteQueue = 0;
         qint64 dhtNodes = 0;
         qint64 peersCount = 0;
+        qint64 metadataCacheHits = 0;
+        qint64 metadataCacheMisses = 0;
+        qint64 torrentCachedValueHits = 0;
+        qint64 torrentCachedValueMisses = 0;
+
+        // Number of alerts received per second, by alert category
+        QMap<QString, qint64> alertRates;
     };
 }
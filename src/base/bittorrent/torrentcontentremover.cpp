@@ -28,34 +28,175 @@
 
 #include "torrentcontentremover.h"
 
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+#endif
+
+#include <QFile>
+#include <QHash>
+#include <QMutexLocker>
+
 #include "base/utils/fs.h"
 
-void BitTorrent::TorrentContentRemover::performJob(const QString &torrentName, const Path &basePath
-        , const PathList &fileNames, const TorrentContentRemoveOption option)
+namespace
 {
-    QString errorMessage;
+    // Content removal is bound by the file system metadata operations, so a few concurrent jobs
+    // are enough to hide the latency, while more of them would only contend for the same disk
+    const int MAX_CONCURRENT_JOBS = 4;
 
-    if (!fileNames.isEmpty())
+    struct RemovalResult
     {
-        const auto removeFileFn = [&option](const Path &filePath)
-        {
-            return ((option == TorrentContentRemoveOption::MoveToTrash)
-                    ? Utils::Fs::moveFileToTrash : Utils::Fs::removeFile)(filePath);
-        };
+        QString errorMessage;
+        qint64 removedFiles = 0;
+    };
 
+    QString removalErrorMessage(const Path &filePath, const QString &reason)
+    {
+        return BitTorrent::TorrentContentRemover::tr("Cannot remove file \"%1\". Reason: \"%2\"")
+            .arg(filePath.toString(), reason);
+    }
+
+#ifdef Q_OS_UNIX
+    // Removes the files relative to the descriptor of their directory that is opened only once,
+    // so the kernel doesn't need to resolve the entire path for every file
+    RemovalResult removeFiles(const Path &basePath, const PathList &fileNames)
+    {
+        QHash<Path, QStringList> filesByDir;
         for (const Path &fileName : fileNames)
         {
-            if (const auto result = removeFileFn(basePath / fileName)
-                    ; !result && errorMessage.isEmpty())
+            const Path filePath = basePath / fileName;
+            filesByDir[filePath.parentPath()].append(filePath.filename());
+        }
+
+        RemovalResult result;
+        for (auto it = filesByDir.cbegin(); it != filesByDir.cend(); ++it)
+        {
+            const Path &dirPath = it.key();
+            const int dirFD = ::open(QFile::encodeName(dirPath.toString()).constData(), (O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+            if (dirFD < 0)
             {
-                errorMessage = result.error();
+                // the directory (and so the files) doesn't exist anymore
+                if (errno != ENOENT)
+                {
+                    for (const QString &name : it.value())
+                    {
+                        const Path filePath = dirPath / Path(name);
+                        if (const auto removeResult = Utils::Fs::removeFile(filePath); removeResult)
+                            ++result.removedFiles;
+                        else if (result.errorMessage.isEmpty())
+                            result.errorMessage = removalErrorMessage(filePath, removeResult.error());
+                    }
+                }
+                continue;
             }
+
+            for (const QString &name : it.value())
+            {
+                if (::unlinkat(dirFD, QFile::encodeName(name).constData(), 0) == 0)
+                {
+                    ++result.removedFiles;
+                }
+                else if (const int error = errno; (error != ENOENT) && result.errorMessage.isEmpty())
+                {
+                    // std::strerror() isn't thread-safe
+                    const std::string reason = std::error_code(error, std::generic_category()).message();
+                    result.errorMessage = removalErrorMessage((dirPath / Path(name)), QString::fromLocal8Bit(reason));
+                }
+            }
+
+            ::close(dirFD);
         }
 
+        return result;
+    }
+#endif
+
+    RemovalResult removeContent(const Path &basePath, const PathList &fileNames, const BitTorrent::TorrentContentRemoveOption option
+            , QMutex &pruningMutex)
+    {
+        if (fileNames.isEmpty())
+            return {};
+
+        RemovalResult result;
+#ifdef Q_OS_UNIX
+        if (option == BitTorrent::TorrentContentRemoveOption::Delete)
+        {
+            result = removeFiles(basePath, fileNames);
+        }
+        else
+#endif
+        {
+            const auto removeFileFn = ((option == BitTorrent::TorrentContentRemoveOption::MoveToTrash)
+                    ? Utils::Fs::moveFileToTrash : Utils::Fs::removeFile);
+            for (const Path &fileName : fileNames)
+            {
+                const Path filePath = basePath / fileName;
+                if (const auto removeResult = removeFileFn(filePath); removeResult)
+                    ++result.removedFiles;
+                else if (result.errorMessage.isEmpty())
+                    result.errorMessage = removalErrorMessage(filePath, removeResult.error());
+            }
+        }
+
+        // Prune the directories that became empty, starting from the deepest ones.
+        // The torrents can share the folders (e.g. the root folder of one torrent can be inside
+        // the one of another torrent), so the concurrent jobs could remove the directory
+        // while another one is listing it, that's why the pruning is serialized.
         const Path rootPath = Path::findRootFolder(fileNames);
         if (!rootPath.isEmpty())
+        {
+            const QMutexLocker locker {&pruningMutex};
             Utils::Fs::smartRemoveEmptyFolderTree(basePath / rootPath);
+        }
+
+        return result;
     }
+}
+
+BitTorrent::TorrentContentRemover::TorrentContentRemover(QObject *parent)
+    : QObject(parent)
+{
+    m_threadPool.setMaxThreadCount(MAX_CONCURRENT_JOBS);
+}
+
+BitTorrent::TorrentContentRemover::~TorrentContentRemover()
+{
+    m_threadPool.waitForDone();
+}
+
+void BitTorrent::TorrentContentRemover::performJob(const QString &torrentName, const Path &basePath
+        , const PathList &fileNames, const TorrentContentRemoveOption option)
+{
+    if (m_batchFinishedJobs == m_batchTotalJobs)
+    {
+        m_batchTotalJobs = 0;
+        m_batchFinishedJobs = 0;
+        m_batchRemovedFiles = 0;
+        m_batchTimer.start();
+    }
+
+    ++m_batchTotalJobs;
+
+    m_threadPool.start([this, torrentName, basePath, fileNames, option]
+    {
+        const RemovalResult result = removeContent(basePath, fileNames, option, m_pruningMutex);
+        QMetaObject::invokeMethod(this, [this, torrentName, result]
+        {
+            handleJobFinished(torrentName, result.errorMessage, result.removedFiles);
+        });
+    });
+}
+
+void BitTorrent::TorrentContentRemover::handleJobFinished(const QString &torrentName, const QString &errorMessage, const qint64 removedFiles)
+{
+    ++m_batchFinishedJobs;
+    m_batchRemovedFiles += removedFiles;
 
     emit jobFinished(torrentName, errorMessage);
+    emit batchProgressUpdated(m_batchFinishedJobs, m_batchTotalJobs, m_batchRemovedFiles, m_batchTimer.elapsed());
 }
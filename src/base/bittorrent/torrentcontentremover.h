@@ -28,7 +28,10 @@
 
 #pragma once
 
+#include <QElapsedTimer>
+#include <QMutex>
 #include <QObject>
+#include <QThreadPool>
 
 #include "base/path.h"
 #include "torrentcontentremoveoption.h"
@@ -41,13 +44,28 @@ namespace BitTorrent
         Q_DISABLE_COPY_MOVE(TorrentContentRemover)
 
     public:
-        using QObject::QObject;
+        explicit TorrentContentRemover(QObject *parent = nullptr);
+        ~TorrentContentRemover() override;
 
     public slots:
+        // Jobs are performed concurrently in the background, so the call doesn't block
         void performJob(const QString &torrentName, const Path &basePath
                 , const PathList &fileNames, TorrentContentRemoveOption option);
 
     signals:
         void jobFinished(const QString &torrentName, const QString &errorMessage);
+        // Batch consists of the jobs that were performed without the remover getting idle in between
+        void batchProgressUpdated(int finishedJobs, int totalJobs, qint64 removedFiles, qint64 elapsedTime);
+
+    private:
+        void handleJobFinished(const QString &torrentName, const QString &errorMessage, qint64 removedFiles);
+
+        QThreadPool m_threadPool;
+        QMutex m_pruningMutex;
+
+        int m_batchTotalJobs = 0;
+        int m_batchFinishedJobs = 0;
+        qint64 m_batchRemovedFiles = 0;
+        QElapsedTimer m_batchTimer;
     };
 }
@@ -30,22 +30,35 @@
 
 #include "torrentcreator.h"
 
+#include <algorithm>
 #include <functional>
+#include <iterator>
+#include <optional>
+#include <vector>
 
+#include <libtorrent/bencode.hpp>
 #include <libtorrent/create_torrent.hpp>
 #include <libtorrent/file_storage.hpp>
+#include <libtorrent/settings_pack.hpp>
 #include <libtorrent/torrent_info.hpp>
 
+#include <QCryptographicHash>
 #include <QDirIterator>
+#include <QFile>
 #include <QFileInfo>
 #include <QHash>
+#include <QThread>
 
 #include "base/exceptions.h"
 #include "base/global.h"
+#include "base/logger.h"
+#include "base/profile.h"
 #include "base/utils/compare.h"
 #include "base/utils/io.h"
 #include "base/version.h"
+#include "filefingerprint.h"
 #include "lttypecast.h"
+#include "torrentcreatorhashcache.h"
 
 namespace
 {
@@ -70,6 +83,61 @@ namespace
         }
         return {};
     }
+
+    Path hashCacheFilePath(const Path &sourcePath, const int pieceSize, const BitTorrent::TorrentFormat torrentFormat)
+    {
+        const QByteArray key = sourcePath.data().toUtf8() + '\n' + QByteArray::number(pieceSize)
+                + '\n' + QByteArray::number(static_cast<int>(torrentFormat));
+        const QString fileName = QString::fromLatin1(QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex()) + u".cache";
+        return specialFolderLocation(SpecialFolder::Cache) / Path(u"torrentCreator"_s) / Path(fileName);
+    }
+
+    const qsizetype SHA1_HASH_SIZE = 20;
+    const qsizetype SHA256_HASH_SIZE = 32;
+
+    QByteArray toByteArray(const lt::sha1_hash &hash)
+    {
+        return {hash.data(), SHA1_HASH_SIZE};
+    }
+
+    QByteArray toByteArray(const lt::sha256_hash &hash)
+    {
+        return {hash.data(), SHA256_HASH_SIZE};
+    }
+
+    int filePieceCount(const lt::file_storage &fs, const lt::file_index_t fileIndex, const int pieceSize)
+    {
+        return static_cast<int>((fs.file_size(fileIndex) + pieceSize - 1) / pieceSize);
+    }
+
+    bool isFollowedByPadFile(const lt::file_storage &fs, const lt::file_index_t fileIndex)
+    {
+        lt::file_index_t nextFileIndex = fileIndex;
+        ++nextFileIndex;
+        return (nextFileIndex < fs.end_file()) && fs.pad_file_at(nextFileIndex);
+    }
+
+    // The last piece of the file may be shared with the padding (but never with the other file)
+    // in hybrid torrents, so its v1 hash can be calculated without reading the entire piece
+    std::optional<QByteArray> calculateV1TailHash(const Path &filePath, const qint64 fileSize, const int pieceSize, const bool isPadded)
+    {
+        const qint64 tailOffset = (fileSize / pieceSize) * pieceSize;
+        const qint64 tailSize = fileSize - tailOffset;
+
+        QFile file {filePath.data()};
+        if (!file.open(QIODevice::ReadOnly) || !file.seek(tailOffset))
+            return std::nullopt;
+
+        const QByteArray tail = file.read(tailSize);
+        if (tail.size() != tailSize)
+            return std::nullopt;
+
+        QCryptographicHash hash {QCryptographicHash::Sha1};
+        hash.addData(tail);
+        if (isPadded)
+            hash.addData(QByteArray((pieceSize - tailSize), '\0'));
+        return hash.result();
+    }
 #endif
 }
 
@@ -183,12 +251,39 @@ void TorrentCreator::run()
         }
 
         // calculate the hash for all pieces
+#ifdef QBT_USES_LIBTORRENT2
+        // Pieces are hashed in parallel using libtorrent disk I/O subsystem, so they
+        // can be completed out of order and the progress is tracked by their number
+        lt::settings_pack settingsPack;
+        settingsPack.set_int(lt::settings_pack::hashing_threads, QThread::idealThreadCount());
+
+        // v1 pieces of v1-only torrents span the file boundaries, so the hashes can't be reused
+        HashCacheStats hashCacheStats;
+        if (m_params.isHashCacheEnabled && (m_params.torrentFormat != TorrentFormat::V1))
+        {
+            hashCacheStats = setPieceHashesUsingCache(newTorrent, parentPath, settingsPack);
+        }
+        else
+        {
+            int hashedPieces = 0;
+            lt::error_code ec;
+            lt::set_piece_hashes(newTorrent, parentPath.toString().toStdString(), settingsPack
+                , [this, &newTorrent, &hashedPieces]([[maybe_unused]] const lt::piece_index_t n)
+            {
+                checkInterruptionRequested();
+                sendProgressSignal(++hashedPieces, newTorrent.num_pieces());
+            }, ec);
+            if (ec)
+                throw RuntimeError(QString::fromLocal8Bit(ec.message().c_str()));
+        }
+#else
         lt::set_piece_hashes(newTorrent, parentPath.toString().toStdString()
             , [this, &newTorrent](const lt::piece_index_t n)
         {
             checkInterruptionRequested();
             sendProgressSignal(LT::toUnderlyingType(n), newTorrent.num_pieces());
         });
+#endif
 
         // Set qBittorrent as creator and add user comment to
         // torrent_info structure
@@ -225,7 +320,11 @@ void TorrentCreator::run()
         {
             .torrentFilePath = result.value(),
             .savePath = parentPath,
-            .pieceSize = newTorrent.piece_length()
+            .pieceSize = newTorrent.piece_length(),
+#ifdef QBT_USES_LIBTORRENT2
+            .hashCacheHits = hashCacheStats.hits,
+            .hashCacheMisses = hashCacheStats.misses
+#endif
         };
 
         emit progressUpdated(100);
@@ -241,6 +340,169 @@ void TorrentCreator::run()
     }
 }
 
+#ifdef QBT_USES_LIBTORRENT2
+TorrentCreator::HashCacheStats TorrentCreator::setPieceHashesUsingCache(lt::create_torrent &newTorrent
+        , const Path &parentPath, const lt::settings_pack &settingsPack)
+{
+    const lt::file_storage &fs = newTorrent.files();
+    const int pieceSize = newTorrent.piece_length();
+    const int totalPieces = newTorrent.num_pieces();
+    const bool hasV1Hashes = (m_params.torrentFormat == TorrentFormat::Hybrid);
+
+    TorrentCreatorHashCache hashCache {hashCacheFilePath(m_params.sourcePath, pieceSize, m_params.torrentFormat)};
+    hashCache.load();
+
+    HashCacheStats stats;
+    int hashedPieces = 0;
+
+    const auto applyHashes = [&](const lt::file_index_t fileIndex, const TorrentCreatorHashCache::Entry &entry) -> bool
+    {
+        const qint64 fileSize = fs.file_size(fileIndex);
+        const int numPieces = filePieceCount(fs, fileIndex, pieceSize);
+        const int numFullPieces = static_cast<int>(fileSize / pieceSize);
+        const bool hasTail = (numFullPieces < numPieces);
+        if (entry.v2Hashes.size() != (numPieces * SHA256_HASH_SIZE))
+            return false;
+
+        QByteArray v1TailHash;
+        if (hasV1Hashes)
+        {
+            if (entry.v1Hashes.size() != (numFullPieces * SHA1_HASH_SIZE))
+                return false;
+
+            if (hasTail)
+            {
+                const bool isTailPadded = isFollowedByPadFile(fs, fileIndex);
+                if ((entry.v1TailHash.size() == SHA1_HASH_SIZE) && (entry.isV1TailPadded == isTailPadded))
+                {
+                    v1TailHash = entry.v1TailHash;
+                }
+                else
+                {
+                    const std::optional<QByteArray> tailHash = calculateV1TailHash((parentPath / Path(fs.file_path(fileIndex)))
+                            , fileSize, pieceSize, isTailPadded);
+                    if (!tailHash)
+                        return false;
+
+                    v1TailHash = *tailHash;
+                }
+            }
+        }
+
+        for (int i = 0; i < numPieces; ++i)
+        {
+            newTorrent.set_hash2(fileIndex, lt::piece_index_t::diff_type(i)
+                    , lt::sha256_hash(entry.v2Hashes.constData() + (i * SHA256_HASH_SIZE)));
+        }
+
+        if (hasV1Hashes)
+        {
+            const int firstPiece = static_cast<int>(fs.file_offset(fileIndex) / pieceSize);
+            for (int i = 0; i < numFullPieces; ++i)
+                newTorrent.set_hash(lt::piece_index_t(firstPiece + i), lt::sha1_hash(entry.v1Hashes.constData() + (i * SHA1_HASH_SIZE)));
+            if (hasTail)
+                newTorrent.set_hash(lt::piece_index_t(firstPiece + numFullPieces), lt::sha1_hash(v1TailHash.constData()));
+        }
+
+        return true;
+    };
+
+    // Files that aren't found in the cache are hashed as a separate torrent
+    // having the same layout, so their hashes match the ones of the resulting torrent
+    lt::file_storage missedFiles;
+    QHash<Path, lt::file_index_t> missedFileIndexes;
+    QHash<Path, FileFingerprint> missedFileFingerprints;
+
+    for (const lt::file_index_t fileIndex : fs.file_range())
+    {
+        if (fs.pad_file_at(fileIndex) || (fs.file_size(fileIndex) == 0))
+            continue;
+
+        const Path filePath {fs.file_path(fileIndex)};
+        const FileFingerprint fingerprint = FileFingerprint::fromFile(parentPath / filePath);
+        if (const std::optional<TorrentCreatorHashCache::Entry> entry = hashCache.find(filePath, fingerprint)
+                ; entry && applyHashes(fileIndex, *entry))
+        {
+            ++stats.hits;
+            hashedPieces += filePieceCount(fs, fileIndex, pieceSize);
+            hashCache.insert(filePath, *entry);
+        }
+        else
+        {
+            ++stats.misses;
+            missedFiles.add_file(fs.file_path(fileIndex), fs.file_size(fileIndex));
+            missedFileIndexes.insert(filePath, fileIndex);
+            missedFileFingerprints.insert(filePath, fingerprint);
+        }
+    }
+
+    sendProgressSignal(hashedPieces, totalPieces);
+    checkInterruptionRequested();
+
+    if (missedFiles.num_files() > 0)
+    {
+        lt::create_torrent missedTorrent {missedFiles, pieceSize, toNativeTorrentFormatFlag(m_params.torrentFormat)};
+
+        lt::error_code ec;
+        lt::set_piece_hashes(missedTorrent, parentPath.toString().toStdString(), settingsPack
+            , [this, totalPieces, &hashedPieces]([[maybe_unused]] const lt::piece_index_t n)
+        {
+            checkInterruptionRequested();
+            hashedPieces = std::min((hashedPieces + 1), totalPieces);
+            sendProgressSignal(hashedPieces, totalPieces);
+        }, ec);
+        if (ec)
+            throw RuntimeError(QString::fromLocal8Bit(ec.message().c_str()));
+
+        std::vector<char> missedTorrentData;
+        lt::bencode(std::back_inserter(missedTorrentData), missedTorrent.generate());
+        const lt::torrent_info missedTorrentInfo {missedTorrentData, lt::from_span};
+        const lt::file_storage &missedTorrentFiles = missedTorrentInfo.files();
+
+        for (const lt::file_index_t fileIndex : missedTorrentFiles.file_range())
+        {
+            if (missedTorrentFiles.pad_file_at(fileIndex) || (missedTorrentFiles.file_size(fileIndex) == 0))
+                continue;
+
+            const Path filePath {missedTorrentFiles.file_path(fileIndex)};
+            const qint64 fileSize = missedTorrentFiles.file_size(fileIndex);
+            const int numFullPieces = static_cast<int>(fileSize / pieceSize);
+
+            TorrentCreatorHashCache::Entry entry {.fingerprint = missedFileFingerprints.value(filePath)};
+
+            const lt::span<const char> pieceLayer = missedTorrentInfo.piece_layer(fileIndex);
+            if (pieceLayer.empty())
+                entry.v2Hashes = toByteArray(missedTorrentFiles.root(fileIndex));
+            else
+                entry.v2Hashes = QByteArray(pieceLayer.data(), static_cast<qsizetype>(pieceLayer.size()));
+
+            if (hasV1Hashes)
+            {
+                const int firstPiece = static_cast<int>(missedTorrentFiles.file_offset(fileIndex) / pieceSize);
+                for (int i = 0; i < numFullPieces; ++i)
+                    entry.v1Hashes += toByteArray(missedTorrentInfo.hash_for_piece(lt::piece_index_t(firstPiece + i)));
+                if ((fileSize % pieceSize) != 0)
+                {
+                    entry.v1TailHash = toByteArray(missedTorrentInfo.hash_for_piece(lt::piece_index_t(firstPiece + numFullPieces)));
+                    entry.isV1TailPadded = isFollowedByPadFile(missedTorrentFiles, fileIndex);
+                }
+            }
+
+            if (!applyHashes(missedFileIndexes.value(filePath), entry))
+                throw RuntimeError(tr("Failed to calculate hashes of file \"%1\"").arg(filePath.toString()));
+
+            if (entry.fingerprint.isValid())
+                hashCache.insert(filePath, entry);
+        }
+    }
+
+    if (const nonstd::expected<void, QString> result = hashCache.save(); !result)
+        LogMsg(tr("Failed to save torrent creator hash cache. Error: \"%1\"").arg(result.error()), Log::WARNING);
+
+    return stats;
+}
+#endif
+
 const TorrentCreatorParams &TorrentCreator::params() const
 {
     return m_params;
@@ -32,6 +32,8 @@
 
 #include <atomic>
 
+#include <libtorrent/fwd.hpp>
+
 #include <QObject>
 #include <QRunnable>
 #include <QStringList>
@@ -54,6 +56,7 @@ namespace BitTorrent
         bool isPrivate = false;
 #ifdef QBT_USES_LIBTORRENT2
         TorrentFormat torrentFormat = TorrentFormat::Hybrid;
+        bool isHashCacheEnabled = false;
 #else
         bool isAlignmentOptimized = false;
         int paddedFileSizeLimit = 0;
@@ -72,6 +75,9 @@ namespace BitTorrent
         Path torrentFilePath;
         Path savePath;
         int pieceSize;
+        // number of files whose hashes were reused from (or missing in) the hash cache
+        int hashCacheHits = 0;
+        int hashCacheMisses = 0;
     };
 
     class TorrentCreator final : public QObject, public QRunnable
@@ -106,6 +112,15 @@ namespace BitTorrent
     private:
         void sendProgressSignal(int currentPieceIdx, int totalPieces);
         void checkInterruptionRequested() const;
+#ifdef QBT_USES_LIBTORRENT2
+        struct HashCacheStats
+        {
+            int hits = 0;
+            int misses = 0;
+        };
+
+        HashCacheStats setPieceHashesUsingCache(lt::create_torrent &newTorrent, const Path &parentPath, const lt::settings_pack &settingsPack);
+#endif
 
         TorrentCreatorParams m_params;
         std::atomic_bool m_interruptionRequested;
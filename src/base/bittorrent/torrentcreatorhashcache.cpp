@@ -0,0 +1,139 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "torrentcreatorhashcache.h"
+
+#include <libtorrent/bdecode.hpp>
+#include <libtorrent/entry.hpp>
+
+#include "base/global.h"
+#include "base/preferences.h"
+#include "base/utils/fs.h"
+#include "base/utils/io.h"
+
+using namespace BitTorrent;
+
+namespace
+{
+    const qint64 CACHE_FILE_MAX_SIZE = 512 * 1024 * 1024;
+
+    QByteArray toByteArray(const lt::string_view str)
+    {
+        return {str.data(), static_cast<qsizetype>(str.size())};
+    }
+}
+
+TorrentCreatorHashCache::TorrentCreatorHashCache(const Path &filePath)
+    : m_filePath {filePath}
+{
+}
+
+void TorrentCreatorHashCache::load()
+{
+    m_entries.clear();
+
+    if (!m_filePath.exists())
+        return;
+
+    const auto readResult = Utils::IO::readFile(m_filePath, CACHE_FILE_MAX_SIZE);
+    if (!readResult)
+        return;
+
+    const auto *pref = Preferences::instance();
+
+    lt::error_code ec;
+    const lt::bdecode_node root = lt::bdecode(readResult.value(), ec
+            , nullptr, pref->getBdecodeDepthLimit(), pref->getBdecodeTokenLimit());
+    if (ec || (root.type() != lt::bdecode_node::dict_t))
+        return;
+
+    const lt::bdecode_node filesNode = root.dict_find_dict("files");
+    for (int i = 0; i < filesNode.dict_size(); ++i)
+    {
+        const auto [filePath, entryNode] = filesNode.dict_at(i);
+        if (entryNode.type() != lt::bdecode_node::dict_t)
+            continue;
+
+        const Entry entry
+        {
+            .fingerprint = {.size = entryNode.dict_find_int_value("size", -1), .lastModified = entryNode.dict_find_int_value("mtime")},
+            .v2Hashes = toByteArray(entryNode.dict_find_string_value("v2 hashes")),
+            .v1Hashes = toByteArray(entryNode.dict_find_string_value("v1 hashes")),
+            .v1TailHash = toByteArray(entryNode.dict_find_string_value("v1 tail hash")),
+            .isV1TailPadded = (entryNode.dict_find_int_value("v1 tail padded") != 0)
+        };
+        if (entry.fingerprint.isValid())
+            m_entries.insert(Path(QString::fromStdString(std::string(filePath))), entry);
+    }
+}
+
+nonstd::expected<void, QString> TorrentCreatorHashCache::save() const
+{
+    lt::entry::dictionary_type filesDict;
+    for (auto it = m_newEntries.cbegin(); it != m_newEntries.cend(); ++it)
+    {
+        const Entry &entry = it.value();
+
+        lt::entry::dictionary_type entryDict;
+        entryDict["size"] = entry.fingerprint.size;
+        entryDict["mtime"] = entry.fingerprint.lastModified;
+        if (!entry.v2Hashes.isEmpty())
+            entryDict["v2 hashes"] = entry.v2Hashes.toStdString();
+        if (!entry.v1Hashes.isEmpty())
+            entryDict["v1 hashes"] = entry.v1Hashes.toStdString();
+        if (!entry.v1TailHash.isEmpty())
+        {
+            entryDict["v1 tail hash"] = entry.v1TailHash.toStdString();
+            entryDict["v1 tail padded"] = entry.isV1TailPadded ? 1 : 0;
+        }
+
+        filesDict[it.key().data().toStdString()] = std::move(entryDict);
+    }
+
+    lt::entry::dictionary_type root;
+    root["files"] = std::move(filesDict);
+
+    if (const Path dirPath = m_filePath.parentPath(); !dirPath.exists() && !Utils::Fs::mkpath(dirPath))
+        return nonstd::make_unexpected(u"Couldn't create directory \"%1\""_s.arg(dirPath.toString()));
+
+    return Utils::IO::saveToFile(m_filePath, lt::entry(std::move(root)));
+}
+
+std::optional<TorrentCreatorHashCache::Entry> TorrentCreatorHashCache::find(const Path &filePath, const FileFingerprint &fingerprint) const
+{
+    const auto it = m_entries.constFind(filePath);
+    if ((it == m_entries.cend()) || (it->fingerprint != fingerprint))
+        return std::nullopt;
+
+    return it.value();
+}
+
+void TorrentCreatorHashCache::insert(const Path &filePath, const Entry &entry)
+{
+    m_newEntries.insert(filePath, entry);
+}
@@ -0,0 +1,79 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <optional>
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+
+#include "base/3rdparty/expected.hpp"
+#include "base/path.h"
+#include "filefingerprint.h"
+
+namespace BitTorrent
+{
+    // Keeps piece hashes of the files of the content that torrents were created from,
+    // so unchanged files don't need to be hashed again when the torrent is re-created.
+    // Every cache file belongs to a single combination of source path, piece size and
+    // torrent format, so the entries only need to be matched by file path and fingerprint.
+    class TorrentCreatorHashCache
+    {
+    public:
+        struct Entry
+        {
+            FileFingerprint fingerprint;
+            // concatenated SHA-256 hashes of the file piece layer (or the file merkle root
+            // if the file is not larger than a piece)
+            QByteArray v2Hashes;
+            // concatenated SHA-1 hashes of the file pieces that are completely filled by its data
+            QByteArray v1Hashes;
+            // SHA-1 hash of the last partial file piece, it depends on whether the piece is padded
+            QByteArray v1TailHash;
+            bool isV1TailPadded = false;
+        };
+
+        explicit TorrentCreatorHashCache(const Path &filePath);
+
+        void load();
+        nonstd::expected<void, QString> save() const;
+
+        std::optional<Entry> find(const Path &filePath, const FileFingerprint &fingerprint) const;
+        void insert(const Path &filePath, const Entry &entry);
+
+    private:
+        Path m_filePath;
+        // entries loaded from the cache file
+        QHash<Path, Entry> m_entries;
+        // entries of the files of the torrent being created, only these are saved
+        // so the cache doesn't grow with the files that no longer exist
+        QHash<Path, Entry> m_newEntries;
+    };
+}
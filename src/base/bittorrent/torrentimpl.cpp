@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <utility>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -311,6 +312,7 @@ TorrentImpl::TorrentImpl(SessionImpl *session, lt::session *nativeSession
     , m_useAutoTMM(params.useAutoTMM)
     , m_isStopped(params.stopped)
     , m_sslParams(params.sslParameters)
+    , m_fileFingerprints(params.fileFingerprints)
     , m_ltAddTorrentParams(params.ltAddTorrentParams)
     , m_downloadLimit(cleanLimitValue(m_ltAddTorrentParams.download_limit))
     , m_uploadLimit(cleanLimitValue(m_ltAddTorrentParams.upload_limit))
@@ -321,32 +323,11 @@ TorrentImpl::TorrentImpl(SessionImpl *session, lt::session *nativeSession
         // Otherwise it should be initialized in "Metadata received" handler.
         m_torrentInfo = TorrentInfo(*m_ltAddTorrentParams.ti);
 
-        Q_ASSERT(m_filePaths.isEmpty());
-        Q_ASSERT(m_indexMap.isEmpty());
-        const int filesCount = m_torrentInfo.filesCount();
-        m_filePaths.reserve(filesCount);
-        m_indexMap.reserve(filesCount);
-        m_filePriorities.reserve(filesCount);
-        const std::vector<lt::download_priority_t> filePriorities =
-                resized(m_ltAddTorrentParams.file_priorities, m_ltAddTorrentParams.ti->num_files()
-                        , LT::toNative(m_ltAddTorrentParams.file_priorities.empty() ? DownloadPriority::Normal : DownloadPriority::Ignored));
-
-        m_completedFiles.fill(static_cast<bool>(m_ltAddTorrentParams.flags & lt::torrent_flags::seed_mode), filesCount);
-        m_filesProgress.resize(filesCount);
-
-        for (int i = 0; i < filesCount; ++i)
-        {
-            const lt::file_index_t nativeIndex = m_torrentInfo.nativeIndexes().at(i);
-            m_indexMap[nativeIndex] = i;
-
-            const auto fileIter = m_ltAddTorrentParams.renamed_files.find(nativeIndex);
-            const Path filePath = ((fileIter != m_ltAddTorrentParams.renamed_files.end())
-                    ? makeUserPath(Path(fileIter->second)) : m_torrentInfo.filePath(i));
-            m_filePaths.append(filePath);
-
-            const auto priority = LT::fromNative(filePriorities[LT::toUnderlyingType(nativeIndex)]);
-            m_filePriorities.append(priority);
-        }
+        // Per-file state of restored torrents is loaded later (on first access or in the background)
+        // so that the session can become responsive without processing every file of every torrent.
+        m_isFilesStateLoaded = m_session->isRestored();
+        if (m_isFilesStateLoaded)
+            initializeFilesState();
     }
 
     setStopCondition(params.stopCondition);
@@ -360,15 +341,71 @@ TorrentImpl::TorrentImpl(SessionImpl *session, lt::session *nativeSession
         m_urlSeeds.append(QString::fromStdString(urlSeed));
     m_nativeStatus = extensionData->status;
 
-    if (hasMetadata())
+    if (hasMetadata() && m_isFilesStateLoaded)
         updateProgress();
 
     updateState();
 
-    if (hasMetadata())
+    if (hasMetadata() && m_isFilesStateLoaded)
         applyFirstLastPiecePriority(m_hasFirstLastPiecePriority);
 }
 
+bool TorrentImpl::isFilesStateLoaded() const
+{
+    return m_isFilesStateLoaded;
+}
+
+void TorrentImpl::loadFilesState()
+{
+    if (m_isFilesStateLoaded)
+        return;
+
+    m_isFilesStateLoaded = true;
+    if (!hasMetadata())
+        return;
+
+    initializeFilesState();
+    updateProgress();
+    applyFirstLastPiecePriority(m_hasFirstLastPiecePriority);
+}
+
+void TorrentImpl::ensureFilesStateLoaded() const
+{
+    if (!m_isFilesStateLoaded) [[unlikely]]
+        const_cast<TorrentImpl *>(this)->loadFilesState();
+}
+
+void TorrentImpl::initializeFilesState()
+{
+    Q_ASSERT(m_filePaths.isEmpty());
+    Q_ASSERT(m_indexMap.isEmpty());
+    m_relativeRootPath.reset();
+    const int filesCount = m_torrentInfo.filesCount();
+    m_filePaths.reserve(filesCount);
+    m_indexMap.reserve(filesCount);
+    m_filePriorities.reserve(filesCount);
+    const std::vector<lt::download_priority_t> filePriorities =
+            resized(m_ltAddTorrentParams.file_priorities, m_ltAddTorrentParams.ti->num_files()
+                    , LT::toNative(m_ltAddTorrentParams.file_priorities.empty() ? DownloadPriority::Normal : DownloadPriority::Ignored));
+
+    m_completedFiles.fill(static_cast<bool>(m_ltAddTorrentParams.flags & lt::torrent_flags::seed_mode), filesCount);
+    m_filesProgress.resize(filesCount);
+
+    for (int i = 0; i < filesCount; ++i)
+    {
+        const lt::file_index_t nativeIndex = m_torrentInfo.nativeIndexes().at(i);
+        m_indexMap[nativeIndex] = i;
+
+        const auto fileIter = m_ltAddTorrentParams.renamed_files.find(nativeIndex);
+        const Path filePath = ((fileIter != m_ltAddTorrentParams.renamed_files.end())
+                ? makeUserPath(Path(fileIter->second)) : m_torrentInfo.filePath(i));
+        m_filePaths.append(filePath);
+
+        const auto priority = LT::fromNative(filePriorities[LT::toUnderlyingType(nativeIndex)]);
+        m_filePriorities.append(priority);
+    }
+}
+
 TorrentImpl::~TorrentImpl() = default;
 
 bool TorrentImpl::isValid() const
@@ -526,7 +563,7 @@ Path TorrentImpl::rootPath() const
     if (!hasMetadata())
         return {};
 
-    const Path relativeRootPath = Path::findRootFolder(filePaths());
+    const Path &relativeRootPath = cachedValue(m_relativeRootPath, [this] { return Path::findRootFolder(filePaths()); });
     if (relativeRootPath.isEmpty())
         return {};
 
@@ -586,6 +623,8 @@ void TorrentImpl::setAutoManaged(const bool enable)
 
 Path TorrentImpl::makeActualPath(int index, const Path &path) const
 {
+    ensureFilesStateLoaded();
+
     Path actualPath = path;
 
     if (m_session->isAppendExtensionEnabled()
@@ -647,6 +686,7 @@ void TorrentImpl::addTrackers(QList<TrackerEntry> trackers)
     std::sort(m_trackerEntryStatuses.begin(), m_trackerEntryStatuses.end()
         , [](const TrackerEntryStatus &left, const TrackerEntryStatus &right) { return left.tier < right.tier; });
 
+    m_magnetURI.reset();
     deferredRequestResumeData();
     m_session->handleTorrentTrackersAdded(this, trackers);
 }
@@ -668,6 +708,7 @@ void TorrentImpl::removeTrackers(const QStringList &trackers)
     if (!removedTrackers.isEmpty())
     {
         m_nativeHandle.replace_trackers(nativeTrackers);
+        m_magnetURI.reset();
 
         deferredRequestResumeData();
         m_session->handleTorrentTrackersRemoved(this, removedTrackers);
@@ -695,6 +736,7 @@ void TorrentImpl::replaceTrackers(QList<TrackerEntry> trackers)
     }
 
     m_nativeHandle.replace_trackers(nativeTrackers);
+    m_magnetURI.reset();
 
     // Clear the peer list if it's a private torrent since
     // we do not want to keep connecting with peers from old tracker.
@@ -743,6 +785,7 @@ void TorrentImpl::addUrlSeeds(const QList<QUrl> &urlSeeds)
                     return;
 
                 thisTorrent->m_urlSeeds = currentSeeds;
+                thisTorrent->m_magnetURI.reset();
                 if (!addedUrlSeeds.isEmpty())
                 {
                     thisTorrent->deferredRequestResumeData();
@@ -786,6 +829,7 @@ void TorrentImpl::removeUrlSeeds(const QList<QUrl> &urlSeeds)
                     return;
 
                 thisTorrent->m_urlSeeds = currentSeeds;
+                thisTorrent->m_magnetURI.reset();
 
                 if (!removedUrlSeeds.isEmpty())
                 {
@@ -972,6 +1016,8 @@ int TorrentImpl::inactiveSeedingTimeLimit() const
 
 Path TorrentImpl::filePath(const int index) const
 {
+    ensureFilesStateLoaded();
+
     Q_ASSERT(index >= 0);
     Q_ASSERT(index < m_filePaths.size());
 
@@ -997,6 +1043,7 @@ qlonglong TorrentImpl::fileSize(const int index) const
 
 PathList TorrentImpl::filePaths() const
 {
+    ensureFilesStateLoaded();
     return m_filePaths;
 }
 
@@ -1017,6 +1064,7 @@ PathList TorrentImpl::actualFilePaths() const
 
 QList<DownloadPriority> TorrentImpl::filePriorities() const
 {
+    ensureFilesStateLoaded();
     return m_filePriorities;
 }
 
@@ -1336,6 +1384,8 @@ QList<qreal> TorrentImpl::filesProgress() const
     if (!hasMetadata())
         return {};
 
+    ensureFilesStateLoaded();
+
     const int count = m_filesProgress.size();
     Q_ASSERT(count == filesCount());
     if (count != filesCount()) [[unlikely]]
@@ -1475,6 +1525,7 @@ QList<PeerInfo> TorrentImpl::peers() const
 
 QBitArray TorrentImpl::pieces() const
 {
+    ensureFilesStateLoaded();
     return m_pieces;
 }
 
@@ -1641,7 +1692,19 @@ void TorrentImpl::forceRecheck()
     if (!hasMetadata())
         return;
 
+#ifdef QBT_USES_LIBTORRENT2
+    // the recheck is started once the unchanged files are found
+    if (m_session->isFastRecheckEnabled() && prepareFastRecheck())
+        return;
+#endif
+
+    startRecheck();
+}
+
+void TorrentImpl::startRecheck()
+{
     m_nativeHandle.force_recheck();
+    m_isRecheckRequested = true;
     // We have to force update the cached state, otherwise someone will be able to get
     // an incorrect one during the interval until the cached state is updated in a regular way.
     m_nativeStatus.state = lt::torrent_status::checking_resume_data;
@@ -1659,6 +1722,7 @@ void TorrentImpl::forceRecheck()
 
     m_unchecked = false;
 
+    ensureFilesStateLoaded();
     m_completedFiles.fill(false);
     m_filesProgress.fill(0);
     m_pieces.fill(false);
@@ -1708,6 +1772,8 @@ void TorrentImpl::applyFirstLastPiecePriority(const bool enabled)
 {
     Q_ASSERT(hasMetadata());
 
+    ensureFilesStateLoaded();
+
     // Download first and last pieces first for every file in the torrent
 
     auto piecePriorities = std::vector<lt::download_priority_t>(m_torrentInfo.piecesCount(), LT::toNative(DownloadPriority::Ignored));
@@ -1802,6 +1868,7 @@ void TorrentImpl::endReceivedMetadataHandling(const Path &savePath, const PathLi
     Q_ASSERT(m_filePaths.isEmpty());
     if (!m_filePaths.isEmpty()) [[unlikely]]
         m_filePaths.clear();
+    m_relativeRootPath.reset();
 
     lt::add_torrent_params &p = m_ltAddTorrentParams;
 
@@ -1862,6 +1929,8 @@ void TorrentImpl::endReceivedMetadataHandling(const Path &savePath, const PathLi
 
 void TorrentImpl::reload()
 {
+    ensureFilesStateLoaded();
+
     try
     {
         m_completedFiles.fill(false);
@@ -2059,10 +2128,16 @@ void TorrentImpl::handleTorrentCheckedAlert([[maybe_unused]] const lt::torrent_c
         return;
     }
 
+    m_session->clearFastRecheckPieces(this);
+
+    // Only the forced recheck verifies the data. The files that are only checked
+    // against the resume data may have been changed, so their fingerprints aren't updated.
+    const bool isDataVerified = std::exchange(m_isRecheckRequested, false);
+
     if (stopCondition() == StopCondition::FilesChecked)
         stop();
 
-    m_statusUpdatedTriggers.enqueue([this]()
+    m_statusUpdatedTriggers.enqueue([this, isDataVerified]()
     {
         qDebug("\"%s\" have just finished checking.", qUtf8Printable(name()));
 
@@ -2073,6 +2148,9 @@ void TorrentImpl::handleTorrentCheckedAlert([[maybe_unused]] const lt::torrent_c
             else if (progress() == 1.0)
                 m_hasFinishedStatus = true;
 
+            if (isDataVerified)
+                updateFileFingerprints();
+
             adjustStorageLocation();
             manageActualFilePaths();
 
@@ -2138,7 +2216,11 @@ void TorrentImpl::handleSaveResumeDataAlert(const lt::save_resume_data_alert *p)
         // URL seed list have been changed by libtorrent for some reason, so we need to update cached one.
         // Unfortunately, URL seed list containing in "resume data" is generated according to different rules
         // than the list we usually cache, so we have to request it from the appropriate source.
-        fetchURLSeeds([this](const QList<QUrl> &urlSeeds) { m_urlSeeds = urlSeeds; });
+        fetchURLSeeds([this](const QList<QUrl> &urlSeeds)
+        {
+            m_urlSeeds = urlSeeds;
+            m_magnetURI.reset();
+        });
     }
 
     if ((m_maintenanceJob == MaintenanceJob::HandleMetadata) && p->params.ti)
@@ -2194,6 +2276,9 @@ void TorrentImpl::handleSaveResumeDataAlert(const lt::save_resume_data_alert *p)
 
 void TorrentImpl::prepareResumeData(const lt::add_torrent_params &params)
 {
+    // Deferred files state is initialized from the original resume data that is going to be replaced
+    loadFilesState();
+
     if (m_hasMissingFiles)
     {
         const auto havePieces = m_ltAddTorrentParams.have_pieces;
@@ -2238,12 +2323,102 @@ void TorrentImpl::prepareResumeData(const lt::add_torrent_params &params)
         .seedingTimeLimit = m_seedingTimeLimit,
         .inactiveSeedingTimeLimit = m_inactiveSeedingTimeLimit,
         .shareLimitAction = m_shareLimitAction,
-        .sslParameters = m_sslParams
+        .sslParameters = m_sslParams,
+        .fileFingerprints = m_fileFingerprints
     };
 
     m_session->handleTorrentResumeDataReady(this, resumeData);
 }
 
+void TorrentImpl::updateFileFingerprints()
+{
+    ensureFilesStateLoaded();
+
+    const Path storageLocation = actualStorageLocation();
+    const int filesCount = this->filesCount();
+    PathList filePaths;
+    filePaths.reserve(filesCount);
+    for (int i = 0; i < filesCount; ++i)
+        filePaths.append(m_completedFiles.at(i) ? (storageLocation / actualFilePath(i)) : Path());
+
+    invokeAsync([filePaths]
+    {
+        QList<FileFingerprint> fileFingerprints;
+        fileFingerprints.reserve(filePaths.size());
+        for (const Path &filePath : filePaths)
+            fileFingerprints.append(filePath.isEmpty() ? FileFingerprint() : FileFingerprint::fromFile(filePath));
+        return fileFingerprints;
+    }
+    , [this](const QList<FileFingerprint> &fileFingerprints)
+    {
+        if ((fileFingerprints.size() != filesCount()) || (fileFingerprints == m_fileFingerprints))
+            return;
+
+        m_fileFingerprints = fileFingerprints;
+        deferredRequestResumeData();
+    });
+}
+
+bool TorrentImpl::prepareFastRecheck()
+{
+    // Only v1 piece hashes can be provided without reading the data
+    if (!infoHash().v1().isValid() || infoHash().v2().isValid())
+        return false;
+
+    if (m_isFastRecheckPending)
+        return true;
+
+    ensureFilesStateLoaded();
+
+    const int filesCount = this->filesCount();
+    if ((m_fileFingerprints.size() != filesCount) || (m_pieces.size() != piecesCount()))
+        return false;
+
+    const Path storageLocation = actualStorageLocation();
+    PathList filePaths;
+    filePaths.reserve(filesCount);
+    for (int i = 0; i < filesCount; ++i)
+        filePaths.append(storageLocation / actualFilePath(i));
+
+    m_isFastRecheckPending = true;
+    invokeAsync([filePaths, fileFingerprints = m_fileFingerprints, pieces = m_pieces, torrentInfo = m_torrentInfo]
+    {
+        // Pieces that were verified before are considered intact unless they belong
+        // to the file that was changed since it was verified (or was never verified)
+        QBitArray unchangedPieces = pieces;
+        for (int i = 0; i < filePaths.size(); ++i)
+        {
+            const FileFingerprint &fingerprint = fileFingerprints.at(i);
+            if (fingerprint.isValid() && (fingerprint == FileFingerprint::fromFile(filePaths.at(i))))
+                continue;
+
+            const TorrentInfo::PieceRange filePieces = torrentInfo.filePieces(i);
+            if (!filePieces.isEmpty())
+                unchangedPieces.fill(false, filePieces.first(), (filePieces.last() + 1));
+        }
+
+        return unchangedPieces;
+    }
+    , [this](const QBitArray &unchangedPieces)
+    {
+        m_isFastRecheckPending = false;
+        if (!hasMetadata())
+            return;
+
+        if (const qsizetype unchangedPiecesCount = unchangedPieces.count(true); unchangedPiecesCount > 0)
+        {
+            // The pieces are used only by the check started right after this
+            m_session->setFastRecheckPieces(this, unchangedPieces);
+            LogMsg(tr("Rechecking torrent, unchanged pieces are skipped. Torrent: \"%1\". Skipped pieces: %2 of %3")
+                    .arg(name(), QString::number(unchangedPiecesCount), QString::number(piecesCount())));
+        }
+
+        startRecheck();
+    });
+
+    return true;
+}
+
 void TorrentImpl::handleSaveResumeDataFailedAlert(const lt::save_resume_data_failed_alert *p)
 {
     if (p->error != lt::errors::resume_data_not_modified)
@@ -2263,6 +2438,8 @@ void TorrentImpl::handleFastResumeRejectedAlert(const lt::fastresume_rejected_al
 
 void TorrentImpl::handleFileRenamedAlert(const lt::file_renamed_alert *p)
 {
+    ensureFilesStateLoaded();
+
     const int fileIndex = m_indexMap.value(p->index, -1);
     Q_ASSERT(fileIndex >= 0);
 
@@ -2311,6 +2488,7 @@ void TorrentImpl::handleFileRenamedAlert(const lt::file_renamed_alert *p)
     else
     {
         m_filePaths[fileIndex] = newFilePath;
+        m_relativeRootPath.reset();
 
         // Remove empty leftover folders
         // For example renaming "a/b/c" to "d/b/c", then folders "a/b" and "a" will
@@ -2333,6 +2511,8 @@ void TorrentImpl::handleFileRenamedAlert(const lt::file_renamed_alert *p)
 
 void TorrentImpl::handleFileRenameFailedAlert(const lt::file_rename_failed_alert *p)
 {
+    ensureFilesStateLoaded();
+
     const int fileIndex = m_indexMap.value(p->index, -1);
     Q_ASSERT(fileIndex >= 0);
 
@@ -2351,6 +2531,8 @@ void TorrentImpl::handleFileCompletedAlert(const lt::file_completed_alert *p)
     if (m_maintenanceJob == MaintenanceJob::HandleMetadata)
         return;
 
+    ensureFilesStateLoaded();
+
     const int fileIndex = m_indexMap.value(p->index, -1);
     Q_ASSERT(fileIndex >= 0);
 
@@ -2358,6 +2540,9 @@ void TorrentImpl::handleFileCompletedAlert(const lt::file_completed_alert *p)
 
     const Path actualPath = actualFilePath(fileIndex);
 
+    m_fileFingerprints.resize(filesCount());
+    m_fileFingerprints[fileIndex] = FileFingerprint::fromFile(actualStorageLocation() / actualPath);
+
 #if defined(Q_OS_MACOS) || defined(Q_OS_WIN)
     // only apply Mark-of-the-Web to new download files
     if (Preferences::instance()->isMarkOfTheWebEnabled() && isDownloading())
@@ -2397,6 +2582,7 @@ void TorrentImpl::handleMetadataReceivedAlert([[maybe_unused]] const lt::metadat
 #ifdef QBT_USES_LIBTORRENT2
     const InfoHash prevInfoHash = infoHash();
     m_infoHash = InfoHash(m_nativeHandle.info_hashes());
+    m_magnetURI.reset();
     if (prevInfoHash != infoHash())
         m_session->handleTorrentInfoHashChanged(this, prevInfoHash);
 #endif
@@ -2608,7 +2794,7 @@ void TorrentImpl::updateStatus(const lt::torrent_status &nativeStatus)
 {
     const lt::torrent_status oldStatus = std::exchange(m_nativeStatus, nativeStatus);
 
-    if (m_nativeStatus.num_pieces != oldStatus.num_pieces)
+    if (m_isFilesStateLoaded && (m_nativeStatus.num_pieces != oldStatus.num_pieces))
         updateProgress();
 
     updateState();
@@ -2808,6 +2994,18 @@ void TorrentImpl::flushCache() const
 }
 
 QString TorrentImpl::createMagnetURI() const
+{
+    // name of torrent without metadata can be changed by status updates, so it is checked on each call
+    if (const QString displayName = name(); displayName != m_magnetURIDisplayName)
+    {
+        m_magnetURIDisplayName = displayName;
+        m_magnetURI.reset();
+    }
+
+    return cachedValue(m_magnetURI, [this] { return makeMagnetURI(); });
+}
+
+QString TorrentImpl::makeMagnetURI() const
 {
     QString ret = u"magnet:?"_s;
 
@@ -3086,6 +3284,17 @@ QList<qreal> TorrentImpl::availableFileFractions() const
     return res;
 }
 
+template <typename T, typename Func>
+const T &TorrentImpl::cachedValue(std::optional<T> &cache, Func computeValue) const
+{
+    const bool isCached = cache.has_value();
+    m_session->handleTorrentCachedValueLookup(isCached);
+    if (!isCached)
+        cache = computeValue();
+
+    return *cache;
+}
+
 template <typename Func, typename Callback>
 void TorrentImpl::invokeAsync(Func func, Callback resultHandler) const
 {
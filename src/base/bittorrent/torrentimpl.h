@@ -31,6 +31,7 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
 
 #include <libtorrent/add_torrent_params.hpp>
 #include <libtorrent/fwd.hpp>
@@ -49,6 +50,7 @@
 
 #include "base/path.h"
 #include "base/tagset.h"
+#include "filefingerprint.h"
 #include "infohash.h"
 #include "speedmonitor.h"
 #include "sslparameters.h"
@@ -265,6 +267,9 @@ namespace BitTorrent
 
         bool needSaveResumeData() const;
 
+        bool isFilesStateLoaded() const;
+        void loadFilesState();
+
         // Session interface
         lt::torrent_handle nativeHandle() const;
 
@@ -286,6 +291,9 @@ namespace BitTorrent
 
         std::shared_ptr<const lt::torrent_info> nativeTorrentInfo() const;
 
+        void initializeFilesState();
+        void ensureFilesStateLoaded() const;
+
         void updateStatus(const lt::torrent_status &nativeStatus);
         void updateProgress();
         void updateState();
@@ -320,6 +328,9 @@ namespace BitTorrent
         void applyFirstLastPiecePriority(bool enabled);
 
         void prepareResumeData(const lt::add_torrent_params &params);
+        void updateFileFingerprints();
+        bool prepareFastRecheck();
+        void startRecheck();
         void endReceivedMetadataHandling(const Path &savePath, const PathList &fileNames);
         void reload();
 
@@ -328,6 +339,11 @@ namespace BitTorrent
         template <typename Func, typename Callback>
         void invokeAsync(Func func, Callback resultHandler) const;
 
+        QString makeMagnetURI() const;
+
+        template <typename T, typename Func>
+        const T &cachedValue(std::optional<T> &cache, Func computeValue) const;
+
         SessionImpl *const m_session = nullptr;
         lt::session *m_nativeSession = nullptr;
         lt::torrent_handle m_nativeHandle;
@@ -338,6 +354,7 @@ namespace BitTorrent
         QHash<lt::file_index_t, int> m_indexMap;
         QList<DownloadPriority> m_filePriorities;
         QBitArray m_completedFiles;
+        bool m_isFilesStateLoaded = true;
         SpeedMonitor m_payloadRateMonitor;
 
         InfoHash m_infoHash;
@@ -356,6 +373,12 @@ namespace BitTorrent
         QList<QUrl> m_urlSeeds;
         FileErrorInfo m_lastFileError;
 
+        // Values that are expensive to derive from the data above,
+        // they are reset wherever the data they are derived from is changed
+        mutable std::optional<QString> m_magnetURI;
+        mutable QString m_magnetURIDisplayName;
+        mutable std::optional<Path> m_relativeRootPath;
+
         // Persistent data
         QString m_name;
         Path m_savePath;
@@ -375,8 +398,13 @@ namespace BitTorrent
         bool m_isStopped = false;
         StopCondition m_stopCondition = StopCondition::None;
         SSLParameters m_sslParams;
+        // Fingerprints of the files at the moment they were verified
+        QList<FileFingerprint> m_fileFingerprints;
 
         bool m_unchecked = false;
+        bool m_isRecheckRequested = false;
+        // Files are being examined before the recheck which skips the unchanged ones
+        bool m_isFastRecheckPending = false;
 
         lt::add_torrent_params m_ltAddTorrentParams;
 
@@ -0,0 +1,382 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "torrentmetadatacache.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+
+#include "base/3rdparty/expected.hpp"
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/utils/fs.h"
+#include "torrentdescriptor.h"
+
+namespace
+{
+    const QString FILE_EXTENSION = u".torrent"_s;
+    const QChar ALT_ID_SEPARATOR = u'_';
+}
+
+namespace BitTorrent
+{
+    class TorrentMetadataCache::Worker final : public QObject
+    {
+        Q_DISABLE_COPY_MOVE(Worker)
+
+    public:
+        explicit Worker(const Path &path);
+
+        QList<Entry> listEntries() const;
+        nonstd::expected<TorrentInfo, QString> load(const Path &filePath) const;
+        nonstd::expected<qint64, QString> store(const TorrentInfo &torrentInfo, const Path &filePath) const;
+        void touch(const Path &filePath) const;
+        void remove(const Path &filePath) const;
+
+    private:
+        const Path m_path;
+    };
+}
+
+using namespace BitTorrent;
+
+TorrentMetadataCache::Worker::Worker(const Path &path)
+    : m_path {path}
+{
+}
+
+QList<TorrentMetadataCache::Entry> TorrentMetadataCache::Worker::listEntries() const
+{
+    const QFileInfoList files = QDir(m_path.data()).entryInfoList({u'*' + FILE_EXTENSION}, QDir::Files, QDir::Time | QDir::Reversed);
+
+    QList<Entry> entries;
+    entries.reserve(files.size());
+    for (const QFileInfo &fileInfo : files)
+    {
+        const QStringList ids = fileInfo.completeBaseName().split(ALT_ID_SEPARATOR);
+        const auto id = TorrentID::fromString(ids.value(0));
+        if (!id.isValid() || (ids.size() > 2))
+            continue;
+
+        const auto altID = ((ids.size() == 2) ? TorrentID::fromString(ids.at(1)) : TorrentID());
+        entries.append({.id = id, .altID = altID, .path = Path(fileInfo.filePath()), .size = fileInfo.size()});
+    }
+
+    return entries;
+}
+
+nonstd::expected<TorrentInfo, QString> TorrentMetadataCache::Worker::load(const Path &filePath) const
+{
+    const nonstd::expected<TorrentDescriptor, QString> loadResult = TorrentDescriptor::loadFromFile(filePath);
+    if (!loadResult)
+        return nonstd::make_unexpected(loadResult.error());
+    if (!loadResult.value().info())
+        return nonstd::make_unexpected(TorrentMetadataCache::tr("Invalid data format"));
+
+    return *loadResult.value().info();
+}
+
+nonstd::expected<qint64, QString> TorrentMetadataCache::Worker::store(const TorrentInfo &torrentInfo, const Path &filePath) const
+{
+    if (!m_path.exists() && !Utils::Fs::mkpath(m_path))
+        return nonstd::make_unexpected(TorrentMetadataCache::tr("Couldn't create torrent metadata cache directory. Path: \"%1\"").arg(m_path.toString()));
+
+    TorrentDescriptor torrentDescr;
+    torrentDescr.setTorrentInfo(torrentInfo);
+    if (const nonstd::expected<void, QString> result = torrentDescr.saveToFile(filePath); !result)
+        return nonstd::make_unexpected(result.error());
+
+    return QFileInfo(filePath.data()).size();
+}
+
+void TorrentMetadataCache::Worker::touch(const Path &filePath) const
+{
+    // Keep usage order across restarts by means of file modification time
+    QFile file {filePath.data()};
+    if (file.open(QIODevice::ReadWrite))
+        file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+}
+
+void TorrentMetadataCache::Worker::remove(const Path &filePath) const
+{
+    Utils::Fs::removeFile(filePath);
+}
+
+TorrentMetadataCache::TorrentMetadataCache(const Path &path, const qint64 maxSize, QObject *parent)
+    : QObject(parent)
+    , m_path {path}
+    , m_maxSize {maxSize}
+{
+    if (m_maxSize > 0)
+        startWorker();
+}
+
+qint64 TorrentMetadataCache::maxSize() const
+{
+    return m_maxSize;
+}
+
+void TorrentMetadataCache::setMaxSize(const qint64 value)
+{
+    if (value == m_maxSize)
+        return;
+
+    m_maxSize = value;
+    if (m_maxSize <= 0)
+        return;
+
+    if (!m_asyncWorker)
+        startWorker();
+    else
+        shrink();
+}
+
+qint64 TorrentMetadataCache::size() const
+{
+    return m_size;
+}
+
+qint64 TorrentMetadataCache::hits() const
+{
+    return m_hits;
+}
+
+qint64 TorrentMetadataCache::misses() const
+{
+    return m_misses;
+}
+
+bool TorrentMetadataCache::load(const InfoHash &infoHash)
+{
+    if ((m_maxSize <= 0) || !infoHash.isValid())
+        return false;
+
+    const Entry *entry = findEntry(TorrentID::fromInfoHash(infoHash));
+    if (!entry && infoHash.isHybrid())
+        entry = findEntry(TorrentID::fromSHA1Hash(infoHash.v1()));
+
+    if (!entry)
+    {
+        ++m_misses;
+        return false;
+    }
+
+    QMetaObject::invokeMethod(m_asyncWorker, [this, infoHash, id = entry->id, filePath = entry->path]
+    {
+        const nonstd::expected<TorrentInfo, QString> loadResult = m_asyncWorker->load(filePath);
+        QMetaObject::invokeMethod(this, [this, infoHash, id, filePath, loadResult]
+        {
+            handleLoadFinished(infoHash, id, filePath, loadResult.value_or(TorrentInfo()), (loadResult ? QString() : loadResult.error()));
+        });
+    });
+
+    return true;
+}
+
+void TorrentMetadataCache::store(const TorrentInfo &torrentInfo)
+{
+    if ((m_maxSize <= 0) || !torrentInfo.isValid())
+        return;
+
+    const InfoHash infoHash = torrentInfo.infoHash();
+    const auto id = TorrentID::fromInfoHash(infoHash);
+    const auto altID = (infoHash.isHybrid() ? TorrentID::fromSHA1Hash(infoHash.v1()) : TorrentID());
+    if (const Entry *entry = findEntry(id))
+    {
+        touch(entry->id);
+        return;
+    }
+
+    const QString fileName = (altID.isValid()
+            ? (id.toString() + ALT_ID_SEPARATOR + altID.toString()) : id.toString()) + FILE_EXTENSION;
+    const Path filePath = m_path / Path(fileName);
+
+    QMetaObject::invokeMethod(m_asyncWorker, [this, torrentInfo, id, altID, filePath]
+    {
+        const nonstd::expected<qint64, QString> result = m_asyncWorker->store(torrentInfo, filePath);
+        if (!result)
+        {
+            LogMsg(tr("Couldn't store torrent metadata in cache. File: \"%1\". Error: \"%2\"")
+                    .arg(filePath.toString(), result.error()), Log::WARNING);
+            return;
+        }
+
+        const Entry entry {.id = id, .altID = altID, .path = filePath, .size = result.value()};
+        QMetaObject::invokeMethod(this, [this, entry] { handleStoreFinished(entry); });
+    });
+}
+
+void TorrentMetadataCache::startWorker()
+{
+    m_ioThread.reset(new QThread);
+    m_asyncWorker = new Worker(m_path);
+    m_asyncWorker->moveToThread(m_ioThread.get());
+    connect(m_ioThread.get(), &QThread::finished, m_asyncWorker, &QObject::deleteLater);
+    m_ioThread->start();
+
+    QMetaObject::invokeMethod(m_asyncWorker, [this]
+    {
+        const QList<Entry> entries = m_asyncWorker->listEntries();
+        QMetaObject::invokeMethod(this, [this, entries] { handleEntriesListed(entries); });
+    });
+}
+
+void TorrentMetadataCache::handleEntriesListed(const QList<Entry> &entries)
+{
+    // The entries stored meanwhile are the most recently used ones,
+    // so they are added again after the listed ones
+    QList<Entry> listedEntries;
+    listedEntries.reserve(entries.size());
+    for (const Entry &entry : entries)
+    {
+        if (!findEntry(entry.id))
+            listedEntries.append(entry);
+    }
+
+    QList<Entry> storedEntries;
+    storedEntries.reserve(m_entries.size());
+    for (const auto &usage : m_usageOrder)
+        storedEntries.append(m_entries.value(usage.second));
+
+    m_entries.clear();
+    m_altIDs.clear();
+    m_usageOrder.clear();
+    m_size = 0;
+
+    m_entries.reserve(listedEntries.size() + storedEntries.size());
+    for (const Entry &entry : asConst(listedEntries))
+    {
+        if (!findEntry(entry.id))
+            addEntry(entry);
+    }
+
+    for (const Entry &entry : asConst(storedEntries))
+        addEntry(entry);
+
+    shrink();
+}
+
+void TorrentMetadataCache::handleLoadFinished(const InfoHash &infoHash, const TorrentID &id, const Path &path
+        , const TorrentInfo &metadata, const QString &errorMessage)
+{
+    // the entry could be removed meanwhile if the cache was shrunk
+    const Entry *entry = findEntry(id);
+    const bool isEntryValid = (entry && (entry->path == path));
+
+    if (!metadata.isValid())
+    {
+        if (isEntryValid)
+        {
+            LogMsg(tr("Failed to load cached torrent metadata. File: \"%1\". Error: \"%2\"")
+                    .arg(path.toString(), errorMessage), Log::WARNING);
+            remove(id);
+        }
+        ++m_misses;
+    }
+    else
+    {
+        if (isEntryValid)
+            touch(entry->id);
+        ++m_hits;
+    }
+
+    emit loadFinished(infoHash, metadata);
+}
+
+void TorrentMetadataCache::handleStoreFinished(const Entry &entry)
+{
+    if (findEntry(entry.id))
+        return;
+
+    addEntry(entry);
+    shrink();
+}
+
+const TorrentMetadataCache::Entry *TorrentMetadataCache::findEntry(const TorrentID &id) const
+{
+    if (const auto iter = m_entries.constFind(id); iter != m_entries.cend())
+        return &iter.value();
+
+    if (const auto altIDIter = m_altIDs.constFind(id); altIDIter != m_altIDs.cend())
+        return &m_entries.constFind(altIDIter.value()).value();
+
+    return nullptr;
+}
+
+void TorrentMetadataCache::addEntry(Entry entry)
+{
+    entry.lastUsage = ++m_usageCounter;
+    m_usageOrder.emplace(entry.lastUsage, entry.id);
+    if (entry.altID.isValid())
+        m_altIDs.insert(entry.altID, entry.id);
+    m_size += entry.size;
+    m_entries.insert(entry.id, entry);
+}
+
+void TorrentMetadataCache::touch(const TorrentID &id)
+{
+    Entry &entry = m_entries[id];
+    m_usageOrder.erase(entry.lastUsage);
+    entry.lastUsage = ++m_usageCounter;
+    m_usageOrder.emplace(entry.lastUsage, entry.id);
+
+    QMetaObject::invokeMethod(m_asyncWorker, [this, filePath = entry.path]
+    {
+        m_asyncWorker->touch(filePath);
+    });
+}
+
+void TorrentMetadataCache::remove(const TorrentID &id)
+{
+    const Entry entry = m_entries.take(id);
+    m_usageOrder.erase(entry.lastUsage);
+    if (entry.altID.isValid())
+        m_altIDs.remove(entry.altID);
+    m_size -= entry.size;
+
+    QMetaObject::invokeMethod(m_asyncWorker, [this, filePath = entry.path]
+    {
+        m_asyncWorker->remove(filePath);
+    });
+}
+
+void TorrentMetadataCache::shrink()
+{
+    // the files are kept while the cache is disabled
+    if (m_maxSize <= 0)
+        return;
+
+    while (!m_usageOrder.empty() && (m_size > m_maxSize))
+    {
+        const TorrentID id = m_usageOrder.begin()->second;
+        remove(id);
+    }
+}
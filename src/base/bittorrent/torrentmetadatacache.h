@@ -0,0 +1,110 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <map>
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+
+#include "base/path.h"
+#include "base/utils/thread.h"
+#include "infohash.h"
+#include "torrentinfo.h"
+
+namespace BitTorrent
+{
+    // Keeps metadata of torrents that were added by magnet links
+    // so it doesn't need to be downloaded again when the same torrent is added later.
+    // The index is kept in memory while the files are accessed in a separate thread.
+    // The files are neither listed nor removed while the cache is disabled (its max size is 0).
+    class TorrentMetadataCache final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(TorrentMetadataCache)
+
+    public:
+        TorrentMetadataCache(const Path &path, qint64 maxSize, QObject *parent = nullptr);
+
+        qint64 maxSize() const;
+        void setMaxSize(qint64 value);
+
+        qint64 size() const;
+        qint64 hits() const;
+        qint64 misses() const;
+
+        // Starts loading the cached metadata of the torrent. Returns false if there is no such metadata,
+        // otherwise loadFinished() is emitted when it is loaded (or failed to be loaded).
+        bool load(const InfoHash &infoHash);
+        void store(const TorrentInfo &torrentInfo);
+
+    signals:
+        // metadata is invalid if it couldn't be loaded
+        void loadFinished(const InfoHash &infoHash, const TorrentInfo &metadata);
+
+    private:
+        struct Entry
+        {
+            TorrentID id;
+            TorrentID altID;
+            Path path;
+            qint64 size = 0;
+            quint64 lastUsage = 0;
+        };
+
+        class Worker;
+
+        void startWorker();
+        void handleEntriesListed(const QList<Entry> &entries);
+        void handleLoadFinished(const InfoHash &infoHash, const TorrentID &id, const Path &path
+                , const TorrentInfo &metadata, const QString &errorMessage);
+        void handleStoreFinished(const Entry &entry);
+        const Entry *findEntry(const TorrentID &id) const;
+        void addEntry(Entry entry);
+        void touch(const TorrentID &id);
+        void remove(const TorrentID &id);
+        void shrink();
+
+        Path m_path;
+        qint64 m_maxSize = 0;
+        qint64 m_size = 0;
+        qint64 m_hits = 0;
+        qint64 m_misses = 0;
+        QHash<TorrentID, Entry> m_entries;
+        // IDs of the entries by their alternative IDs (v1 IDs of hybrid torrents)
+        QHash<TorrentID, TorrentID> m_altIDs;
+        // IDs of the entries ordered from least to most recently used
+        std::map<quint64, TorrentID> m_usageOrder;
+        quint64 m_usageCounter = 0;
+
+        Utils::Thread::UniquePtr m_ioThread;
+        Worker *m_asyncWorker = nullptr;
+    };
+}
@@ -69,6 +69,11 @@ public:
         return m_dataPtr->nativeDigest();
     }
 
+    const UnderlyingType &nativeDigest() const
+    {
+        return m_dataPtr->nativeDigest();
+    }
+
     QString toString() const
     {
         return m_dataPtr->hashString();
@@ -117,7 +122,7 @@ public:
     }
 
     bool isValid() const { return m_isValid; }
-    UnderlyingType nativeDigest() const { return m_nativeDigest; }
+    const UnderlyingType &nativeDigest() const { return m_nativeDigest; }
 
     QString hashString() const
     {
@@ -139,19 +144,19 @@ private:
 template <int N>
 bool operator==(const Digest32<N> &left, const Digest32<N> &right)
 {
-    return (static_cast<typename Digest32<N>::UnderlyingType>(left)
-            == static_cast<typename Digest32<N>::UnderlyingType>(right));
+    return (left.nativeDigest() == right.nativeDigest());
 }
 
 template <int N>
 bool operator<(const Digest32<N> &left, const Digest32<N> &right)
 {
-    return static_cast<typename Digest32<N>::UnderlyingType>(left)
-            < static_cast<typename Digest32<N>::UnderlyingType>(right);
+    return (left.nativeDigest() < right.nativeDigest());
 }
 
 template <int N>
 std::size_t qHash(const Digest32<N> &key, const std::size_t seed = 0)
 {
-    return ::qHash(static_cast<typename Digest32<N>::UnderlyingType>(key), seed);
+    // info hashes come from the clients, so all the bytes are mixed with the seed
+    // to keep the hash tables resistant to flooding with colliding keys
+    return qHashBits(key.nativeDigest().data(), Digest32<N>::length(), seed);
 }
@@ -30,20 +30,58 @@
 
 #include "connection.h"
 
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include <QFutureWatcher>
+#include <QPromise>
 #include <QTcpSocket>
+#include <QThreadPool>
+#include <QTimer>
 
-#include "irequesthandler.h"
-#include "requestparser.h"
+#include "connectionworker.h"
+#include "eventstream.h"
 #include "responsegenerator.h"
 
+using namespace std::chrono_literals;
 using namespace Http;
 
-Connection::Connection(QTcpSocket *socket, IRequestHandler *requestHandler, QObject *parent)
+namespace
+{
+    // smaller content is compressed quicker than it takes to hand it over to a worker thread
+    const qsizetype ASYNC_COMPRESSION_THRESHOLD = 64 * 1024;
+
+    // the client has to receive the responses before any more of its requests are read,
+    // so it can't queue an unlimited amount of work for the server thread
+    const std::size_t MAX_PENDING_REQUESTS = 32;
+    // the socket stops receiving the data that isn't read once its buffer is full
+    const qint64 SOCKET_READ_BUFFER_SIZE = 1024 * 1024;
+
+    const std::chrono::seconds EVENT_STREAM_HEARTBEAT_INTERVAL {15};
+    // the client that doesn't receive anything for that long is considered gone
+    const int EVENT_STREAM_STALL_TIMEOUT = std::chrono::milliseconds(60s).count();
+
+    // returns nothing if the job was cancelled, which only happens when the server is being destroyed
+    std::optional<Response> takeResult(QFutureWatcher<Response> *watcher)
+    {
+        watcher->deleteLater();
+
+        const QFuture<Response> future = watcher->future();
+        if (future.isCanceled() || (future.resultCount() == 0))
+            return std::nullopt;
+        return future.result();
+    }
+}
+
+Connection::Connection(QTcpSocket *socket, ConnectionWorker *worker, QObject *parent)
     : QObject(parent)
     , m_socket(socket)
-    , m_requestHandler(requestHandler)
+    , m_worker(worker)
 {
     m_socket->setParent(this);
+    m_socket->setReadBufferSize(SOCKET_READ_BUFFER_SIZE);
     connect(m_socket, &QAbstractSocket::disconnected, this, &Connection::closed);
 
     // reserve common size for requests, don't use the max allowed size which is too big for
@@ -63,8 +101,22 @@ Connection::Connection(QTcpSocket *socket, IRequestHandler *requestHandler, QObj
     });
 }
 
+Connection::~Connection()
+{
+    discardPendingResponses();
+
+    if (m_eventStream)
+    {
+        m_eventStream->detach();
+        m_eventStream->deleteLater();
+    }
+}
+
 void Connection::read()
 {
+    if (m_pendingResponses.size() >= MAX_PENDING_REQUESTS)
+        return;
+
     // reuse existing buffer and avoid unnecessary memory allocation/relocation
     const qsizetype previousSize = m_receivedData.size();
     const qint64 bytesAvailable = m_socket->bytesAvailable();
@@ -78,9 +130,17 @@ void Connection::read()
     if (bytesRead < bytesAvailable) [[unlikely]]
         m_receivedData.chop(bytesAvailable - bytesRead);
 
-    while (!m_receivedData.isEmpty())
+    if (m_eventStream || m_isClosing)
+    {
+        // the client isn't supposed to send anything else over the event stream connection
+        // and the requests that follow the bad one are discarded
+        m_receivedData.clear();
+        return;
+    }
+
+    while (!m_receivedData.isEmpty() && (m_pendingResponses.size() < MAX_PENDING_REQUESTS))
     {
-        const RequestParser::ParseResult result = RequestParser::parse(m_receivedData);
+        const RequestParser::ParseResult result = m_requestParser.parse(m_receivedData);
 
         switch (result.status)
         {
@@ -95,8 +155,8 @@ void Connection::read()
                     Response resp(413, u"Payload Too Large"_s);
                     resp.headers[HEADER_CONNECTION] = u"close"_s;
 
-                    sendResponse(resp);
-                    m_socket->close();
+                    queueResponse(std::move(resp));
+                    closeWhenResponsesSent();
                 }
             }
             return;
@@ -109,8 +169,8 @@ void Connection::read()
                 Response resp(501, u"Not Implemented"_s);
                 resp.headers[HEADER_CONNECTION] = u"close"_s;
 
-                sendResponse(resp);
-                m_socket->close();
+                queueResponse(std::move(resp));
+                closeWhenResponsesSent();
             }
             return;
 
@@ -122,41 +182,14 @@ void Connection::read()
                 Response resp(400, u"Bad Request"_s);
                 resp.headers[HEADER_CONNECTION] = u"close"_s;
 
-                sendResponse(resp);
-                m_socket->close();
+                queueResponse(std::move(resp));
+                closeWhenResponsesSent();
             }
             return;
 
         case RequestParser::ParseStatus::OK:
-            {
-                const Environment env {m_socket->localAddress(), m_socket->localPort(), m_socket->peerAddress(), m_socket->peerPort()};
-
-                if (result.request.method == HEADER_REQUEST_METHOD_HEAD)
-                {
-                    Request getRequest = result.request;
-                    getRequest.method = HEADER_REQUEST_METHOD_GET;
-
-                    Response resp = m_requestHandler->processRequest(getRequest, env);
-
-                    resp.headers[HEADER_CONNECTION] = u"keep-alive"_s;
-                    resp.headers[HEADER_CONTENT_LENGTH] = QString::number(resp.content.length());
-                    resp.content.clear();
-
-                    sendResponse(resp);
-                }
-                else
-                {
-                    Response resp = m_requestHandler->processRequest(result.request, env);
-
-                    if (acceptsGzipEncoding(result.request.headers.value(u"accept-encoding"_s)))
-                        resp.headers[HEADER_CONTENT_ENCODING] = u"gzip"_s;
-                    resp.headers[HEADER_CONNECTION] = u"keep-alive"_s;
-
-                    sendResponse(resp);
-                }
-
-                m_receivedData.remove(0, result.frameSize);
-            }
+            processRequest(result.request);
+            m_receivedData.remove(0, result.frameSize);
             break;
 
         default:
@@ -166,57 +199,211 @@ void Connection::read()
     }
 }
 
-void Connection::sendResponse(const Response &response) const
+// reads the requests that were held back while too many of them were pending
+void Connection::resumeReading()
 {
-    m_socket->write(toByteArray(response));
+    if (!m_socket->isOpen() || (m_pendingResponses.size() >= MAX_PENDING_REQUESTS))
+        return;
+
+    if ((m_socket->bytesAvailable() > 0) || !m_receivedData.isEmpty())
+        read();
 }
 
-bool Connection::hasExpired(const qint64 timeout) const
+void Connection::processRequest(const Request &request)
 {
-    return (m_socket->bytesAvailable() == 0)
-        && (m_socket->bytesToWrite() == 0)
-        && m_idleTimer.hasExpired(timeout);
+    const Environment env {m_socket->localAddress(), m_socket->localPort(), m_socket->peerAddress(), m_socket->peerPort()};
+
+    PendingResponse pendingResponse;
+    pendingResponse.cancellation = std::make_shared<RequestCancellation>();
+    if (request.method == HEADER_REQUEST_METHOD_HEAD)
+    {
+        Request getRequest = request;
+        getRequest.method = HEADER_REQUEST_METHOD_GET;
+
+        pendingResponse.isHeadRequest = true;
+        pendingResponse.processingWatcher = watchResponse(m_worker->processRequest(getRequest, env, pendingResponse.cancellation));
+    }
+    else
+    {
+        pendingResponse.contentEncoding = selectContentEncoding(request.headers.value(HEADER_ACCEPT_ENCODING));
+        pendingResponse.processingWatcher = watchResponse(m_worker->processRequest(request, env, pendingResponse.cancellation));
+    }
+
+    m_pendingResponses.push_back(std::move(pendingResponse));
+}
+
+void Connection::queueResponse(Response response)
+{
+    m_pendingResponses.push_back({.response = std::move(response)});
+    sendPendingResponses();
+}
+
+bool Connection::updatePendingResponse(PendingResponse &pendingResponse)
+{
+    if (pendingResponse.processingWatcher && pendingResponse.processingWatcher->isFinished())
+    {
+        std::optional<Response> response = takeResult(std::exchange(pendingResponse.processingWatcher, nullptr));
+        if (!response)
+            return false;
+
+        pendingResponse.response = std::move(*response);
+        finishProcessing(pendingResponse);
+    }
+    else if (pendingResponse.compressionWatcher && pendingResponse.compressionWatcher->isFinished())
+    {
+        std::optional<Response> response = takeResult(std::exchange(pendingResponse.compressionWatcher, nullptr));
+        if (!response)
+            return false;
+
+        pendingResponse.response = std::move(*response);
+    }
+
+    return true;
 }
 
-bool Connection::acceptsGzipEncoding(QString codings)
+void Connection::finishProcessing(PendingResponse &pendingResponse)
 {
-    // [rfc7231] 5.3.4. Accept-Encoding
+    Response &response = pendingResponse.response;
+    response.headers[HEADER_CONNECTION] = u"keep-alive"_s;
+
+    if (pendingResponse.isHeadRequest)
+    {
+        if (response.contentGenerator)
+            response.content = std::exchange(response.contentGenerator, {})();
+        response.headers[HEADER_CONTENT_LENGTH] = QString::number(response.content.length());
+        response.content.clear();
+        return;
+    }
+
+    if (response.eventStream)
+    {
+        // the stream is attached once the responses to the preceding requests are sent
+        if (!m_eventStream)
+            m_eventStream = response.eventStream;
+        m_receivedData.clear();
+        return;
+    }
+
+    const QString contentEncoding = std::exchange(pendingResponse.contentEncoding, {});
+    // the generated content is the large one, so it is generated along with the compression
+    const bool isAsyncCompression = response.contentGenerator
+        || (!contentEncoding.isEmpty() && response.isCompressionAllowed && (response.content.size() >= ASYNC_COMPRESSION_THRESHOLD));
+    if (!isAsyncCompression)
+    {
+        compressContent(response, contentEncoding);
+        return;
+    }
+
+    // the watcher belongs to the connection, so it doesn't matter if the connection is gone
+    // by the time the compression is finished, while the promise is kept alive by the job itself
+    auto promise = std::make_shared<QPromise<Response>>();
+    pendingResponse.compressionWatcher = watchResponse(promise->future());
+    promise->start();
+
+    m_worker->compressionThreadPool()->start([promise, response = std::move(response), contentEncoding]() mutable
+    {
+        if (response.contentGenerator)
+            response.content = std::exchange(response.contentGenerator, {})();
+        compressContent(response, contentEncoding);
+        promise->addResult(std::move(response));
+        promise->finish();
+    });
+}
 
-    const auto isCodingAvailable = [](const QList<QStringView> &list, const QStringView encoding) -> bool
+void Connection::sendPendingResponses()
+{
+    for (PendingResponse &pendingResponse : m_pendingResponses)
     {
-        for (const QStringView &str : list)
+        if (!updatePendingResponse(pendingResponse))
         {
-            if (!str.startsWith(encoding))
-                continue;
+            // the server is being destroyed, no more responses can be sent
+            discardPendingResponses();
+            m_socket->close();
+            return;
+        }
+    }
 
-            // without quality values
-            if (str == encoding)
-                return true;
+    while (!m_pendingResponses.empty())
+    {
+        PendingResponse &pendingResponse = m_pendingResponses.front();
+        if (pendingResponse.processingWatcher || pendingResponse.compressionWatcher)
+            return;
+
+        sendResponse(pendingResponse.response);
+        if (pendingResponse.response.eventStream && (pendingResponse.response.eventStream == m_eventStream))
+        {
+            // the client isn't supposed to send anything else over the event stream connection
+            m_pendingResponses.pop_front();
+            discardPendingResponses();
+            m_eventStream->attach(m_socket);
+
+            auto *heartbeatTimer = new QTimer(this);
+            connect(heartbeatTimer, &QTimer::timeout, this, [this] { m_eventStream->sendHeartbeat(); });
+            heartbeatTimer->start(EVENT_STREAM_HEARTBEAT_INTERVAL);
+            return;
+        }
 
-            // [rfc7231] 5.3.1. Quality Values
-            const QStringView substr = str.mid(encoding.size() + 3);  // ex. skip over "gzip;q="
+        m_pendingResponses.pop_front();
+    }
 
-            bool ok = false;
-            const double qvalue = substr.toDouble(&ok);
-            if (!ok || (qvalue <= 0))
-                return false;
+    if (m_isClosing)
+        m_socket->close();
+}
 
-            return true;
+void Connection::discardPendingResponses()
+{
+    for (const PendingResponse &pendingResponse : m_pendingResponses)
+    {
+        if (pendingResponse.processingWatcher)
+        {
+            // the response can still hold the stream that is deleted by no one else
+            pendingResponse.cancellation->cancel(pendingResponse.processingWatcher->future());
+            pendingResponse.processingWatcher->deleteLater();
         }
-        return false;
-    };
+        if (pendingResponse.compressionWatcher)
+            pendingResponse.compressionWatcher->deleteLater();
+        // the streams of the requests that follow the one the connection is used for
+        if (pendingResponse.response.eventStream && (pendingResponse.response.eventStream != m_eventStream))
+            pendingResponse.response.eventStream->deleteLater();
+    }
 
-    const QList<QStringView> list = QStringView(codings.remove(u' ').remove(u'\t')).split(u',', Qt::SkipEmptyParts);
-    if (list.isEmpty())
-        return false;
+    m_pendingResponses.clear();
+}
+
+void Connection::sendResponse(const Response &response) const
+{
+    m_socket->write(toByteArray(response));
+}
 
-    const bool canGzip = isCodingAvailable(list, u"gzip"_s);
-    if (canGzip)
-        return true;
+void Connection::closeWhenResponsesSent()
+{
+    m_isClosing = true;
+    sendPendingResponses();
+}
 
-    const bool canAny = isCodingAvailable(list, u"*"_s);
-    if (canAny)
-        return true;
+QFutureWatcher<Response> *Connection::watchResponse(const QFuture<Response> &future)
+{
+    auto *watcher = new QFutureWatcher<Response>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this]
+    {
+        sendPendingResponses();
+        resumeReading();
+    });
+    watcher->setFuture(future);
+    return watcher;
+}
 
-    return false;
+bool Connection::hasExpired(const qint64 timeout) const
+{
+    // the client is waiting for the responses that are still being processed or compressed
+    if (!m_pendingResponses.empty())
+        return false;
+
+    // event stream stays open as long as the client keeps receiving the events and heartbeats
+    if (m_eventStream)
+        return (m_socket->bytesToWrite() > 0) && m_idleTimer.hasExpired(EVENT_STREAM_STALL_TIMEOUT);
+
+    return (m_socket->bytesAvailable() == 0)
+        && (m_socket->bytesToWrite() == 0)
+        && m_idleTimer.hasExpired(timeout);
 }
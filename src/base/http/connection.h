@@ -30,23 +30,34 @@
 
 #pragma once
 
+#include <deque>
+#include <memory>
+
 #include <QElapsedTimer>
 #include <QObject>
 
+#include "requestparser.h"
+
 class QTcpSocket;
 
+template <typename T> class QFuture;
+template <typename T> class QFutureWatcher;
+
 namespace Http
 {
-    class IRequestHandler;
-    struct Response;
+    class ConnectionWorker;
+    class EventStream;
+    class RequestCancellation;
 
+    // Lives in the I/O thread of its worker
     class Connection : public QObject
     {
         Q_OBJECT
         Q_DISABLE_COPY_MOVE(Connection)
 
     public:
-        Connection(QTcpSocket *socket, IRequestHandler *requestHandler, QObject *parent = nullptr);
+        Connection(QTcpSocket *socket, ConnectionWorker *worker, QObject *parent = nullptr);
+        ~Connection() override;
 
         bool hasExpired(qint64 timeout) const;
 
@@ -54,13 +65,42 @@ namespace Http
         void closed();
 
     private:
-        static bool acceptsGzipEncoding(QString codings);
+        struct PendingResponse
+        {
+            Response response;
+            // the content is compressed with it once the response is processed
+            QString contentEncoding;
+            bool isHeadRequest = false;
+            // set while the request is being processed in the server thread
+            QFutureWatcher<Response> *processingWatcher = nullptr;
+            std::shared_ptr<RequestCancellation> cancellation;
+            // set while the content is being compressed on a worker thread
+            QFutureWatcher<Response> *compressionWatcher = nullptr;
+        };
+
         void read();
+        void resumeReading();
+        // responses are sent in the order of the requests, even if the later ones are ready first
+        void processRequest(const Request &request);
+        void queueResponse(Response response);
+        bool updatePendingResponse(PendingResponse &pendingResponse);
+        void finishProcessing(PendingResponse &pendingResponse);
+        void sendPendingResponses();
+        void discardPendingResponses();
         void sendResponse(const Response &response) const;
+        void closeWhenResponsesSent();
+        QFutureWatcher<Response> *watchResponse(const QFuture<Response> &future);
 
         QTcpSocket *m_socket = nullptr;
-        IRequestHandler *m_requestHandler = nullptr;
+        ConnectionWorker *m_worker = nullptr;
         QByteArray m_receivedData;
+        // keeps the state of the partially received request between reads
+        RequestParser m_requestParser;
+        std::deque<PendingResponse> m_pendingResponses;
+        bool m_isClosing = false;
+        // once the event stream response is processed, the connection is used for its events only,
+        // the stream belongs to the server thread and is deleted once the connection is gone
+        EventStream *m_eventStream = nullptr;
         QElapsedTimer m_idleTimer;
     };
 }
@@ -0,0 +1,186 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "connectionworker.h"
+
+#include <chrono>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+#include <QtLogging>
+#include <QMutexLocker>
+#include <QPromise>
+#include <QSslSocket>
+#include <QTimer>
+
+#include "connection.h"
+#include "eventstream.h"
+#include "irequesthandler.h"
+#include "types.h"
+
+using namespace std::chrono_literals;
+using namespace Http;
+
+namespace
+{
+    const int KEEP_ALIVE_DURATION = std::chrono::milliseconds(7s).count();
+    const std::chrono::seconds CONNECTIONS_SCAN_INTERVAL {2};
+}
+
+bool RequestCancellation::isCancelled() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_isCancelled;
+}
+
+void RequestCancellation::deliver(QPromise<Response> &promise, Response response)
+{
+    const QMutexLocker locker {&m_mutex};
+    if (m_isCancelled)
+    {
+        // nothing else would delete the stream that isn't attached to any connection
+        if (response.eventStream)
+            response.eventStream->deleteLater();
+        return;
+    }
+
+    promise.addResult(std::move(response));
+}
+
+void RequestCancellation::cancel(const QFuture<Response> &future)
+{
+    const QMutexLocker locker {&m_mutex};
+    m_isCancelled = true;
+
+    if (future.isCanceled() || (future.resultCount() == 0))
+        return;
+
+    const Response response = future.result();
+    if (response.eventStream)
+        response.eventStream->deleteLater();
+}
+
+ConnectionWorker::ConnectionWorker(IRequestHandler *requestHandler, QObject *requestHandlerContext
+        , QThreadPool *compressionThreadPool, QObject *parent)
+    : QObject(parent)
+    , m_requestHandler(requestHandler)
+    , m_requestHandlerContext(requestHandlerContext)
+    , m_compressionThreadPool(compressionThreadPool)
+{
+    // the timer is moved to the thread of the worker along with it
+    auto *dropConnectionTimer = new QTimer(this);
+    connect(dropConnectionTimer, &QTimer::timeout, this, &ConnectionWorker::dropTimedOutConnection);
+    dropConnectionTimer->start(CONNECTIONS_SCAN_INTERVAL);
+}
+
+void ConnectionWorker::addConnection(const qintptr socketDescriptor, const std::optional<QSslConfiguration> &sslConfiguration)
+{
+    std::unique_ptr<QTcpSocket> serverSocket = sslConfiguration ? std::make_unique<QSslSocket>(this) : std::make_unique<QTcpSocket>(this);
+    if (!serverSocket->setSocketDescriptor(socketDescriptor))
+    {
+        emit connectionRemoved();
+        return;
+    }
+
+    try
+    {
+        if (sslConfiguration)
+        {
+            auto *sslSocket = static_cast<QSslSocket *>(serverSocket.get());
+            sslSocket->setSslConfiguration(*sslConfiguration);
+            sslSocket->startServerEncryption();
+        }
+
+        auto *connection = new Connection(serverSocket.release(), this, this);
+        m_connections.insert(connection);
+        connect(connection, &Connection::closed, this, [this, connection] { removeConnection(connection); });
+    }
+    catch (const std::bad_alloc &exception)
+    {
+        // drop the connection instead of throwing exception and crash
+        qWarning("Failed to allocate memory for HTTP connection. Connection closed.");
+        emit connectionRemoved();
+    }
+}
+
+QFuture<Response> ConnectionWorker::processRequest(const Request &request, const Environment &env
+        , std::shared_ptr<RequestCancellation> cancellation) const
+{
+    // the promise is cancelled if the server is gone before the request is processed
+    auto promise = std::make_shared<QPromise<Response>>();
+    QFuture<Response> future = promise->future();
+    promise->start();
+
+    // read-only requests may be answered without waiting for the server thread
+    if (std::optional<Response> response = m_requestHandler->processRequestConcurrently(request, env))
+    {
+        promise->addResult(std::move(*response));
+        promise->finish();
+        return future;
+    }
+
+    QMetaObject::invokeMethod(m_requestHandlerContext
+            , [promise, cancellation = std::move(cancellation), requestHandler = m_requestHandler, request, env]
+    {
+        // the request of the connection that is already gone isn't worth processing
+        if (!cancellation->isCancelled())
+            cancellation->deliver(*promise, requestHandler->processRequest(request, env));
+        promise->finish();
+    }, Qt::QueuedConnection);
+
+    return future;
+}
+
+QThreadPool *ConnectionWorker::compressionThreadPool() const
+{
+    return m_compressionThreadPool;
+}
+
+void ConnectionWorker::removeConnection(Connection *connection)
+{
+    if (!m_connections.remove(connection))
+        return;
+
+    connection->deleteLater();
+    emit connectionRemoved();
+}
+
+void ConnectionWorker::dropTimedOutConnection()
+{
+    m_connections.removeIf([this](Connection *connection)
+    {
+        if (!connection->hasExpired(KEEP_ALIVE_DURATION))
+            return false;
+
+        connection->deleteLater();
+        emit connectionRemoved();
+        return true;
+    });
+}
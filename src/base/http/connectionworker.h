@@ -0,0 +1,99 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include <QFuture>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QSslConfiguration>
+
+class QThreadPool;
+
+template <typename T> class QPromise;
+
+namespace Http
+{
+    class Connection;
+    class IRequestHandler;
+    struct Environment;
+    struct Request;
+    struct Response;
+
+    // Shared by the connection and the job that processes its request in the server thread,
+    // so that the response the connection is no longer able to send is released by one of them.
+    class RequestCancellation
+    {
+    public:
+        // used by the job, the response to the cancelled request isn't delivered
+        bool isCancelled() const;
+        void deliver(QPromise<Response> &promise, Response response);
+        // used by the connection, the response that is already delivered is discarded
+        void cancel(const QFuture<Response> &future);
+
+    private:
+        mutable QMutex m_mutex;
+        bool m_isCancelled = false;
+    };
+
+    // Lives in one of the I/O threads of the server and does the socket I/O, TLS and request parsing
+    // of its connections there, while the requests are processed by the handler in the server thread.
+    class ConnectionWorker final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(ConnectionWorker)
+
+    public:
+        ConnectionWorker(IRequestHandler *requestHandler, QObject *requestHandlerContext
+                , QThreadPool *compressionThreadPool, QObject *parent = nullptr);
+
+        // must be called in the thread of the worker
+        void addConnection(qintptr socketDescriptor, const std::optional<QSslConfiguration> &sslConfiguration);
+
+        // used by the connections of the worker
+        QFuture<Response> processRequest(const Request &request, const Environment &env
+                , std::shared_ptr<RequestCancellation> cancellation) const;
+        QThreadPool *compressionThreadPool() const;
+
+    signals:
+        void connectionRemoved();
+
+    private:
+        void removeConnection(Connection *connection);
+        void dropTimedOutConnection();
+
+        IRequestHandler *m_requestHandler = nullptr;
+        QObject *m_requestHandlerContext = nullptr;
+        QThreadPool *m_compressionThreadPool = nullptr;
+        QSet<Connection *> m_connections;  // for tracking persistent connections
+    };
+}
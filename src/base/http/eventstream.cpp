@@ -0,0 +1,156 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "eventstream.h"
+
+#include <utility>
+
+#include <QIODevice>
+#include <QMutexLocker>
+
+using namespace Http;
+
+bool EventStream::send(const QString &event, const QByteArray &data)
+{
+    // [HTML Living Standard] 9.2.6. Interpreting an event stream
+    QByteArray message;
+    message.reserve(event.size() + data.size() + 16);
+    if (!event.isEmpty())
+        message.append("event: ").append(event.toUtf8()).append('\n');
+    message.append("data: ").append(data).append("\n\n");
+
+    const QMutexLocker locker {&m_mutex};
+    if (m_isClosed)
+        return false;
+
+    // a single message that exceeds the limit is still accepted as long as nothing else is pending,
+    // otherwise it could never be delivered
+    const qint64 pending = m_buffer.size() + m_deviceBytesToWrite;
+    if ((pending > 0) && ((pending + message.size()) > MAX_PENDING_SIZE))
+    {
+        m_isOverflowed = true;
+        return false;
+    }
+
+    enqueue(message);
+    return true;
+}
+
+bool EventStream::isOverflowed() const
+{
+    return m_isOverflowed;
+}
+
+void EventStream::resetOverflow()
+{
+    m_isOverflowed = false;
+}
+
+void EventStream::close()
+{
+    const QMutexLocker locker {&m_mutex};
+    if (m_isClosed)
+        return;
+
+    m_isClosed = true;
+    m_buffer.clear();
+    // the stream that isn't attached yet is closed once it is
+    if (m_device)
+        QMetaObject::invokeMethod(m_device, [device = m_device] { device->close(); }, Qt::QueuedConnection);
+}
+
+void EventStream::attach(QIODevice *device)
+{
+    Q_ASSERT(device);
+
+    m_bytesWrittenConnection = connect(device, &QIODevice::bytesWritten, device, [this, device]
+    {
+        const QMutexLocker locker {&m_mutex};
+        m_deviceBytesToWrite = device->bytesToWrite();
+    });
+
+    QMutexLocker locker {&m_mutex};
+    m_device = device;
+    if (m_isClosed)
+    {
+        QMetaObject::invokeMethod(device, [device] { device->close(); }, Qt::QueuedConnection);
+        return;
+    }
+    locker.unlock();
+
+    writeBuffer();
+}
+
+void EventStream::detach()
+{
+    const QMutexLocker locker {&m_mutex};
+
+    disconnect(m_bytesWrittenConnection);
+    m_device = nullptr;
+    m_deviceBytesToWrite = 0;
+}
+
+void EventStream::sendHeartbeat()
+{
+    const QMutexLocker locker {&m_mutex};
+    // the events that are being sent keep the connection busy anyway
+    if (m_isClosed || !m_buffer.isEmpty() || (m_deviceBytesToWrite > 0))
+        return;
+
+    // [HTML Living Standard] 9.2.6. Interpreting an event stream
+    // the line that starts with colon is a comment, it is ignored by the client
+    enqueue(":\n\n");
+}
+
+void EventStream::enqueue(const QByteArray &message)
+{
+    // the buffer is already scheduled to be written otherwise
+    const bool isWriteNeeded = m_device && m_buffer.isEmpty();
+    m_buffer.append(message);
+    if (isWriteNeeded)
+        QMetaObject::invokeMethod(m_device, [this] { writeBuffer(); }, Qt::QueuedConnection);
+}
+
+void EventStream::writeBuffer()
+{
+    QMutexLocker locker {&m_mutex};
+    if (!m_device || m_buffer.isEmpty())
+        return;
+
+    // the device isn't written under the lock since it can report its progress right away
+    QIODevice *device = m_device;
+    const QByteArray data = std::exchange(m_buffer, {});
+    m_deviceBytesToWrite += data.size();
+    locker.unlock();
+
+    device->write(data);
+
+    locker.relock();
+    if (m_device)
+        m_deviceBytesToWrite = m_device->bytesToWrite();
+}
@@ -0,0 +1,84 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QMetaObject>
+#include <QMutex>
+#include <QObject>
+
+class QIODevice;
+
+namespace Http
+{
+    // Server-Sent Events stream of the response that is kept open after its headers are sent.
+    // The events are written to the connection as they are posted, but only as long as the client
+    // keeps up with receiving them, otherwise they are dropped and the stream is marked as overflowed
+    // so the producer can send the entire state instead of the missed changes once the client catches up.
+    // The stream belongs to the thread of its producer, while the device it is attached to
+    // can belong to another one, in which case the events are written to the device in its thread.
+    class EventStream final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(EventStream)
+
+    public:
+        static const qint64 MAX_PENDING_SIZE = 4 * 1024 * 1024;  // 4 MiB
+
+        using QObject::QObject;
+
+        bool send(const QString &event, const QByteArray &data);
+        bool isOverflowed() const;
+        void resetOverflow();
+        // ends the stream, the connection it is sent over is closed then
+        void close();
+
+        // used by the connection the response is sent to, in the thread of the device,
+        // the stream must be detached before the device is destroyed
+        void attach(QIODevice *device);
+        void detach();
+        // keeps the idle connection alive, so that a dead peer is noticed by the network stack
+        void sendHeartbeat();
+
+    private:
+        // must be called with the mutex locked
+        void enqueue(const QByteArray &message);
+        void writeBuffer();
+
+        QMutex m_mutex;
+        QIODevice *m_device = nullptr;
+        QMetaObject::Connection m_bytesWrittenConnection;
+        // events that aren't written to the device yet
+        QByteArray m_buffer;
+        // the data the device hasn't sent yet, as of the last time it was written or reported progress
+        qint64 m_deviceBytesToWrite = 0;
+        bool m_isOverflowed = false;
+        bool m_isClosed = false;
+    };
+}
@@ -28,16 +28,24 @@
 
 #pragma once
 
+#include <optional>
+
+#include "types.h"
+
 namespace Http
 {
-    struct Environment;
-    struct Request;
-    struct Response;
-
     class IRequestHandler
     {
     public:
         virtual ~IRequestHandler() = default;
+        // called in the thread of the server, while the connections live in its I/O threads
         virtual Response processRequest(const Request &request, const Environment &env) = 0;
+        // called in the I/O thread of the connection before the request is passed to the thread of the server,
+        // the request is answered right away if the response is returned, it must be thread-safe
+        virtual std::optional<Response> processRequestConcurrently([[maybe_unused]] const Request &request
+                , [[maybe_unused]] const Environment &env)
+        {
+            return std::nullopt;
+        }
     };
 }
@@ -80,15 +80,36 @@ namespace
 RequestParser::ParseResult RequestParser::parse(const QByteArray &data)
 {
     // Warning! Header names are converted to lowercase
-    return RequestParser().doParse(data);
+    if (m_state == State::Headers)
+    {
+        ParseResult result = parseHeaders(data);
+        if ((result.status != ParseStatus::Incomplete) || (m_state == State::Headers))
+            return result;
+    }
+
+    return parseBody(data);
+}
+
+void RequestParser::reset()
+{
+    *this = RequestParser();
 }
 
-RequestParser::ParseResult RequestParser::doParse(const QByteArrayView data)
+RequestParser::ParseResult RequestParser::finish(const ParseStatus status, const long frameSize)
+{
+    ParseResult result {status, std::move(m_request), frameSize};
+    reset();
+    return result;
+}
+
+RequestParser::ParseResult RequestParser::parseHeaders(const QByteArrayView data)
 {
     // we don't handle malformed requests which use double `LF` as delimiter
-    const int headerEnd = data.indexOf(EOH);
+    const qsizetype headerEnd = data.indexOf(EOH, m_headersScanPos);
     if (headerEnd < 0)
     {
+        // the delimiter may be split between the current and the next chunk of data
+        m_headersScanPos = std::max<qsizetype>(0, (data.size() - EOH.size() + 1));
         qDebug() << Q_FUNC_INFO << "incomplete request";
         return {ParseStatus::Incomplete, Request(), 0};
     }
@@ -97,59 +118,80 @@ RequestParser::ParseResult RequestParser::doParse(const QByteArrayView data)
     if (!parseStartLines(httpHeaders))
     {
         qWarning() << Q_FUNC_INFO << "header parsing error";
-        return {ParseStatus::BadRequest, Request(), 0};
+        return finish(ParseStatus::BadRequest);
     }
 
-    const int headerLength = headerEnd + EOH.length();
+    m_headersLength = headerEnd + EOH.length();
 
     // handle supported methods
     if ((m_request.method == HEADER_REQUEST_METHOD_GET) || (m_request.method == HEADER_REQUEST_METHOD_HEAD))
-        return {ParseStatus::OK, m_request, headerLength};
+        return finish(ParseStatus::OK, m_headersLength);
+
+    if (m_request.method != HEADER_REQUEST_METHOD_POST)
+        return finish(ParseStatus::BadMethod);
 
-    if (m_request.method == HEADER_REQUEST_METHOD_POST)
+    const auto parseContentLength = [this]() -> int
     {
-        const auto parseContentLength = [this]() -> int
-        {
-            // [rfc7230] 3.3.2. Content-Length
+        // [rfc7230] 3.3.2. Content-Length
 
-            const QString rawValue = m_request.headers.value(HEADER_CONTENT_LENGTH);
-            if (rawValue.isNull())  // `HEADER_CONTENT_LENGTH` does not exist
-                return 0;
-            return Utils::String::parseInt(rawValue).value_or(-1);
-        };
+        const QString rawValue = m_request.headers.value(HEADER_CONTENT_LENGTH);
+        if (rawValue.isNull())  // `HEADER_CONTENT_LENGTH` does not exist
+            return 0;
+        return Utils::String::parseInt(rawValue).value_or(-1);
+    };
 
-        const int contentLength = parseContentLength();
-        if (contentLength < 0)
-        {
-            qWarning() << Q_FUNC_INFO << "bad request: content-length invalid";
-            return {ParseStatus::BadRequest, Request(), 0};
-        }
-        if (contentLength > MAX_CONTENT_SIZE)
-        {
-            qWarning() << Q_FUNC_INFO << "bad request: message too long";
-            return {ParseStatus::BadRequest, Request(), 0};
-        }
+    const int contentLength = parseContentLength();
+    if (contentLength < 0)
+    {
+        qWarning() << Q_FUNC_INFO << "bad request: content-length invalid";
+        return finish(ParseStatus::BadRequest);
+    }
+    if (contentLength > MAX_CONTENT_SIZE)
+    {
+        qWarning() << Q_FUNC_INFO << "bad request: message too long";
+        return finish(ParseStatus::BadRequest);
+    }
 
-        if (contentLength > 0)
-        {
-            const QByteArrayView httpBodyView = data.mid(headerLength, contentLength);
-            if (httpBodyView.length() < contentLength)
-            {
-                qDebug() << Q_FUNC_INFO << "incomplete request";
-                return {ParseStatus::Incomplete, Request(), 0};
-            }
+    m_contentLength = contentLength;
+    if ((m_contentLength > 0) && m_request.headers[HEADER_CONTENT_TYPE].toLower().startsWith(CONTENT_TYPE_FORM_DATA))
+    {
+        if (!initMultipart())
+            return finish(ParseStatus::BadRequest);
+    }
 
-            if (!parsePostMessage(httpBodyView))
-            {
-                qWarning() << Q_FUNC_INFO << "message body parsing error";
-                return {ParseStatus::BadRequest, Request(), 0};
-            }
+    m_state = State::Body;
+    return {ParseStatus::Incomplete, Request(), 0};
+}
+
+RequestParser::ParseResult RequestParser::parseBody(const QByteArrayView data)
+{
+    const QByteArrayView httpBodyView = data.sliced(m_headersLength).first(std::min((data.size() - m_headersLength), m_contentLength));
+    const bool isComplete = (httpBodyView.size() == m_contentLength);
+
+    if (m_isMultipart)
+    {
+        // the parts that are already received are parsed right away
+        // so only the last incomplete part needs to be scanned again
+        if (!parseMultipart(httpBodyView, isComplete))
+        {
+            qWarning() << Q_FUNC_INFO << "message body parsing error";
+            return finish(ParseStatus::BadRequest);
         }
+    }
+
+    if (!isComplete)
+    {
+        qDebug() << Q_FUNC_INFO << "incomplete request";
+        return {ParseStatus::Incomplete, Request(), 0};
+    }
 
-        return {ParseStatus::OK, m_request, (headerLength + contentLength)};
+    if (!m_isMultipart && (m_contentLength > 0) && !parsePostMessage(httpBodyView))
+    {
+        qWarning() << Q_FUNC_INFO << "message body parsing error";
+        return finish(ParseStatus::BadRequest);
     }
 
-    return {ParseStatus::BadMethod, m_request, 0};
+    return finish(ParseStatus::OK, (m_headersLength + m_contentLength));
 }
 
 bool RequestParser::parseStartLines(const QStringView data)
@@ -258,48 +300,78 @@ bool RequestParser::parsePostMessage(const QByteArrayView data)
         return true;
     }
 
+    qWarning() << Q_FUNC_INFO << "unknown content type:" << contentType;
+    return false;
+}
+
+bool RequestParser::initMultipart()
+{
     // multipart/form-data
-    if (contentTypeLower.startsWith(CONTENT_TYPE_FORM_DATA))
+    // [rfc2046] 5.1.1. Common Syntax
+
+    const QString contentType = m_request.headers[HEADER_CONTENT_TYPE];
+
+    // find boundary delimiter
+    const QString boundaryFieldName = u"boundary="_s;
+    const int idx = contentType.indexOf(boundaryFieldName);
+    if (idx < 0)
     {
-        // [rfc2046] 5.1.1. Common Syntax
+        qWarning() << Q_FUNC_INFO << "Could not find boundary in multipart/form-data header!";
+        return false;
+    }
 
-        // find boundary delimiter
-        const QString boundaryFieldName = u"boundary="_s;
-        const int idx = contentType.indexOf(boundaryFieldName);
-        if (idx < 0)
-        {
-            qWarning() << Q_FUNC_INFO << "Could not find boundary in multipart/form-data header!";
-            return false;
-        }
+    const QByteArray delimiter = Utils::String::unquote(QStringView(contentType).mid(idx + boundaryFieldName.size())).toLatin1();
+    if (delimiter.isEmpty())
+    {
+        qWarning() << Q_FUNC_INFO << "boundary delimiter field empty!";
+        return false;
+    }
 
-        const QByteArray delimiter = Utils::String::unquote(QStringView(contentType).mid(idx + boundaryFieldName.size())).toLatin1();
-        if (delimiter.isEmpty())
-        {
-            qWarning() << Q_FUNC_INFO << "boundary delimiter field empty!";
-            return false;
-        }
+    m_isMultipart = true;
+    m_dashDelimiter = QByteArray("--") + delimiter + CRLF;
+    m_endDelimiter = QByteArray("--") + delimiter + QByteArray("--") + CRLF;
+    return true;
+}
+
+bool RequestParser::parseMultipart(const QByteArrayView body, const bool isComplete)
+{
+    // split data by "dash-boundary", the parts are parsed as soon as the next delimiter arrives
+    while (true)
+    {
+        const qsizetype delimiterPos = body.indexOf(m_dashDelimiter, m_partScanPos);
+        if (delimiterPos < 0)
+            break;
 
-        // split data by "dash-boundary"
-        const QByteArray dashDelimiter = QByteArray("--") + delimiter + CRLF;
-        QList<QByteArrayView> multipart = splitToViews(data, dashDelimiter, Qt::SkipEmptyParts);
-        if (multipart.isEmpty())
+        if (const QByteArrayView part = body.sliced(m_partBegin, (delimiterPos - m_partBegin)); !part.isEmpty())
         {
-            qWarning() << Q_FUNC_INFO << "multipart empty";
-            return false;
+            if (!parseFormData(part))
+                return false;
+            ++m_partCount;
         }
 
-        // remove the ending delimiter
-        const QByteArray endDelimiter = QByteArray("--") + delimiter + QByteArray("--") + CRLF;
-        multipart.push_back(viewWithoutEndingWith(multipart.takeLast(), endDelimiter));
+        m_partBegin = delimiterPos + m_dashDelimiter.size();
+        m_partScanPos = m_partBegin;
+    }
 
-        return std::all_of(multipart.cbegin(), multipart.cend(), [this](const QByteArrayView &part)
-        {
-            return this->parseFormData(part);
-        });
+    if (!isComplete)
+    {
+        // the delimiter may be split between the current and the next chunk of data
+        m_partScanPos = std::max(m_partBegin, (body.size() - m_dashDelimiter.size() + 1));
+        return true;
     }
 
-    qWarning() << Q_FUNC_INFO << "unknown content type:" << contentType;
-    return false;
+    const QByteArrayView lastPart = body.sliced(m_partBegin);
+    if (lastPart.isEmpty())
+    {
+        if (m_partCount > 0)
+            return true;
+
+        qWarning() << Q_FUNC_INFO << "multipart empty";
+        return false;
+    }
+
+    // remove the ending delimiter
+    return parseFormData(viewWithoutEndingWith(lastPart, m_endDelimiter));
 }
 
 bool RequestParser::parseFormData(const QByteArrayView data)
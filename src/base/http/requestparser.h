@@ -34,6 +34,8 @@
 
 namespace Http
 {
+    // Parses requests incrementally, so the bytes that were already scanned
+    // are not processed again when more data of the same request arrives
     class RequestParser
     {
     public:
@@ -53,20 +55,49 @@ namespace Http
             long frameSize = 0;  // http request frame size (bytes)
         };
 
-        static ParseResult parse(const QByteArray &data);
+        RequestParser() = default;
+
+        // `data` must begin with the same bytes that were passed to the previous call
+        // until it returns anything other than `ParseStatus::Incomplete`,
+        // then the parser is reset and ready for the next request
+        ParseResult parse(const QByteArray &data);
+        void reset();
 
         static const long MAX_CONTENT_SIZE = 64 * 1024 * 1024;  // 64 MB
 
     private:
-        RequestParser() = default;
+        enum class State
+        {
+            Headers,
+            Body
+        };
 
-        ParseResult doParse(QByteArrayView data);
+        ParseResult parseHeaders(QByteArrayView data);
+        ParseResult parseBody(QByteArrayView data);
+        ParseResult finish(ParseStatus status, long frameSize = 0);
         bool parseStartLines(QStringView data);
         bool parseRequestLine(const QString &line);
 
+        bool initMultipart();
+        bool parseMultipart(QByteArrayView body, bool isComplete);
         bool parsePostMessage(QByteArrayView data);
         bool parseFormData(QByteArrayView data);
 
+        State m_state = State::Headers;
+        // position to continue searching for the end of the headers from
+        qsizetype m_headersScanPos = 0;
+        qsizetype m_headersLength = 0;
+        qsizetype m_contentLength = 0;
+
+        // multipart/form-data body is parsed part by part as it arrives,
+        // positions are relative to the beginning of the body
+        bool m_isMultipart = false;
+        QByteArray m_dashDelimiter;
+        QByteArray m_endDelimiter;
+        qsizetype m_partBegin = 0;
+        qsizetype m_partScanPos = 0;
+        int m_partCount = 0;
+
         Request m_request;
     };
 }
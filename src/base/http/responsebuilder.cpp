@@ -28,6 +28,10 @@
 
 #include "responsebuilder.h"
 
+#include <utility>
+
+#include "eventstream.h"
+
 using namespace Http;
 
 void ResponseBuilder::status(const uint code, const QString &text)
@@ -50,6 +54,28 @@ void ResponseBuilder::print(const QByteArray &data, const QString &type)
     print_impl(data, type);
 }
 
+void ResponseBuilder::printEncoded(const QByteArray &data, const QString &type, const QString &contentEncoding)
+{
+    print_impl(data, type);
+    m_response.isCompressionAllowed = false;
+    if (!contentEncoding.isEmpty())
+        m_response.headers[HEADER_CONTENT_ENCODING] = contentEncoding;
+}
+
+void ResponseBuilder::printGenerated(std::function<QByteArray ()> generator, const QString &type)
+{
+    print_impl({}, type);
+    m_response.contentGenerator = std::move(generator);
+}
+
+void ResponseBuilder::setEventStream(EventStream *eventStream)
+{
+    m_response.eventStream = eventStream;
+    m_response.headers[HEADER_CONTENT_TYPE] = CONTENT_TYPE_EVENT_STREAM;
+    m_response.headers[HEADER_CACHE_CONTROL] = u"no-cache"_s;
+    m_response.content.clear();
+}
+
 void ResponseBuilder::clear()
 {
     m_response = Response();
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include <QString>
 
 #include "base/global.h"
@@ -42,6 +44,11 @@ namespace Http
         void setHeader(const Header &header);
         void print(const QString &text, const QString &type = CONTENT_TYPE_HTML);
         void print(const QByteArray &data, const QString &type = CONTENT_TYPE_HTML);
+        // the data is sent as is, encoded with the given content coding (if any)
+        void printEncoded(const QByteArray &data, const QString &type, const QString &contentEncoding = {});
+        // the data is produced by the generator once the response is handed over to the connection
+        void printGenerated(std::function<QByteArray ()> generator, const QString &type);
+        void setEventStream(EventStream *eventStream);
         void clear();
 
         Response response() const;
@@ -29,18 +29,67 @@
 
 #include "responsegenerator.h"
 
+#include <atomic>
+
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QStringView>
 
+#include "base/http/eventstream.h"
 #include "base/http/types.h"
 #include "base/utils/gzip.h"
 
-QByteArray Http::toByteArray(Response response)
+#ifdef QBT_USES_BROTLI
+#include "base/utils/brotli.h"
+#endif
+
+#ifdef QBT_USES_ZSTD
+#include "base/utils/zstd.h"
+#endif
+
+namespace
 {
-    compressContent(response);
+    // "Content-Encoding: gzip\r\n" is 24 bytes long
+    const qsizetype CONTENT_ENCODING_HEADER_SIZE = 24;
 
-    response.headers[HEADER_DATE] = httpDate();
-    if (QString &value = response.headers[HEADER_CONTENT_LENGTH]; value.isEmpty())
-        value = QString::number(response.content.length());
+    std::atomic<qint64> compressionCount = 0;
+    std::atomic<qint64> compressionTime = 0;
+
+    QByteArray compressData(const QByteArray &data, const QString &encoding, const Http::CompressionLevel level, bool *ok)
+    {
+        using namespace Http;
+
+        const bool isBestLevel = (level == CompressionLevel::Best);
+
+#ifdef QBT_USES_ZSTD
+        if (encoding == CONTENT_ENCODING_ZSTD)
+            return Utils::Zstd::compress(data, (isBestLevel ? 19 : 3), ok);
+#endif
+#ifdef QBT_USES_BROTLI
+        if (encoding == CONTENT_ENCODING_BROTLI)
+            return Utils::Brotli::compress(data, (isBestLevel ? 11 : 5), ok);
+#endif
+        if (encoding == CONTENT_ENCODING_GZIP)
+            return Utils::Gzip::compress(data, (isBestLevel ? 9 : 6), ok);
+
+        if (ok)
+            *ok = false;
+        return {};
+    }
+}
+
+QByteArray Http::toByteArray(const Response &response)
+{
+    HeaderMap headers = response.headers;
+    headers[HEADER_DATE] = httpDate();
+    // the length of the event stream is unknown, it lasts until the connection is closed
+    if (!response.eventStream)
+    {
+        if (QString &value = headers[HEADER_CONTENT_LENGTH]; value.isEmpty())
+            value = QString::number(response.content.length());
+    }
 
     QByteArray buf;
     buf.reserve(1024 + response.content.length());
@@ -53,7 +102,7 @@ QByteArray Http::toByteArray(Response response)
         .append(CRLF);
 
     // Header Fields
-    for (auto i = response.headers.constBegin(); i != response.headers.constEnd(); ++i)
+    for (auto i = headers.constBegin(); i != headers.constEnd(); ++i)
     {
         buf.append(i.key().toLatin1())
             .append(": ")
@@ -79,33 +128,118 @@ QString Http::httpDate()
         .append(u" GMT");
 }
 
-void Http::compressContent(Response &response)
+QString Http::selectContentEncoding(const QStringView acceptEncoding)
 {
-    if (response.headers.value(HEADER_CONTENT_ENCODING) != u"gzip")
-        return;
+    // [rfc9110] 12.5.3. Accept-Encoding
+
+    // in the order of preference when the client accepts them equally
+    const QString supportedEncodings[] =
+    {
+#ifdef QBT_USES_ZSTD
+        CONTENT_ENCODING_ZSTD,
+#endif
+#ifdef QBT_USES_BROTLI
+        CONTENT_ENCODING_BROTLI,
+#endif
+        CONTENT_ENCODING_GZIP
+    };
+
+    QHash<QString, double> qvalues;
+    double wildcardQvalue = 0;
+    for (const QStringView item : acceptEncoding.split(u',', Qt::SkipEmptyParts))
+    {
+        const QList<QStringView> params = item.split(u';');
+        const QString coding = params.first().trimmed().toString().toLower();
+
+        // [rfc9110] 12.4.2. Quality Values
+        double qvalue = 1;
+        for (qsizetype i = 1; i < params.size(); ++i)
+        {
+            const QStringView param = params[i].trimmed();
+            if (param.startsWith(u"q=", Qt::CaseInsensitive))
+            {
+                bool ok = false;
+                qvalue = param.sliced(2).toDouble(&ok);
+                if (!ok)
+                    qvalue = 0;
+            }
+        }
+
+        if (coding == u"*")
+            wildcardQvalue = qvalue;
+        else
+            qvalues[coding] = qvalue;
+    }
 
-    response.headers.remove(HEADER_CONTENT_ENCODING);
+    QString selectedEncoding;
+    double selectedQvalue = 0;
+    for (const QString &encoding : supportedEncodings)
+    {
+        const double qvalue = qvalues.value(encoding, wildcardQvalue);
+        if (qvalue > selectedQvalue)
+        {
+            selectedEncoding = encoding;
+            selectedQvalue = qvalue;
+        }
+    }
+
+    return selectedEncoding;
+}
 
+bool Http::isCompressible(const QString &contentType, const qsizetype contentSize)
+{
     // for very small files, compressing them only wastes cpu cycles
-    const int contentSize = response.content.size();
     if (contentSize <= 1024)  // 1 kb
-        return;
+        return false;
 
     // filter out known hard-to-compress types
-    const QString contentType = response.headers[HEADER_CONTENT_TYPE];
     if ((contentType == CONTENT_TYPE_GIF) || (contentType == CONTENT_TYPE_PNG))
+        return false;
+
+    return true;
+}
+
+bool Http::isCompressionWorthwhile(const qsizetype contentSize, const qsizetype compressedSize)
+{
+    return ((compressedSize + CONTENT_ENCODING_HEADER_SIZE) < contentSize);
+}
+
+QByteArray Http::compress(const QByteArray &data, const QString &encoding, const CompressionLevel level, bool *ok)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QByteArray compressedData = compressData(data, encoding, level, ok);
+
+    compressionCount.fetch_add(1, std::memory_order_relaxed);
+    compressionTime.fetch_add((timer.nsecsElapsed() / 1000), std::memory_order_relaxed);
+    return compressedData;
+}
+
+void Http::compressContent(Response &response, const QString &encoding)
+{
+    if (response.eventStream || !response.isCompressionAllowed || encoding.isEmpty())
+        return;
+
+    const qsizetype contentSize = response.content.size();
+    if (!isCompressible(response.headers.value(HEADER_CONTENT_TYPE), contentSize))
         return;
 
     // try compressing
     bool ok = false;
-    const QByteArray compressedData = Utils::Gzip::compress(response.content, 6, &ok);
+    const QByteArray compressedData = compress(response.content, encoding, CompressionLevel::Fast, &ok);
     if (!ok)
         return;
 
-    // "Content-Encoding: gzip\r\n" is 24 bytes long
-    if ((compressedData.size() + 24) >= contentSize)
+    if (!isCompressionWorthwhile(contentSize, compressedData.size()))
         return;
 
     response.content = compressedData;
-    response.headers[HEADER_CONTENT_ENCODING] = u"gzip"_s;
+    response.headers[HEADER_CONTENT_ENCODING] = encoding;
+}
+
+Http::CompressionStatistics Http::compressionStatistics()
+{
+    return {.count = compressionCount.load(std::memory_order_relaxed)
+        , .totalTime = compressionTime.load(std::memory_order_relaxed)};
 }
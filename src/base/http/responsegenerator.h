@@ -30,14 +30,40 @@
 
 #pragma once
 
+#include <QtTypes>
+
 class QByteArray;
 class QString;
+class QStringView;
 
 namespace Http
 {
     struct Response;
 
-    QByteArray toByteArray(Response response);
+    enum class CompressionLevel
+    {
+        // for the content compressed for each response
+        Fast,
+        // for the content compressed once and then reused
+        Best
+    };
+
+    // accumulated over all the compressions done by the process, from any thread
+    struct CompressionStatistics
+    {
+        qint64 count = 0;
+        qint64 totalTime = 0;  // in microseconds
+    };
+
+    QByteArray toByteArray(const Response &response);
     QString httpDate();
-    void compressContent(Response &response);
+
+    // returns the content coding to be used for the client, or empty string if the content should be sent as is
+    QString selectContentEncoding(QStringView acceptEncoding);
+    bool isCompressible(const QString &contentType, qsizetype contentSize);
+    // the compressed content has to save more than the header announcing its content coding takes
+    bool isCompressionWorthwhile(qsizetype contentSize, qsizetype compressedSize);
+    QByteArray compress(const QByteArray &data, const QString &encoding, CompressionLevel level, bool *ok = nullptr);
+    void compressContent(Response &response, const QString &encoding);
+    CompressionStatistics compressionStatistics();
 }
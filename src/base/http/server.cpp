@@ -31,9 +31,7 @@
 #include "server.h"
 
 #include <algorithm>
-#include <chrono>
-#include <memory>
-#include <new>
+#include <optional>
 
 #include <QtLogging>
 #include <QNetworkProxy>
@@ -41,20 +39,18 @@
 #include <QSslConfiguration>
 #include <QSslSocket>
 #include <QStringList>
-#include <QTimer>
+#include <QTcpSocket>
+#include <QThread>
 
 #include "base/global.h"
 #include "base/utils/net.h"
 #include "base/utils/sslkey.h"
-#include "connection.h"
-
-using namespace std::chrono_literals;
+#include "connectionworker.h"
 
 namespace
 {
-    const int KEEP_ALIVE_DURATION = std::chrono::milliseconds(7s).count();
     const int CONNECTIONS_LIMIT = 500;
-    const std::chrono::seconds CONNECTIONS_SCAN_INTERVAL {2};
+    const int IO_THREADS_COUNT = 2;
 
     QList<QSslCipher> safeCipherList()
     {
@@ -108,63 +104,64 @@ Server::Server(IRequestHandler *requestHandler, QObject *parent)
     sslConf.setCiphers(safeCipherList());
     QSslConfiguration::setDefaultConfiguration(sslConf);
 
-    auto *dropConnectionTimer = new QTimer(this);
-    connect(dropConnectionTimer, &QTimer::timeout, this, &Server::dropTimedOutConnection);
-    dropConnectionTimer->start(CONNECTIONS_SCAN_INTERVAL);
+    // leave the rest of the cores to libtorrent and the GUI
+    m_compressionThreadPool.setMaxThreadCount(std::max(1, (QThread::idealThreadCount() / 2)));
+
+    for (int i = 0; i < IO_THREADS_COUNT; ++i)
+    {
+        auto *ioThread = new QThread(this);
+        auto *worker = new ConnectionWorker(m_requestHandler, this, &m_compressionThreadPool);
+        worker->moveToThread(ioThread);
+        // the connections of the worker are deleted along with it, still in the I/O thread
+        connect(ioThread, &QThread::finished, worker, &QObject::deleteLater);
+        connect(worker, &ConnectionWorker::connectionRemoved, this, [this] { --m_connectionCount; });
+        ioThread->start();
+
+        m_ioThreads.append(ioThread);
+        m_connectionWorkers.append(worker);
+    }
 }
 
-void Server::incomingConnection(const qintptr socketDescriptor)
+Server::~Server()
 {
-    std::unique_ptr<QTcpSocket> serverSocket = m_https ? std::make_unique<QSslSocket>(this) : std::make_unique<QTcpSocket>(this);
-    if (!serverSocket->setSocketDescriptor(socketDescriptor))
-        return;
+    // the connections must be gone before the compression thread pool
+    // and the request handler they use
+    for (QThread *ioThread : asConst(m_ioThreads))
+    {
+        ioThread->quit();
+        ioThread->wait();
+    }
+}
 
-    if (m_connections.size() >= CONNECTIONS_LIMIT)
+void Server::incomingConnection(const qintptr socketDescriptor)
+{
+    if (m_connectionCount >= CONNECTIONS_LIMIT)
     {
         qWarning("Too many connections. Exceeded CONNECTIONS_LIMIT (%d). Connection closed.", CONNECTIONS_LIMIT);
+        // the socket closes the descriptor once it is destroyed
+        QTcpSocket socket;
+        socket.setSocketDescriptor(socketDescriptor);
         return;
     }
 
-    try
+    std::optional<QSslConfiguration> sslConfiguration;
+    if (m_https)
     {
-        if (m_https)
-        {
-            auto *sslSocket = static_cast<QSslSocket *>(serverSocket.get());
-            sslSocket->setProtocol(QSsl::SecureProtocols);
-            sslSocket->setPrivateKey(m_key);
-            sslSocket->setLocalCertificateChain(m_certificates);
-            sslSocket->setPeerVerifyMode(QSslSocket::VerifyNone);
-            sslSocket->startServerEncryption();
-        }
-
-        auto *connection = new Connection(serverSocket.release(), m_requestHandler, this);
-        m_connections.insert(connection);
-        connect(connection, &Connection::closed, this, [this, connection] { removeConnection(connection); });
-    }
-    catch (const std::bad_alloc &exception)
-    {
-        // drop the connection instead of throwing exception and crash
-        qWarning("Failed to allocate memory for HTTP connection. Connection closed.");
-        return;
+        sslConfiguration = QSslConfiguration::defaultConfiguration();
+        sslConfiguration->setProtocol(QSsl::SecureProtocols);
+        sslConfiguration->setPrivateKey(m_key);
+        sslConfiguration->setLocalCertificateChain(m_certificates);
+        sslConfiguration->setPeerVerifyMode(QSslSocket::VerifyNone);
     }
-}
 
-void Server::removeConnection(Connection *connection)
-{
-    m_connections.remove(connection);
-    connection->deleteLater();
-}
+    ConnectionWorker *worker = m_connectionWorkers[m_nextConnectionWorker];
+    m_nextConnectionWorker = (m_nextConnectionWorker + 1) % m_connectionWorkers.size();
+    ++m_connectionCount;
 
-void Server::dropTimedOutConnection()
-{
-    m_connections.removeIf([](Connection *connection)
+    QMetaObject::invokeMethod(worker, [worker, socketDescriptor, sslConfiguration]
     {
-        if (!connection->hasExpired(KEEP_ALIVE_DURATION))
-            return false;
-
-        connection->deleteLater();
-        return true;
-    });
+        worker->addConnection(socketDescriptor, sslConfiguration);
+    }, Qt::QueuedConnection);
 }
 
 bool Server::setupHttps(const QByteArray &certificates, const QByteArray &privateKey)
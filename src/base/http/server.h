@@ -30,15 +30,18 @@
 
 #pragma once
 
-#include <QSet>
+#include <QList>
 #include <QSslCertificate>
 #include <QSslKey>
 #include <QTcpServer>
+#include <QThreadPool>
+
+class QThread;
 
 namespace Http
 {
+    class ConnectionWorker;
     class IRequestHandler;
-    class Connection;
 
     class Server final : public QTcpServer
     {
@@ -47,20 +50,23 @@ namespace Http
 
     public:
         explicit Server(IRequestHandler *requestHandler, QObject *parent = nullptr);
+        ~Server() override;
 
         bool setupHttps(const QByteArray &certificates, const QByteArray &privateKey);
         void disableHttps();
         bool isHttps() const;
 
-    private slots:
-        void dropTimedOutConnection();
-
     private:
         void incomingConnection(qintptr socketDescriptor) override;
-        void removeConnection(Connection *connection);
 
         IRequestHandler *m_requestHandler = nullptr;
-        QSet<Connection *> m_connections;  // for tracking persistent connections
+        // the connections are accepted here and handed over to the workers in the I/O threads
+        QList<QThread *> m_ioThreads;
+        QList<ConnectionWorker *> m_connectionWorkers;
+        qsizetype m_nextConnectionWorker = 0;
+        int m_connectionCount = 0;
+        // compresses large responses, so neither the server thread nor the I/O threads are blocked by it
+        QThreadPool m_compressionThreadPool;
 
         bool m_https = false;
         QList<QSslCertificate> m_certificates;
@@ -29,17 +29,24 @@
 
 #pragma once
 
+#include <functional>
+
 #include <QHostAddress>
 #include <QList>
+#include <QPointer>
 #include <QString>
 
 #include "base/global.h"
 
 namespace Http
 {
+    class EventStream;
+
     inline const QString METHOD_GET = u"GET"_s;
     inline const QString METHOD_POST = u"POST"_s;
 
+    inline const QString HEADER_ACCEPT = u"accept"_s;
+    inline const QString HEADER_ACCEPT_ENCODING = u"accept-encoding"_s;
     inline const QString HEADER_CACHE_CONTROL = u"cache-control"_s;
     inline const QString HEADER_CONNECTION = u"connection"_s;
     inline const QString HEADER_CONTENT_DISPOSITION = u"content-disposition"_s;
@@ -49,11 +56,14 @@ namespace Http
     inline const QString HEADER_CONTENT_TYPE = u"content-type"_s;
     inline const QString HEADER_CROSS_ORIGIN_OPENER_POLICY  = u"cross-origin-opener-policy"_s;
     inline const QString HEADER_DATE = u"date"_s;
+    inline const QString HEADER_ETAG = u"etag"_s;
     inline const QString HEADER_HOST = u"host"_s;
+    inline const QString HEADER_IF_NONE_MATCH = u"if-none-match"_s;
     inline const QString HEADER_ORIGIN = u"origin"_s;
     inline const QString HEADER_REFERER = u"referer"_s;
     inline const QString HEADER_REFERRER_POLICY = u"referrer-policy"_s;
     inline const QString HEADER_SET_COOKIE = u"set-cookie"_s;
+    inline const QString HEADER_VARY = u"vary"_s;
     inline const QString HEADER_X_CONTENT_TYPE_OPTIONS = u"x-content-type-options"_s;
     inline const QString HEADER_X_FORWARDED_FOR = u"x-forwarded-for"_s;
     inline const QString HEADER_X_FORWARDED_HOST = u"x-forwarded-host"_s;
@@ -69,10 +79,16 @@ namespace Http
     inline const QString CONTENT_TYPE_TXT = u"text/plain; charset=UTF-8"_s;
     inline const QString CONTENT_TYPE_JS = u"application/javascript"_s;
     inline const QString CONTENT_TYPE_JSON = u"application/json"_s;
+    inline const QString CONTENT_TYPE_CBOR = u"application/cbor"_s;
     inline const QString CONTENT_TYPE_GIF = u"image/gif"_s;
     inline const QString CONTENT_TYPE_PNG = u"image/png"_s;
     inline const QString CONTENT_TYPE_FORM_ENCODED = u"application/x-www-form-urlencoded"_s;
     inline const QString CONTENT_TYPE_FORM_DATA = u"multipart/form-data"_s;
+    inline const QString CONTENT_TYPE_EVENT_STREAM = u"text/event-stream"_s;
+
+    inline const QString CONTENT_ENCODING_BROTLI = u"br"_s;
+    inline const QString CONTENT_ENCODING_GZIP = u"gzip"_s;
+    inline const QString CONTENT_ENCODING_ZSTD = u"zstd"_s;
 
     // portability: "\r\n" doesn't guarantee mapping to the correct symbol
     inline const char CRLF[] = {0x0D, 0x0A, '\0'};
@@ -123,6 +139,14 @@ namespace Http
         ResponseStatus status;
         HeaderMap headers;
         QByteArray content;
+        // when set, the connection is kept open to send the events of the stream after the headers
+        QPointer<EventStream> eventStream;
+        // when set, the content is produced by it outside of the server thread, so it must only use
+        // the immutable data it holds
+        std::function<QByteArray ()> contentGenerator;
+        // unset for the content that is already in its final encoding,
+        // otherwise the connection compresses it with an encoding accepted by the client
+        bool isCompressionAllowed = true;
 
         Response(uint code = 200, const QString &text = u"OK"_s)
             : status {code, text}
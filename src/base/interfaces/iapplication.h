@@ -85,6 +85,9 @@ public:
 
     virtual void sendTestEmail() const = 0;
 
+    // Milliseconds since the application was started
+    virtual qint64 elapsedSinceStartup() const = 0;
+
 #ifdef Q_OS_WIN
     virtual MemoryPriority processMemoryPriority() const = 0;
     virtual void setProcessMemoryPriority(MemoryPriority priority) = 0;
@@ -0,0 +1,62 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "brotli.h"
+
+#include <cstdint>
+
+#include <QByteArray>
+
+#include <brotli/encode.h>
+
+QByteArray Utils::Brotli::compress(const QByteArray &data, const int quality, bool *ok)
+{
+    if (ok)
+        *ok = false;
+
+    if (data.isEmpty())
+        return {};
+
+    std::size_t encodedSize = BrotliEncoderMaxCompressedSize(data.size());
+    // it is 0 when the data is too large for the single step compression
+    if (encodedSize == 0)
+        return {};
+
+    QByteArray ret {static_cast<qsizetype>(encodedSize), Qt::Uninitialized};
+    const BROTLI_BOOL result = BrotliEncoderCompress(quality, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_GENERIC
+        , data.size(), reinterpret_cast<const std::uint8_t *>(data.constData())
+        , &encodedSize, reinterpret_cast<std::uint8_t *>(ret.data()));
+    if (result != BROTLI_TRUE)
+        return {};
+
+    ret.truncate(static_cast<qsizetype>(encodedSize));
+
+    if (ok)
+        *ok = true;
+    return ret;
+}
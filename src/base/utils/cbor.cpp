@@ -0,0 +1,245 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "cbor.h"
+
+#include <bit>
+#include <utility>
+
+#include <QtEndian>
+#include <QStringList>
+
+#include "base/global.h"
+#include "variantwriter.h"
+
+namespace
+{
+    // [RFC 8949] 3.1. Major Types
+    const quint8 MAJOR_TYPE_UNSIGNED_INT = 0;
+    const quint8 MAJOR_TYPE_NEGATIVE_INT = 1;
+    const quint8 MAJOR_TYPE_TEXT_STRING = 3;
+    const quint8 MAJOR_TYPE_TAG = 6;
+
+    const char BEGIN_INDEFINITE_ARRAY = '\x9F';
+    const char BEGIN_INDEFINITE_MAP = '\xBF';
+    const char SIMPLE_FALSE = '\xF4';
+    const char SIMPLE_TRUE = '\xF5';
+    const char SIMPLE_NULL = '\xF6';
+    const char FLOAT_32 = '\xFA';
+    const char FLOAT_64 = '\xFB';
+    const char BREAK = '\xFF';
+
+    // http://cbor.schmorp.de/stringref
+    const quint64 TAG_STRINGREF_NAMESPACE = 256;
+    const quint64 TAG_STRINGREF = 25;
+
+    // A string gets an index only if it is longer than the reference to it would be.
+    // The decoder applies the same rule to every string it reads, so all strings must go through it.
+    bool isStringRefCandidate(const qsizetype size, const quint64 nextIndex)
+    {
+        if (nextIndex < 24)
+            return size >= 3;
+        if (nextIndex <= 0xFF)
+            return size >= 4;
+        if (nextIndex <= 0xFFFF)
+            return size >= 5;
+        if (nextIndex <= 0xFFFFFFFF)
+            return size >= 7;
+        return size >= 11;
+    }
+}
+
+Utils::Cbor::Writer::Writer(const qsizetype reserveSize, const bool useStringRefs)
+    : m_useStringRefs {useStringRefs}
+{
+    if (reserveSize > 0)
+        m_data.reserve(reserveSize);
+}
+
+void Utils::Cbor::Writer::beginObject()
+{
+    beginValue();
+    m_data.append(BEGIN_INDEFINITE_MAP);
+}
+
+void Utils::Cbor::Writer::endObject()
+{
+    m_data.append(BREAK);
+}
+
+void Utils::Cbor::Writer::beginArray()
+{
+    beginValue();
+    m_data.append(BEGIN_INDEFINITE_ARRAY);
+}
+
+void Utils::Cbor::Writer::endArray()
+{
+    m_data.append(BREAK);
+}
+
+void Utils::Cbor::Writer::writeKey(const QStringView key)
+{
+    // keys are just the values at even positions of the map
+    writeString(key);
+}
+
+void Utils::Cbor::Writer::writeNull()
+{
+    beginValue();
+    m_data.append(SIMPLE_NULL);
+}
+
+void Utils::Cbor::Writer::writeBool(const bool value)
+{
+    beginValue();
+    m_data.append(value ? SIMPLE_TRUE : SIMPLE_FALSE);
+}
+
+void Utils::Cbor::Writer::writeInt(const qint64 value)
+{
+    beginValue();
+    if (value >= 0)
+        appendHead(MAJOR_TYPE_UNSIGNED_INT, static_cast<quint64>(value));
+    else
+        appendHead(MAJOR_TYPE_NEGATIVE_INT, static_cast<quint64>(-(value + 1)));
+}
+
+void Utils::Cbor::Writer::writeUInt(const quint64 value)
+{
+    beginValue();
+    appendHead(MAJOR_TYPE_UNSIGNED_INT, value);
+}
+
+void Utils::Cbor::Writer::writeDouble(const double value)
+{
+    beginValue();
+
+    // most of the values (i.e. progress, ratio) lose nothing in single precision
+    if (const auto floatValue = static_cast<float>(value); floatValue == value)
+    {
+        char buffer[sizeof(quint32)];
+        qToBigEndian(std::bit_cast<quint32>(floatValue), buffer);
+        m_data.append(FLOAT_32).append(buffer, sizeof(buffer));
+    }
+    else
+    {
+        char buffer[sizeof(quint64)];
+        qToBigEndian(std::bit_cast<quint64>(value), buffer);
+        m_data.append(FLOAT_64).append(buffer, sizeof(buffer));
+    }
+}
+
+void Utils::Cbor::Writer::writeString(const QStringView value)
+{
+    beginValue();
+
+    const QByteArray utf8 = value.toUtf8();
+    if (m_useStringRefs)
+    {
+        if (const auto iter = m_stringRefs.constFind(utf8); iter != m_stringRefs.cend())
+        {
+            appendHead(MAJOR_TYPE_TAG, TAG_STRINGREF);
+            appendHead(MAJOR_TYPE_UNSIGNED_INT, iter.value());
+            return;
+        }
+
+        const auto nextIndex = static_cast<quint64>(m_stringRefs.size());
+        if (isStringRefCandidate(utf8.size(), nextIndex))
+            m_stringRefs.insert(utf8, nextIndex);
+    }
+
+    appendHead(MAJOR_TYPE_TEXT_STRING, static_cast<quint64>(utf8.size()));
+    m_data.append(utf8);
+}
+
+void Utils::Cbor::Writer::writeStringList(const QStringList &value)
+{
+    beginArray();
+    for (const QString &str : value)
+        writeString(str);
+    endArray();
+}
+
+void Utils::Cbor::Writer::writeVariant(const QVariant &value)
+{
+    Utils::writeVariant(*this, value);
+}
+
+const QByteArray &Utils::Cbor::Writer::data() const
+{
+    return m_data;
+}
+
+QByteArray Utils::Cbor::Writer::takeData()
+{
+    m_stringRefs.clear();
+    m_isNamespaceStarted = false;
+    return std::exchange(m_data, {});
+}
+
+void Utils::Cbor::Writer::beginValue()
+{
+    if (!m_useStringRefs || m_isNamespaceStarted)
+        return;
+
+    appendHead(MAJOR_TYPE_TAG, TAG_STRINGREF_NAMESPACE);
+    m_isNamespaceStarted = true;
+}
+
+void Utils::Cbor::Writer::appendHead(const quint8 majorType, const quint64 argument)
+{
+    // [RFC 8949] 3. Specification of the CBOR Encoding
+    const auto initialByte = static_cast<char>(majorType << 5);
+    if (argument < 24)
+    {
+        m_data.append(static_cast<char>(initialByte | argument));
+    }
+    else if (argument <= 0xFF)
+    {
+        m_data.append(static_cast<char>(initialByte | 24)).append(static_cast<char>(argument));
+    }
+    else if (argument <= 0xFFFF)
+    {
+        char buffer[sizeof(quint16)];
+        qToBigEndian(static_cast<quint16>(argument), buffer);
+        m_data.append(static_cast<char>(initialByte | 25)).append(buffer, sizeof(buffer));
+    }
+    else if (argument <= 0xFFFFFFFF)
+    {
+        char buffer[sizeof(quint32)];
+        qToBigEndian(static_cast<quint32>(argument), buffer);
+        m_data.append(static_cast<char>(initialByte | 26)).append(buffer, sizeof(buffer));
+    }
+    else
+    {
+        char buffer[sizeof(quint64)];
+        qToBigEndian(argument, buffer);
+        m_data.append(static_cast<char>(initialByte | 27)).append(buffer, sizeof(buffer));
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QStringView>
+#include <QtContainerFwd>
+
+class QVariant;
+
+namespace Utils::Cbor
+{
+    // Writes CBOR [RFC 8949] directly into the buffer as the values are passed in,
+    // it has the same interface as Utils::Json::Writer so that the same code can produce both.
+    // Maps and arrays are written with indefinite length, so their sizes don't need to be known up front.
+    // If string references are used, the document is enclosed in a string reference namespace (tag 256),
+    // so repeated strings (i.e. the keys of the objects in a list) are written only once and then referred
+    // to by index. It is an extension that isn't supported by many decoders, so it has to be requested.
+    class Writer
+    {
+    public:
+        explicit Writer(qsizetype reserveSize = 0, bool useStringRefs = false);
+
+        void beginObject();
+        void endObject();
+        void beginArray();
+        void endArray();
+
+        void writeKey(QStringView key);
+
+        void writeNull();
+        void writeBool(bool value);
+        void writeInt(qint64 value);
+        void writeUInt(quint64 value);
+        void writeDouble(double value);
+        void writeString(QStringView value);
+        void writeStringList(const QStringList &value);
+        void writeVariant(const QVariant &value);
+
+        const QByteArray &data() const;
+        QByteArray takeData();
+
+    private:
+        void beginValue();
+        void appendHead(quint8 majorType, quint64 argument);
+
+        QByteArray m_data;
+        bool m_useStringRefs = false;
+        QHash<QByteArray, quint64> m_stringRefs;
+        bool m_isNamespaceStarted = false;
+    };
+}
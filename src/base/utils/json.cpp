@@ -0,0 +1,219 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "json.h"
+
+#include <cmath>
+#include <utility>
+
+#include <QLocale>
+#include <QStringList>
+
+#include "base/global.h"
+#include "variantwriter.h"
+
+namespace
+{
+    const char HEX_DIGITS[] = "0123456789abcdef";
+
+    void appendEscaped(QByteArray &out, const QStringView str)
+    {
+        // [RFC 8259] 7. Strings
+        out.append('"');
+
+        qsizetype runBegin = 0;
+        for (qsizetype i = 0; i < str.size(); ++i)
+        {
+            const char16_t c = str[i].unicode();
+            if (c >= 0x80)
+                continue;
+
+            if ((c >= 0x20) && (c != u'"') && (c != u'\\'))
+                continue;
+
+            // flush preceding characters that don't need to be escaped
+            if (i > runBegin)
+                out.append(str.sliced(runBegin, (i - runBegin)).toUtf8());
+            runBegin = i + 1;
+
+            switch (c)
+            {
+            case u'"':
+                out.append("\\\"");
+                break;
+            case u'\\':
+                out.append("\\\\");
+                break;
+            case u'\b':
+                out.append("\\b");
+                break;
+            case u'\f':
+                out.append("\\f");
+                break;
+            case u'\n':
+                out.append("\\n");
+                break;
+            case u'\r':
+                out.append("\\r");
+                break;
+            case u'\t':
+                out.append("\\t");
+                break;
+            default:
+                out.append("\\u00").append(HEX_DIGITS[c >> 4]).append(HEX_DIGITS[c & 0xF]);
+                break;
+            }
+        }
+
+        if (str.size() > runBegin)
+            out.append(str.sliced(runBegin).toUtf8());
+
+        out.append('"');
+    }
+}
+
+Utils::Json::Writer::Writer(const qsizetype reserveSize)
+{
+    if (reserveSize > 0)
+        m_data.reserve(reserveSize);
+}
+
+void Utils::Json::Writer::beginObject()
+{
+    beginValue();
+    m_data.append('{');
+    m_needsSeparator = false;
+}
+
+void Utils::Json::Writer::endObject()
+{
+    m_data.append('}');
+    m_needsSeparator = true;
+}
+
+void Utils::Json::Writer::beginArray()
+{
+    beginValue();
+    m_data.append('[');
+    m_needsSeparator = false;
+}
+
+void Utils::Json::Writer::endArray()
+{
+    m_data.append(']');
+    m_needsSeparator = true;
+}
+
+void Utils::Json::Writer::writeKey(const QStringView key)
+{
+    beginValue();
+    appendEscaped(m_data, key);
+    m_data.append(':');
+    // the value follows the key without a separator
+    m_needsSeparator = false;
+}
+
+void Utils::Json::Writer::writeNull()
+{
+    beginValue();
+    m_data.append("null");
+}
+
+void Utils::Json::Writer::writeBool(const bool value)
+{
+    beginValue();
+    m_data.append(value ? "true" : "false");
+}
+
+void Utils::Json::Writer::writeInt(const qint64 value)
+{
+    beginValue();
+    m_data.append(QByteArray::number(value));
+}
+
+void Utils::Json::Writer::writeUInt(const quint64 value)
+{
+    beginValue();
+    m_data.append(QByteArray::number(value));
+}
+
+void Utils::Json::Writer::writeDouble(const double value)
+{
+    // JSON has no representation for them, QJsonDocument writes them as null too
+    if (!std::isfinite(value))
+    {
+        writeNull();
+        return;
+    }
+
+    beginValue();
+    m_data.append(QByteArray::number(value, 'g', QLocale::FloatingPointShortest));
+}
+
+void Utils::Json::Writer::writeString(const QStringView value)
+{
+    beginValue();
+    appendEscaped(m_data, value);
+}
+
+void Utils::Json::Writer::writeStringList(const QStringList &value)
+{
+    beginArray();
+    for (const QString &str : value)
+        writeString(str);
+    endArray();
+}
+
+void Utils::Json::Writer::writeVariant(const QVariant &value)
+{
+    Utils::writeVariant(*this, value);
+}
+
+void Utils::Json::Writer::writeRaw(const QByteArrayView value)
+{
+    beginValue();
+    m_data.append(value);
+}
+
+const QByteArray &Utils::Json::Writer::data() const
+{
+    return m_data;
+}
+
+QByteArray Utils::Json::Writer::takeData()
+{
+    m_needsSeparator = false;
+    return std::exchange(m_data, {});
+}
+
+void Utils::Json::Writer::beginValue()
+{
+    if (m_needsSeparator)
+        m_data.append(',');
+    m_needsSeparator = true;
+}
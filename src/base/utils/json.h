@@ -0,0 +1,75 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QStringView>
+#include <QtContainerFwd>
+
+class QVariant;
+
+namespace Utils::Json
+{
+    // Writes compact JSON directly into the buffer as the values are passed in,
+    // so large documents don't need to be built as QJsonObject/QVariant trees first.
+    // The caller is responsible for the calls to make up a well-formed document.
+    class Writer
+    {
+    public:
+        explicit Writer(qsizetype reserveSize = 0);
+
+        void beginObject();
+        void endObject();
+        void beginArray();
+        void endArray();
+
+        void writeKey(QStringView key);
+
+        void writeNull();
+        void writeBool(bool value);
+        void writeInt(qint64 value);
+        void writeUInt(quint64 value);
+        void writeDouble(double value);
+        void writeString(QStringView value);
+        void writeStringList(const QStringList &value);
+        void writeVariant(const QVariant &value);
+        // writes already encoded JSON value as is
+        void writeRaw(QByteArrayView value);
+
+        const QByteArray &data() const;
+        QByteArray takeData();
+
+    private:
+        void beginValue();
+
+        QByteArray m_data;
+        bool m_needsSeparator = false;
+    };
+}
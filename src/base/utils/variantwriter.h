@@ -0,0 +1,112 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QVariant>
+#include <QVariantHash>
+#include <QVariantList>
+#include <QVariantMap>
+
+namespace Utils
+{
+    // Writes the variant with one of the streaming writers (i.e. Utils::Json::Writer, Utils::Cbor::Writer),
+    // the types that neither of them has the representation for are written as strings if possible
+    template <typename Writer>
+    void writeVariant(Writer &writer, const QVariant &value)
+    {
+        switch (value.userType())
+        {
+        case QMetaType::Bool:
+            writer.writeBool(value.toBool());
+            break;
+        case QMetaType::Int:
+        case QMetaType::Long:
+        case QMetaType::LongLong:
+        case QMetaType::Short:
+            writer.writeInt(value.toLongLong());
+            break;
+        // they don't fit in qint64 above INT64_MAX
+        case QMetaType::UInt:
+        case QMetaType::ULong:
+        case QMetaType::ULongLong:
+        case QMetaType::UShort:
+            writer.writeUInt(value.toULongLong());
+            break;
+        case QMetaType::Float:
+        case QMetaType::Double:
+            writer.writeDouble(value.toDouble());
+            break;
+        case QMetaType::QString:
+            writer.writeString(value.toString());
+            break;
+        case QMetaType::QStringList:
+            writer.writeStringList(value.toStringList());
+            break;
+        case QMetaType::QVariantList:
+            {
+                const QVariantList list = value.toList();
+                writer.beginArray();
+                for (const QVariant &item : list)
+                    writeVariant(writer, item);
+                writer.endArray();
+            }
+            break;
+        case QMetaType::QVariantMap:
+            {
+                const QVariantMap map = value.toMap();
+                writer.beginObject();
+                for (auto it = map.cbegin(); it != map.cend(); ++it)
+                {
+                    writer.writeKey(it.key());
+                    writeVariant(writer, it.value());
+                }
+                writer.endObject();
+            }
+            break;
+        case QMetaType::QVariantHash:
+            {
+                const QVariantHash hash = value.toHash();
+                writer.beginObject();
+                for (auto it = hash.cbegin(); it != hash.cend(); ++it)
+                {
+                    writer.writeKey(it.key());
+                    writeVariant(writer, it.value());
+                }
+                writer.endObject();
+            }
+            break;
+        default:
+            if (value.isNull() || !value.canConvert<QString>())
+                writer.writeNull();
+            else
+                writer.writeString(value.toString());
+            break;
+        }
+    }
+}
@@ -108,6 +108,7 @@ namespace
         PYTHON_EXECUTABLE_PATH,
         START_SESSION_PAUSED,
         SESSION_SHUTDOWN_TIMEOUT,
+        METADATA_CACHE_SIZE,
 
         // libtorrent section
         LIBTORRENT_HEADER,
@@ -123,6 +124,9 @@ namespace
         // cache
         DISK_CACHE,
         DISK_CACHE_TTL,
+#else
+        READ_CACHE,
+        FAST_RECHECK,
 #endif
         DISK_QUEUE_SIZE,
 #ifdef QBT_USES_LIBTORRENT2
@@ -229,6 +233,11 @@ void AdvancedSettings::saveAdvancedSettings() const
     // Disk write cache
     session->setDiskCacheSize(m_spinBoxCache.value());
     session->setDiskCacheTTL(m_spinBoxCacheTTL.value());
+#else
+    // Read cache
+    session->setReadCacheSize(m_spinBoxReadCache.value());
+    // Fast recheck
+    session->setFastRecheckEnabled(m_checkBoxFastRecheck.isChecked());
 #endif
     // Disk queue size
     session->setDiskQueueSize(m_spinBoxDiskQueueSize.value() * 1024);
@@ -338,6 +347,8 @@ void AdvancedSettings::saveAdvancedSettings() const
     session->setStartPaused(m_checkBoxStartSessionPaused.isChecked());
     // Session shutdown timeout
     session->setShutdownTimeout(m_spinBoxSessionShutdownTimeout.value());
+    // Metadata cache size
+    session->setMetadataCacheSize(m_spinBoxMetadataCacheSize.value());
     // Choking algorithm
     session->setChokingAlgorithm(m_comboBoxChokingAlgorithm.currentData().value<BitTorrent::ChokingAlgorithm>());
     // Seed choking algorithm
@@ -522,9 +533,10 @@ void AdvancedSettings::loadAdvancedSettings()
 
 #ifdef QBT_USES_LIBTORRENT2
     // Hashing threads
-    m_spinBoxHashingThreads.setMinimum(1);
+    m_spinBoxHashingThreads.setMinimum(0);
     m_spinBoxHashingThreads.setMaximum(1024);
     m_spinBoxHashingThreads.setValue(session->hashingThreads());
+    m_spinBoxHashingThreads.setSpecialValueText(tr("0 (number of CPU cores)"));
     addRow(HASHING_THREADS, (tr("Hashing threads") + u' ' + makeLink(u"https://www.libtorrent.org/reference-Settings.html#hashing_threads", u"(?)"))
             , &m_spinBoxHashingThreads);
 #endif
@@ -572,6 +584,23 @@ void AdvancedSettings::loadAdvancedSettings()
     m_spinBoxCacheTTL.setSuffix(tr(" s", " seconds"));
     addRow(DISK_CACHE_TTL, (tr("Disk cache expiry interval") + u' ' + makeLink(u"https://www.libtorrent.org/reference-Settings.html#cache_expiry", u"(?)"))
             , &m_spinBoxCacheTTL);
+#else
+    // Read cache
+    m_spinBoxReadCache.setMinimum(0);
+#ifdef QBT_APP_64BIT
+    m_spinBoxReadCache.setMaximum(33554431);  // 32768GiB
+#else
+    m_spinBoxReadCache.setMaximum(1536);
+#endif
+    m_spinBoxReadCache.setValue(session->readCacheSize());
+    m_spinBoxReadCache.setSpecialValueText(tr("Disabled"));
+    m_spinBoxReadCache.setSuffix(tr(" MiB"));
+    addRow(READ_CACHE, tr("Read cache for seeding"), &m_spinBoxReadCache);
+    // Fast recheck
+    m_checkBoxFastRecheck.setToolTip(tr("Files that were not modified since they were verified are not read again when torrent is rechecked."
+            " Only file size and modification time are compared, so changes that preserve them are not detected."));
+    m_checkBoxFastRecheck.setChecked(session->isFastRecheckEnabled());
+    addRow(FAST_RECHECK, tr("Skip unchanged files when rechecking torrents"), &m_checkBoxFastRecheck);
 #endif
     // Disk queue size
     m_spinBoxDiskQueueSize.setMinimum(1);
@@ -585,6 +614,9 @@ void AdvancedSettings::loadAdvancedSettings()
     m_comboBoxDiskIOType.addItem(tr("Default"), QVariant::fromValue(BitTorrent::DiskIOType::Default));
     m_comboBoxDiskIOType.addItem(tr("Memory mapped files"), QVariant::fromValue(BitTorrent::DiskIOType::MMap));
     m_comboBoxDiskIOType.addItem(tr("POSIX-compliant"), QVariant::fromValue(BitTorrent::DiskIOType::Posix));
+#ifdef QBT_USES_IO_URING
+    m_comboBoxDiskIOType.addItem(tr("io_uring reads"), QVariant::fromValue(BitTorrent::DiskIOType::IOUring));
+#endif
     m_comboBoxDiskIOType.setCurrentIndex(m_comboBoxDiskIOType.findData(QVariant::fromValue(session->diskIOType())));
     addRow(DISK_IO_TYPE, tr("Disk IO type (requires restart)") + u' ' + makeLink(u"https://www.libtorrent.org/single-page-ref.html#default-disk-io-constructor", u"(?)")
            , &m_comboBoxDiskIOType);
@@ -868,6 +900,14 @@ void AdvancedSettings::loadAdvancedSettings()
     m_spinBoxSessionShutdownTimeout.setSpecialValueText(tr("-1 (unlimited)"));
     m_spinBoxSessionShutdownTimeout.setToolTip(u"Sets the timeout for the session to be shut down gracefully, at which point it will be forcibly terminated.<br>Note that this does not apply to the saving resume data time."_s);
     addRow(SESSION_SHUTDOWN_TIMEOUT, tr("BitTorrent session shutdown timeout [-1: unlimited]"), &m_spinBoxSessionShutdownTimeout);
+    // Metadata cache size
+    m_spinBoxMetadataCacheSize.setMinimum(0);
+    m_spinBoxMetadataCacheSize.setMaximum(std::numeric_limits<int>::max());
+    m_spinBoxMetadataCacheSize.setValue(session->metadataCacheSize());
+    m_spinBoxMetadataCacheSize.setSuffix(tr(" MiB"));
+    m_spinBoxMetadataCacheSize.setSpecialValueText(tr("0 (disabled)"));
+    m_spinBoxMetadataCacheSize.setToolTip(tr("Keeps metadata of torrents added by magnet links so it doesn't need to be downloaded again when the same torrent is added later."));
+    addRow(METADATA_CACHE_SIZE, tr("Magnet link metadata cache size"), &m_spinBoxMetadataCacheSize);
 
     // Choking algorithm
     m_comboBoxChokingAlgorithm.addItem(tr("Fixed slots"), QVariant::fromValue(BitTorrent::ChokingAlgorithm::FixedSlots));
@@ -34,6 +34,7 @@
 #include <QDateTime>
 #include <QColor>
 
+#include "base/bittorrent/session.h"
 #include "base/global.h"
 #include "gui/uithememanager.h"
 
@@ -186,6 +187,8 @@ LogPeerModel::LogPeerModel(QObject *parent)
 {
     loadColors();
 
+    BitTorrent::Session::instance()->registerPeerLogConsumer(this);
+
     for (const Log::Peer &peer : asConst(Logger::instance()->getPeers()))
         handleNewMessage(peer);
     connect(Logger::instance(), &Logger::newLogPeer, this, &LogPeerModel::handleNewMessage);
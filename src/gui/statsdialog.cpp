@@ -30,7 +30,10 @@
 
 #include <algorithm>
 
+#include <QHash>
+
 #include "base/bittorrent/cachestatus.h"
+#include "base/bittorrent/diskiostatus.h"
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/sessionstatus.h"
 #include "base/bittorrent/torrent.h"
@@ -42,6 +45,32 @@
 
 #define SETTINGS_KEY(name) u"StatisticsDialog/" name
 
+namespace
+{
+    enum DiskIOColumn
+    {
+        DISKIO_DEVICE,
+        DISKIO_READ,
+        DISKIO_WRITE,
+        DISKIO_HASH,
+        DISKIO_QUEUE_DEPTH,
+        DISKIO_READ_LATENCY,
+        DISKIO_WRITE_LATENCY,
+        DISKIO_HASH_LATENCY
+    };
+
+    QString formatLatency(const BitTorrent::DiskJobLatencyStatus &latencyStatus)
+    {
+        if (latencyStatus.count == 0)
+            return u"-"_s;
+
+        const qreal averageTime = static_cast<qreal>(latencyStatus.totalTime) / latencyStatus.count / 1000;
+        const qreal maxTime = static_cast<qreal>(latencyStatus.maxTime) / 1000;
+        return StatsDialog::tr("%1 ms (max: %2 ms)", "0.12 ms (max: 25.00 ms)")
+                .arg(Utils::String::fromDouble(averageTime, 2), Utils::String::fromDouble(maxTime, 2));
+    }
+}
+
 StatsDialog::StatsDialog(QWidget *parent)
     : QDialog(parent)
     , m_ui(new Ui::StatsDialog)
@@ -55,9 +84,8 @@ StatsDialog::StatsDialog(QWidget *parent)
     connect(BitTorrent::Session::instance(), &BitTorrent::Session::statsUpdated
             , this, &StatsDialog::update);
 
-#ifdef QBT_USES_LIBTORRENT2
-    m_ui->labelCacheHitsText->hide();
-    m_ui->labelCacheHits->hide();
+#ifndef QBT_USES_LIBTORRENT2
+    m_ui->groupDiskIO->hide();
 #endif
 
     if (const QSize dialogSize = m_storeDialogSize; dialogSize.isValid())
@@ -87,15 +115,13 @@ void StatsDialog::update()
                 ((atd > 0) && (atu > 0))
                 ? Utils::String::fromDouble(static_cast<qreal>(atu) / atd, 2)
                 : u"-"_s);
-#ifndef QBT_USES_LIBTORRENT2
     // Cache hits
     const qreal readRatio = cs.readRatio;
     m_ui->labelCacheHits->setText(u"%1%"_s.arg((readRatio > 0)
         ? Utils::String::fromDouble((100 * readRatio), 2)
         : u"0"_s));
-#endif
     // Buffers size
-    m_ui->labelTotalBuf->setText(Utils::Misc::friendlyUnit(cs.totalUsedBuffers * 16 * 1024));
+    m_ui->labelTotalBuf->setText(Utils::Misc::friendlyUnit((cs.totalUsedBuffers * 16 * 1024) + cs.readCacheSize));
     // Disk overload (100%) equivalent
     // From lt manual: disk_write_queue and disk_read_queue are the number of peers currently waiting on a disk write or disk read
     // to complete before it receives or sends any more data on the socket. It's a metric of how disk bound you are.
@@ -114,4 +140,34 @@ void StatsDialog::update()
 
     // Total connected peers
     m_ui->labelPeers->setText(QString::number(ss.peersCount));
+
+    // Disk I/O per storage device
+    const QList<BitTorrent::DiskDeviceIOStatus> &diskIOStatus = BitTorrent::Session::instance()->diskIOStatus();
+    // Update the existing items in place to preserve the selection and scroll position
+    QHash<QString, QTreeWidgetItem *> deviceItems;
+    for (int i = 0; i < m_ui->treeDiskIO->topLevelItemCount(); ++i)
+    {
+        QTreeWidgetItem *item = m_ui->treeDiskIO->topLevelItem(i);
+        deviceItems.insert(item->text(DISKIO_DEVICE), item);
+    }
+
+    for (const BitTorrent::DiskDeviceIOStatus &deviceStatus : diskIOStatus)
+    {
+        QTreeWidgetItem *item = deviceItems.take(deviceStatus.device);
+        if (!item)
+        {
+            item = new QTreeWidgetItem(m_ui->treeDiskIO);
+            item->setText(DISKIO_DEVICE, deviceStatus.device);
+        }
+
+        item->setText(DISKIO_READ, Utils::Misc::friendlyUnit(deviceStatus.readRate, true));
+        item->setText(DISKIO_WRITE, Utils::Misc::friendlyUnit(deviceStatus.writeRate, true));
+        item->setText(DISKIO_HASH, Utils::Misc::friendlyUnit(deviceStatus.hashRate, true));
+        item->setText(DISKIO_QUEUE_DEPTH, QString::number(deviceStatus.queueDepth));
+        item->setText(DISKIO_READ_LATENCY, formatLatency(deviceStatus.readLatency));
+        item->setText(DISKIO_WRITE_LATENCY, formatLatency(deviceStatus.writeLatency));
+        item->setText(DISKIO_HASH_LATENCY, formatLatency(deviceStatus.hashLatency));
+    }
+
+    qDeleteAll(deviceItems);
 }
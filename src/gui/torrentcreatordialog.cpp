@@ -70,6 +70,7 @@ TorrentCreatorDialog::TorrentCreatorDialog(QWidget *parent, const Path &defaultP
     , m_storeIgnoreRatio(SETTINGS_KEY(u"IgnoreRatio"_s))
 #ifdef QBT_USES_LIBTORRENT2
     , m_storeTorrentFormat(SETTINGS_KEY(u"TorrentFormat"_s))
+    , m_storeHashCache(SETTINGS_KEY(u"HashCache"_s))
 #else
     , m_storeOptimizeAlignment(SETTINGS_KEY(u"OptimizeAlignment"_s))
     , m_paddedFileSizeLimit(SETTINGS_KEY(u"PaddedFileSizeLimit"_s))
@@ -114,6 +115,7 @@ TorrentCreatorDialog::TorrentCreatorDialog(QWidget *parent, const Path &defaultP
     m_ui->checkOptimizeAlignment->hide();
 #else
     m_ui->widgetTorrentFormat->hide();
+    m_ui->checkHashCache->hide();
 #endif
 }
 
@@ -232,6 +234,7 @@ void TorrentCreatorDialog::onCreateButtonClicked()
         .isPrivate = m_ui->checkPrivate->isChecked(),
 #ifdef QBT_USES_LIBTORRENT2
         .torrentFormat = getTorrentFormat(),
+        .isHashCacheEnabled = m_ui->checkHashCache->isChecked(),
 #else
         .isAlignmentOptimized = m_ui->checkOptimizeAlignment->isChecked(),
         .paddedFileSizeLimit = getPaddedFileSizeLimit(),
@@ -268,8 +271,15 @@ void TorrentCreatorDialog::handleCreationSuccess(const BitTorrent::TorrentCreato
     setCursor(QCursor(Qt::ArrowCursor));
     setInteractionEnabled(true);
 
-    QMessageBox::information(this, tr("Torrent creator")
-        , u"%1\n%2"_s.arg(tr("Torrent created:"), result.torrentFilePath.toString()));
+    QString message = u"%1\n%2"_s.arg(tr("Torrent created:"), result.torrentFilePath.toString());
+#ifdef QBT_USES_LIBTORRENT2
+    if (m_ui->checkHashCache->isChecked())
+    {
+        message += u'\n' + tr("Reused hashes of %1 out of %2 files")
+            .arg(QString::number(result.hashCacheHits), QString::number(result.hashCacheHits + result.hashCacheMisses));
+    }
+#endif
+    QMessageBox::information(this, tr("Torrent creator"), message);
 
     if (m_ui->checkStartSeeding->isChecked())
     {
@@ -332,6 +342,7 @@ void TorrentCreatorDialog::setInteractionEnabled(const bool enabled) const
     m_ui->checkIgnoreShareLimits->setEnabled(enabled && m_ui->checkStartSeeding->isChecked());
 #ifdef QBT_USES_LIBTORRENT2
     m_ui->widgetTorrentFormat->setEnabled(enabled);
+    m_ui->checkHashCache->setEnabled(enabled);
 #else
     m_ui->checkOptimizeAlignment->setEnabled(enabled);
     m_ui->spinPaddedFileSizeLimit->setEnabled(enabled);
@@ -348,6 +359,7 @@ void TorrentCreatorDialog::saveSettings()
     m_storeIgnoreRatio = m_ui->checkIgnoreShareLimits->isChecked();
 #ifdef QBT_USES_LIBTORRENT2
     m_storeTorrentFormat = m_ui->comboTorrentFormat->currentIndex();
+    m_storeHashCache = m_ui->checkHashCache->isChecked();
 #else
     m_storeOptimizeAlignment = m_ui->checkOptimizeAlignment->isChecked();
     m_paddedFileSizeLimit = m_ui->spinPaddedFileSizeLimit->value();
@@ -372,6 +384,7 @@ void TorrentCreatorDialog::loadSettings()
     m_ui->checkIgnoreShareLimits->setEnabled(m_ui->checkStartSeeding->isChecked());
 #ifdef QBT_USES_LIBTORRENT2
     m_ui->comboTorrentFormat->setCurrentIndex(m_storeTorrentFormat.get(1));
+    m_ui->checkHashCache->setChecked(m_storeHashCache.get(false));
 #else
     m_ui->checkOptimizeAlignment->setChecked(m_storeOptimizeAlignment.get(true));
     m_ui->spinPaddedFileSizeLimit->setValue(m_paddedFileSizeLimit.get(-1));
@@ -87,6 +87,7 @@ private:
     SettingValue<bool> m_storeIgnoreRatio;
 #ifdef QBT_USES_LIBTORRENT2
     SettingValue<int> m_storeTorrentFormat;
+    SettingValue<bool> m_storeHashCache;
 #else
     SettingValue<bool> m_storeOptimizeAlignment;
     SettingValue<int> m_paddedFileSizeLimit;
@@ -29,19 +29,28 @@
 #include "apicontroller.h"
 
 #include <algorithm>
+#include <utility>
 
 #include <QHash>
 #include <QJsonDocument>
 #include <QList>
 #include <QMetaObject>
 
+#include "base/http/eventstream.h"
 #include "apierror.h"
 
+QString resultMimeType(const APIResultFormat format)
+{
+    return (format == APIResultFormat::JSON) ? Http::CONTENT_TYPE_JSON : Http::CONTENT_TYPE_CBOR;
+}
+
 void APIResult::clear()
 {
     data.clear();
     mimeType.clear();
     filename.clear();
+    eventStream.clear();
+    dataGenerator = {};
 }
 
 APIController::APIController(IApplication *app, QObject *parent)
@@ -49,11 +58,13 @@ APIController::APIController(IApplication *app, QObject *parent)
 {
 }
 
-APIResult APIController::run(const QString &action, const StringMap &params, const DataMap &data)
+APIResult APIController::run(const QString &action, const StringMap &params, const DataMap &data
+        , const APIResultFormat resultFormat)
 {
     m_result.clear(); // clear result
     m_params = params;
     m_data = data;
+    m_resultFormat = resultFormat;
 
     const QByteArray methodName = action.toLatin1() + "Action";
     if (!QMetaObject::invokeMethod(this, methodName.constData()))
@@ -72,6 +83,11 @@ const DataMap &APIController::data() const
     return m_data;
 }
 
+APIResultFormat APIController::resultFormat() const
+{
+    return m_resultFormat;
+}
+
 void APIController::requireParams(const QList<QString> &requiredParams) const
 {
     const bool hasAllRequiredParams = std::all_of(requiredParams.cbegin(), requiredParams.cend()
@@ -105,3 +121,14 @@ void APIController::setResult(const QByteArray &result, const QString &mimeType,
     m_result.mimeType = mimeType;
     m_result.filename = filename;
 }
+
+void APIController::setResult(Http::EventStream *eventStream)
+{
+    m_result.eventStream = eventStream;
+}
+
+void APIController::setDeferredResult(std::function<QByteArray ()> generator, const QString &mimeType)
+{
+    m_result.dataGenerator = std::move(generator);
+    m_result.mimeType = mimeType;
+}
@@ -28,21 +28,38 @@
 
 #pragma once
 
+#include <functional>
+
 #include <QtContainerFwd>
 #include <QObject>
+#include <QPointer>
 #include <QString>
 #include <QVariant>
 
 #include "base/applicationcomponent.h"
+#include "base/http/types.h"
 
 using DataMap = QHash<QString, QByteArray>;
 using StringMap = QHash<QString, QString>;
 
+enum class APIResultFormat
+{
+    JSON,
+    CBOR,
+    // CBOR using the string references extension
+    CBORWithStringRefs
+};
+
+QString resultMimeType(APIResultFormat format);
+
 struct APIResult
 {
     QVariant data;
     QString mimeType;
     QString filename;
+    QPointer<Http::EventStream> eventStream;
+    // produces the data outside of the main thread
+    std::function<QByteArray ()> dataGenerator;
 
     void clear();
 };
@@ -55,20 +72,28 @@ class APIController : public ApplicationComponent<QObject>
 public:
     explicit APIController(IApplication *app, QObject *parent = nullptr);
 
-    APIResult run(const QString &action, const StringMap &params, const DataMap &data = {});
+    APIResult run(const QString &action, const StringMap &params, const DataMap &data = {}
+            , APIResultFormat resultFormat = APIResultFormat::JSON);
 
 protected:
     const StringMap &params() const;
     const DataMap &data() const;
+    // format of structured data preferred by the client, plain JSON results are converted by WebApplication
+    APIResultFormat resultFormat() const;
     void requireParams(const QList<QString> &requiredParams) const;
 
     void setResult(const QString &result);
     void setResult(const QJsonArray &result);
     void setResult(const QJsonObject &result);
     void setResult(const QByteArray &result, const QString &mimeType = {}, const QString &filename = {});
+    void setResult(Http::EventStream *eventStream);
+    // the result is serialized once the response is handed over to the connection,
+    // the generator must only use the data it holds, since it isn't called in the main thread
+    void setDeferredResult(std::function<QByteArray ()> generator, const QString &mimeType);
 
 private:
     StringMap m_params;
     DataMap m_data;
+    APIResultFormat m_resultFormat = APIResultFormat::JSON;
     APIResult m_result;
 };
@@ -393,6 +393,8 @@ void AppController::preferencesAction()
     data[u"resolve_peer_countries"_s] = pref->resolvePeerCountries();
     // Reannounce to all trackers when ip/port changed
     data[u"reannounce_when_address_changed"_s] = session->isReannounceWhenAddressChangedEnabled();
+    // Metadata cache size
+    data[u"metadata_cache_size"_s] = session->metadataCacheSize();
 
     // libtorrent preferences
     // Bdecode depth limit
@@ -410,6 +412,10 @@ void AppController::preferencesAction()
     // Disk write cache
     data[u"disk_cache"_s] = session->diskCacheSize();
     data[u"disk_cache_ttl"_s] = session->diskCacheTTL();
+    // Read cache
+    data[u"read_cache_size"_s] = session->readCacheSize();
+    // Fast recheck
+    data[u"fast_recheck_enabled"_s] = session->isFastRecheckEnabled();
     // Disk queue size
     data[u"disk_queue_size"_s] = session->diskQueueSize();
     // Disk IO Type
@@ -1007,6 +1013,9 @@ void AppController::setPreferencesAction()
     // Reannounce to all trackers when ip/port changed
     if (hasKey(u"reannounce_when_address_changed"_s))
         session->setReannounceWhenAddressChangedEnabled(it.value().toBool());
+    // Metadata cache size
+    if (hasKey(u"metadata_cache_size"_s))
+        session->setMetadataCacheSize(it.value().toInt());
 
     // libtorrent preferences
     // Bdecode depth limit
@@ -1032,6 +1041,12 @@ void AppController::setPreferencesAction()
         session->setDiskCacheSize(it.value().toInt());
     if (hasKey(u"disk_cache_ttl"_s))
         session->setDiskCacheTTL(it.value().toInt());
+    // Read cache
+    if (hasKey(u"read_cache_size"_s))
+        session->setReadCacheSize(it.value().toInt());
+    // Fast recheck
+    if (hasKey(u"fast_recheck_enabled"_s))
+        session->setFastRecheckEnabled(it.value().toBool());
     // Disk queue size
     if (hasKey(u"disk_queue_size"_s))
         session->setDiskQueueSize(it.value().toLongLong());
@@ -32,8 +32,11 @@
 #include <QJsonObject>
 #include <QList>
 
+#include "base/bittorrent/session.h"
 #include "base/global.h"
 #include "base/logger.h"
+#include "base/utils/cbor.h"
+#include "base/utils/json.h"
 #include "base/utils/string.h"
 
 const QString KEY_LOG_ID = u"id"_s;
@@ -44,6 +47,44 @@ const QString KEY_LOG_PEER_IP = u"ip"_s;
 const QString KEY_LOG_PEER_BLOCKED = u"blocked"_s;
 const QString KEY_LOG_PEER_REASON = u"reason"_s;
 
+namespace
+{
+    struct LogFilter
+    {
+        bool isNormal = true;
+        bool isInfo = true;
+        bool isWarning = true;
+        bool isCritical = true;
+        int lastKnownId = -1;
+    };
+
+    template <typename Writer>
+    void writeMainLog(Writer &writer, const LogFilter &filter)
+    {
+        writer.beginArray();
+        for (const Log::Msg &msg : asConst(Logger::instance()->getMessages(filter.lastKnownId)))
+        {
+            if (!(((msg.type == Log::NORMAL) && filter.isNormal)
+                  || ((msg.type == Log::INFO) && filter.isInfo)
+                  || ((msg.type == Log::WARNING) && filter.isWarning)
+                  || ((msg.type == Log::CRITICAL) && filter.isCritical)))
+                continue;
+
+            writer.beginObject();
+            writer.writeKey(KEY_LOG_ID);
+            writer.writeInt(msg.id);
+            writer.writeKey(KEY_LOG_TIMESTAMP);
+            writer.writeInt(msg.timestamp);
+            writer.writeKey(KEY_LOG_MSG_TYPE);
+            writer.writeInt(msg.type);
+            writer.writeKey(KEY_LOG_MSG_MESSAGE);
+            writer.writeString(msg.message);
+            writer.endObject();
+        }
+        writer.endArray();
+    }
+}
+
 // Returns the log in JSON format.
 // The return value is an array of dictionaries.
 // The dictionary keys are:
@@ -58,40 +99,43 @@ const QString KEY_LOG_PEER_REASON = u"reason"_s;
 //   - critical (bool): include critical messages (default true)
 //   - last_known_id (int): exclude messages with id <= 'last_known_id' (default -1)
 void LogController::mainAction()
+{
+    // the logger is thread-safe, so the messages are read and serialized outside of the main thread
+    setDeferredResult(mainLogGenerator(params(), resultFormat()), resultMimeType(resultFormat()));
+}
+
+std::function<QByteArray ()> LogController::mainLogGenerator(const StringMap &params, const APIResultFormat resultFormat)
 {
     using Utils::String::parseBool;
 
-    const bool isNormal = parseBool(params()[u"normal"_s]).value_or(true);
-    const bool isInfo = parseBool(params()[u"info"_s]).value_or(true);
-    const bool isWarning = parseBool(params()[u"warning"_s]).value_or(true);
-    const bool isCritical = parseBool(params()[u"critical"_s]).value_or(true);
+    LogFilter filter;
+    filter.isNormal = parseBool(params[u"normal"_s]).value_or(true);
+    filter.isInfo = parseBool(params[u"info"_s]).value_or(true);
+    filter.isWarning = parseBool(params[u"warning"_s]).value_or(true);
+    filter.isCritical = parseBool(params[u"critical"_s]).value_or(true);
 
     bool ok = false;
-    int lastKnownId = params()[u"last_known_id"_s].toInt(&ok);
+    filter.lastKnownId = params[u"last_known_id"_s].toInt(&ok);
     if (!ok)
-        lastKnownId = -1;
-
-    Logger *const logger = Logger::instance();
-    QJsonArray msgList;
+        filter.lastKnownId = -1;
 
-    for (const Log::Msg &msg : asConst(logger->getMessages(lastKnownId)))
+    if (resultFormat != APIResultFormat::JSON)
     {
-        if (!(((msg.type == Log::NORMAL) && isNormal)
-              || ((msg.type == Log::INFO) && isInfo)
-              || ((msg.type == Log::WARNING) && isWarning)
-              || ((msg.type == Log::CRITICAL) && isCritical)))
-            continue;
-
-        msgList.append(QJsonObject
+        const bool useStringRefs = (resultFormat == APIResultFormat::CBORWithStringRefs);
+        return [filter, useStringRefs]
         {
-            {KEY_LOG_ID, msg.id},
-            {KEY_LOG_TIMESTAMP, msg.timestamp},
-            {KEY_LOG_MSG_TYPE, msg.type},
-            {KEY_LOG_MSG_MESSAGE, msg.message}
-        });
+            Utils::Cbor::Writer writer {0, useStringRefs};
+            writeMainLog(writer, filter);
+            return writer.takeData();
+        };
     }
 
-    setResult(msgList);
+    return [filter]
+    {
+        Utils::Json::Writer writer;
+        writeMainLog(writer, filter);
+        return writer.takeData();
+    };
 }
 
 // Returns the peer log in JSON format.
@@ -111,6 +155,10 @@ void LogController::peersAction()
     if (!ok)
         lastKnownId = -1;
 
+    // Peer log is collected only while someone is interested in it,
+    // so keep it enabled for the rest of the current WebUI session
+    BitTorrent::Session::instance()->registerPeerLogConsumer(this);
+
     Logger *const logger = Logger::instance();
     QJsonArray peerList;
 
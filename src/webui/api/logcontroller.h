@@ -28,6 +28,10 @@
 
 #pragma once
 
+#include <functional>
+
+#include <QByteArray>
+
 #include "apicontroller.h"
 
 class LogController final : public APIController
@@ -38,6 +42,9 @@ class LogController final : public APIController
 public:
     using APIController::APIController;
 
+    // the returned generator can be called in any thread, it reads the messages when it's called
+    static std::function<QByteArray ()> mainLogGenerator(const StringMap &params, APIResultFormat resultFormat);
+
 private slots:
     void mainAction();
     void peersAction();
@@ -0,0 +1,158 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "maindatachangelog.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+    const qsizetype MAX_CHANGELOG_SIZE = 256;
+    const qsizetype MIN_CHANGELOG_ITEM_COUNT = 1024;
+
+    // Apply the difference (data) calculated by processMap() on top of the preceding one (syncData).
+    void mergeMap(QVariantMap &syncData, const QVariantMap &data)
+    {
+        for (auto i = data.cbegin(); i != data.cend(); ++i)
+        {
+            if (i.value().userType() == QMetaType::QVariantMap)
+            {
+                QVariantMap map = syncData.value(i.key()).toMap();
+                mergeMap(map, i.value().toMap());
+                syncData[i.key()] = map;
+            }
+            else
+            {
+                syncData[i.key()] = i.value();
+            }
+        }
+    }
+}
+
+bool MaindataSyncBuf::isEmpty() const
+{
+    return categories.isEmpty() && tags.isEmpty() && torrents.isEmpty() && trackers.isEmpty()
+        && serverState.isEmpty() && removedCategories.isEmpty() && removedTags.isEmpty()
+        && removedTorrents.isEmpty() && removedTrackers.isEmpty();
+}
+
+qsizetype MaindataSyncBuf::itemCount() const
+{
+    return categories.size() + tags.size() + torrents.size() + trackers.size() + 1
+        + removedCategories.size() + removedTags.size() + removedTorrents.size() + removedTrackers.size();
+}
+
+void mergeMaindataSyncBuf(MaindataSyncBuf &syncBuf, const MaindataSyncBuf &change)
+{
+    // if need to update existing sync data
+    for (auto it = change.categories.cbegin(); it != change.categories.cend(); ++it)
+        syncBuf.removedCategories.removeOne(it.key());
+    for (const QString &category : change.removedCategories)
+        syncBuf.categories.remove(category);
+
+    for (const QVariant &tag : change.tags)
+        syncBuf.removedTags.removeOne(tag.toString());
+    for (const QString &tag : change.removedTags)
+        syncBuf.tags.removeOne(tag);
+
+    for (auto it = change.torrents.cbegin(); it != change.torrents.cend(); ++it)
+        syncBuf.removedTorrents.removeOne(it.key());
+    for (const QString &torrentID : change.removedTorrents)
+        syncBuf.torrents.remove(torrentID);
+
+    for (auto it = change.trackers.cbegin(); it != change.trackers.cend(); ++it)
+        syncBuf.removedTrackers.removeOne(it.key());
+    for (const QString &tracker : change.removedTrackers)
+        syncBuf.trackers.remove(tracker);
+
+    for (auto it = change.categories.cbegin(); it != change.categories.cend(); ++it)
+        mergeMap(syncBuf.categories[it.key()], it.value());
+    syncBuf.removedCategories.append(change.removedCategories);
+
+    syncBuf.tags.append(change.tags);
+    syncBuf.removedTags.append(change.removedTags);
+
+    for (auto it = change.torrents.cbegin(); it != change.torrents.cend(); ++it)
+    {
+        // the later state of torrent has the actual values of the fields changed earlier too
+        TorrentSyncData &torrentSyncData = syncBuf.torrents[it.key()];
+        torrentSyncData.torrent = it->torrent;
+        torrentSyncData.changedFields |= it->changedFields;
+    }
+    syncBuf.removedTorrents.append(change.removedTorrents);
+
+    syncBuf.trackers.insert(change.trackers);
+    syncBuf.removedTrackers.append(change.removedTrackers);
+
+    mergeMap(syncBuf.serverState, change.serverState);
+}
+
+void MaindataChangeLog::append(const int id, MaindataSyncBuf change, const qsizetype snapshotItemCount)
+{
+    m_itemCount += change.itemCount();
+    m_changes.append({id, std::move(change)});
+
+    const qsizetype maxItemCount = std::max(snapshotItemCount, MIN_CHANGELOG_ITEM_COUNT);
+    while ((m_changes.size() > MAX_CHANGELOG_SIZE)
+           || ((m_changes.size() > 1) && (m_itemCount > maxItemCount)))
+    {
+        m_itemCount -= m_changes.first().syncBuf.itemCount();
+        m_changes.removeFirst();
+    }
+}
+
+bool MaindataChangeLog::collectChanges(const int sinceID, const int currentID, MaindataSyncBuf &syncBuf) const
+{
+    if (sinceID == currentID)
+        return true;
+
+    if (m_changes.isEmpty() || (sinceID > currentID))
+        return false;
+
+    // the log is contiguous, the first change is applied to the snapshot with preceding ID
+    const qsizetype index = sinceID - (m_changes.first().id - 1);
+    if (index < 0)
+        return false;
+
+    for (auto it = m_changes.cbegin() + index; (it != m_changes.cend()) && (it->id <= currentID); ++it)
+        mergeMaindataSyncBuf(syncBuf, it->syncBuf);
+
+    return true;
+}
+
+void MaindataChangeLog::clear()
+{
+    m_changes.clear();
+    m_itemCount = 0;
+}
+
+qsizetype MaindataChangeLog::size() const
+{
+    return m_changes.size();
+}
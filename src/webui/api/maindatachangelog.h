@@ -0,0 +1,90 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+
+#include "serialize/serialize_torrent.h"
+
+struct TorrentSyncData
+{
+    SerializedTorrent torrent;
+    SerializedTorrent::Fields changedFields;
+};
+
+// Either the full maindata or the changes of it, in the form they are sent to the clients
+struct MaindataSyncBuf
+{
+    QHash<QString, QVariantMap> categories;
+    QVariantList tags;
+    QHash<QString, TorrentSyncData> torrents;
+    QHash<QString, QStringList> trackers;
+    QVariantMap serverState;
+
+    QStringList removedCategories;
+    QStringList removedTags;
+    QStringList removedTorrents;
+    QStringList removedTrackers;
+
+    bool isEmpty() const;
+    qsizetype itemCount() const;
+};
+
+// Applies the change on top of the preceding ones accumulated in syncBuf
+void mergeMaindataSyncBuf(MaindataSyncBuf &syncBuf, const MaindataSyncBuf &change);
+
+// The log of the recent changes of maindata snapshot,
+// each change is identified by the snapshot ID it results in.
+class MaindataChangeLog
+{
+public:
+    // The log is kept smaller than another copy of the snapshot would be,
+    // so the oldest changes are dropped when it grows too large.
+    void append(int id, MaindataSyncBuf change, qsizetype snapshotItemCount);
+    // Merges the changes made since sinceID up to currentID,
+    // returns false if some of them have already been dropped from the log.
+    bool collectChanges(int sinceID, int currentID, MaindataSyncBuf &syncBuf) const;
+    void clear();
+
+    qsizetype size() const;
+
+private:
+    struct Change
+    {
+        int id = 0;
+        MaindataSyncBuf syncBuf;
+    };
+
+    QList<Change> m_changes;
+    qsizetype m_itemCount = 0;
+};
@@ -28,7 +28,13 @@
 
 #include "serialize_torrent.h"
 
+#include <algorithm>
+#include <concepts>
+#include <numeric>
+#include <vector>
+
 #include <QDateTime>
+#include <QHash>
 #include <QList>
 
 #include "base/bittorrent/infohash.h"
@@ -36,7 +42,9 @@
 #include "base/bittorrent/trackerentrystatus.h"
 #include "base/path.h"
 #include "base/tagset.h"
+#include "base/utils/cbor.h"
 #include "base/utils/datetime.h"
+#include "base/utils/json.h"
 #include "base/utils/string.h"
 
 namespace
@@ -85,10 +93,217 @@ namespace
             return u"unknown"_s;
         }
     }
+
+    // Calls the visitor for each field with its ID, key and the values of it in the given torrents
+    template <typename Visitor, typename... Torrents>
+    void visitFields(Visitor &&visitor, const Torrents &...torrents)
+    {
+        using Field = SerializedTorrent::Field;
+
+        visitor(Field::InfoHashV1, KEY_TORRENT_INFOHASHV1, torrents.infoHashV1...);
+        visitor(Field::InfoHashV2, KEY_TORRENT_INFOHASHV2, torrents.infoHashV2...);
+        visitor(Field::Name, KEY_TORRENT_NAME, torrents.name...);
+        visitor(Field::MagnetURI, KEY_TORRENT_MAGNET_URI, torrents.magnetURI...);
+        visitor(Field::Size, KEY_TORRENT_SIZE, torrents.size...);
+        visitor(Field::Progress, KEY_TORRENT_PROGRESS, torrents.progress...);
+        visitor(Field::DownloadSpeed, KEY_TORRENT_DLSPEED, torrents.downloadSpeed...);
+        visitor(Field::UploadSpeed, KEY_TORRENT_UPSPEED, torrents.uploadSpeed...);
+        visitor(Field::QueuePosition, KEY_TORRENT_QUEUE_POSITION, torrents.queuePosition...);
+        visitor(Field::Seeds, KEY_TORRENT_SEEDS, torrents.seeds...);
+        visitor(Field::NumComplete, KEY_TORRENT_NUM_COMPLETE, torrents.numComplete...);
+        visitor(Field::Leechs, KEY_TORRENT_LEECHS, torrents.leechs...);
+        visitor(Field::NumIncomplete, KEY_TORRENT_NUM_INCOMPLETE, torrents.numIncomplete...);
+        visitor(Field::State, KEY_TORRENT_STATE, torrents.state...);
+        visitor(Field::ETA, KEY_TORRENT_ETA, torrents.eta...);
+        visitor(Field::SequentialDownload, KEY_TORRENT_SEQUENTIAL_DOWNLOAD, torrents.isSequentialDownload...);
+        visitor(Field::FirstLastPiecePrio, KEY_TORRENT_FIRST_LAST_PIECE_PRIO, torrents.hasFirstLastPiecePriority...);
+        visitor(Field::Category, KEY_TORRENT_CATEGORY, torrents.category...);
+        visitor(Field::Tags, KEY_TORRENT_TAGS, torrents.tags...);
+        visitor(Field::SuperSeeding, KEY_TORRENT_SUPER_SEEDING, torrents.isSuperSeeding...);
+        visitor(Field::ForceStart, KEY_TORRENT_FORCE_START, torrents.isForced...);
+        visitor(Field::SavePath, KEY_TORRENT_SAVE_PATH, torrents.savePath...);
+        visitor(Field::DownloadPath, KEY_TORRENT_DOWNLOAD_PATH, torrents.downloadPath...);
+        visitor(Field::ContentPath, KEY_TORRENT_CONTENT_PATH, torrents.contentPath...);
+        visitor(Field::RootPath, KEY_TORRENT_ROOT_PATH, torrents.rootPath...);
+        visitor(Field::AddedOn, KEY_TORRENT_ADDED_ON, torrents.addedOn...);
+        visitor(Field::CompletionOn, KEY_TORRENT_COMPLETION_ON, torrents.completionOn...);
+        visitor(Field::Tracker, KEY_TORRENT_TRACKER, torrents.tracker...);
+        visitor(Field::TrackersCount, KEY_TORRENT_TRACKERS_COUNT, torrents.trackersCount...);
+        visitor(Field::DownloadLimit, KEY_TORRENT_DL_LIMIT, torrents.downloadLimit...);
+        visitor(Field::UploadLimit, KEY_TORRENT_UP_LIMIT, torrents.uploadLimit...);
+        visitor(Field::AmountDownloaded, KEY_TORRENT_AMOUNT_DOWNLOADED, torrents.amountDownloaded...);
+        visitor(Field::AmountUploaded, KEY_TORRENT_AMOUNT_UPLOADED, torrents.amountUploaded...);
+        visitor(Field::AmountDownloadedSession, KEY_TORRENT_AMOUNT_DOWNLOADED_SESSION, torrents.amountDownloadedSession...);
+        visitor(Field::AmountUploadedSession, KEY_TORRENT_AMOUNT_UPLOADED_SESSION, torrents.amountUploadedSession...);
+        visitor(Field::AmountLeft, KEY_TORRENT_AMOUNT_LEFT, torrents.amountLeft...);
+        visitor(Field::AmountCompleted, KEY_TORRENT_AMOUNT_COMPLETED, torrents.amountCompleted...);
+        visitor(Field::MaxRatio, KEY_TORRENT_MAX_RATIO, torrents.maxRatio...);
+        visitor(Field::MaxSeedingTime, KEY_TORRENT_MAX_SEEDING_TIME, torrents.maxSeedingTime...);
+        visitor(Field::MaxInactiveSeedingTime, KEY_TORRENT_MAX_INACTIVE_SEEDING_TIME, torrents.maxInactiveSeedingTime...);
+        visitor(Field::Ratio, KEY_TORRENT_RATIO, torrents.ratio...);
+        visitor(Field::RatioLimit, KEY_TORRENT_RATIO_LIMIT, torrents.ratioLimit...);
+        visitor(Field::Popularity, KEY_TORRENT_POPULARITY, torrents.popularity...);
+        visitor(Field::SeedingTimeLimit, KEY_TORRENT_SEEDING_TIME_LIMIT, torrents.seedingTimeLimit...);
+        visitor(Field::InactiveSeedingTimeLimit, KEY_TORRENT_INACTIVE_SEEDING_TIME_LIMIT, torrents.inactiveSeedingTimeLimit...);
+        visitor(Field::LastSeenCompleteTime, KEY_TORRENT_LAST_SEEN_COMPLETE_TIME, torrents.lastSeenComplete...);
+        visitor(Field::AutoTorrentManagement, KEY_TORRENT_AUTO_TORRENT_MANAGEMENT, torrents.isAutoTMMEnabled...);
+        visitor(Field::TimeActive, KEY_TORRENT_TIME_ACTIVE, torrents.timeActive...);
+        visitor(Field::SeedingTime, KEY_TORRENT_SEEDING_TIME, torrents.seedingTime...);
+        visitor(Field::LastActivityTime, KEY_TORRENT_LAST_ACTIVITY_TIME, torrents.lastActivity...);
+        visitor(Field::Availability, KEY_TORRENT_AVAILABILITY, torrents.availability...);
+        visitor(Field::Reannounce, KEY_TORRENT_REANNOUNCE, torrents.reannounce...);
+        visitor(Field::Comment, KEY_TORRENT_COMMENT, torrents.comment...);
+        visitor(Field::Private, KEY_TORRENT_PRIVATE, torrents.isPrivate...);
+        visitor(Field::TotalSize, KEY_TORRENT_TOTAL_SIZE, torrents.totalSize...);
+        visitor(Field::HasMetadata, KEY_TORRENT_HAS_METADATA, torrents.hasMetadata...);
+    }
+
+    template <typename Writer>
+    void writeValue(Writer &writer, const QString &value)
+    {
+        writer.writeString(value);
+    }
+
+    template <typename Writer>
+    void writeValue(Writer &writer, const bool value)
+    {
+        writer.writeBool(value);
+    }
+
+    template <typename Writer, std::integral T>
+    void writeValue(Writer &writer, const T value)
+    {
+        writer.writeInt(value);
+    }
+
+    template <typename Writer>
+    void writeValue(Writer &writer, const qreal value)
+    {
+        writer.writeDouble(value);
+    }
+
+    template <typename Writer>
+    void writeValue(Writer &writer, const BitTorrent::TorrentState value)
+    {
+        writer.writeString(torrentStateToString(value));
+    }
+
+    template <typename Writer>
+    void writeValue(Writer &writer, const TagSet &value)
+    {
+        writer.writeString(Utils::String::joinIntoString(value, u", "_s));
+    }
+
+    template <typename Writer>
+    void writeValue(Writer &writer, const Path &value)
+    {
+        writer.writeString(value.toString());
+    }
+
+    template <typename Writer>
+    void writeValue(Writer &writer, const std::optional<bool> &value)
+    {
+        if (value)
+            writer.writeBool(*value);
+        else
+            writer.writeNull();
+    }
+
+    template <typename Writer>
+    void writeFieldsImpl(Writer &writer, const SerializedTorrent &torrent, const SerializedTorrent::Fields &fields)
+    {
+        visitFields([&writer, &fields](const SerializedTorrent::Field field, const QString &key, const auto &value)
+        {
+            if (!fields.test(static_cast<std::size_t>(field)))
+                return;
+
+            writer.writeKey(key);
+            writeValue(writer, value);
+        }, torrent);
+    }
+
+    SerializedTorrentSortKey toSortKey(const QString &value)
+    {
+        return value;
+    }
+
+    SerializedTorrentSortKey toSortKey(const bool value)
+    {
+        return value;
+    }
+
+    template <std::integral T>
+    SerializedTorrentSortKey toSortKey(const T value)
+    {
+        return static_cast<qlonglong>(value);
+    }
+
+    SerializedTorrentSortKey toSortKey(const qreal value)
+    {
+        return value;
+    }
+
+    SerializedTorrentSortKey toSortKey(const BitTorrent::TorrentState value)
+    {
+        return torrentStateToString(value);
+    }
+
+    SerializedTorrentSortKey toSortKey(const TagSet &value)
+    {
+        return Utils::String::joinIntoString(value, u", "_s);
+    }
+
+    SerializedTorrentSortKey toSortKey(const Path &value)
+    {
+        return value.toString();
+    }
+
+    SerializedTorrentSortKey toSortKey(const std::optional<bool> &value)
+    {
+        return value ? SerializedTorrentSortKey(*value) : SerializedTorrentSortKey();
+    }
+
+    template <typename T>
+    QVariant toVariant(const T &value)
+    {
+        return QVariant::fromValue(value);
+    }
+
+    QVariant toVariant(const BitTorrent::TorrentState value)
+    {
+        return torrentStateToString(value);
+    }
+
+    QVariant toVariant(const TagSet &value)
+    {
+        return Utils::String::joinIntoString(value, u", "_s);
+    }
+
+    QVariant toVariant(const Path &value)
+    {
+        return value.toString();
+    }
+
+    QVariant toVariant(const std::optional<bool> &value)
+    {
+        return value ? QVariant(*value) : QVariant();
+    }
 }
 
-QVariantMap serialize(const BitTorrent::Torrent &torrent)
+SerializedTorrent serializeTorrent(const BitTorrent::Torrent &torrent)
 {
+    return serializeTorrent(torrent, SerializedTorrent::Fields().set());
+}
+
+SerializedTorrent serializeTorrent(const BitTorrent::Torrent &torrent, const SerializedTorrent::Fields &fields)
+{
+    using Field = SerializedTorrent::Field;
+
+    const auto isRequested = [&fields](const Field field) -> bool
+    {
+        return fields.test(static_cast<std::size_t>(field));
+    };
+
     const auto adjustQueuePosition = [](const int position) -> int
     {
         return (position < 0) ? 0 : (position + 1);
@@ -107,65 +322,226 @@ QVariantMap serialize(const BitTorrent::Torrent &torrent)
             : (QDateTime::currentDateTime().toSecsSinceEpoch() - timeSinceActivity);
     };
 
-    return {
-        {KEY_TORRENT_ID, torrent.id().toString()},
-        {KEY_TORRENT_INFOHASHV1, torrent.infoHash().v1().toString()},
-        {KEY_TORRENT_INFOHASHV2, torrent.infoHash().v2().toString()},
-        {KEY_TORRENT_NAME, torrent.name()},
-        {KEY_TORRENT_MAGNET_URI, torrent.createMagnetURI()},
-        {KEY_TORRENT_SIZE, torrent.wantedSize()},
-        {KEY_TORRENT_PROGRESS, torrent.progress()},
-        {KEY_TORRENT_DLSPEED, torrent.downloadPayloadRate()},
-        {KEY_TORRENT_UPSPEED, torrent.uploadPayloadRate()},
-        {KEY_TORRENT_QUEUE_POSITION, adjustQueuePosition(torrent.queuePosition())},
-        {KEY_TORRENT_SEEDS, torrent.seedsCount()},
-        {KEY_TORRENT_NUM_COMPLETE, torrent.totalSeedsCount()},
-        {KEY_TORRENT_LEECHS, torrent.leechsCount()},
-        {KEY_TORRENT_NUM_INCOMPLETE, torrent.totalLeechersCount()},
-
-        {KEY_TORRENT_STATE, torrentStateToString(torrent.state())},
-        {KEY_TORRENT_ETA, torrent.eta()},
-        {KEY_TORRENT_SEQUENTIAL_DOWNLOAD, torrent.isSequentialDownload()},
-        {KEY_TORRENT_FIRST_LAST_PIECE_PRIO, torrent.hasFirstLastPiecePriority()},
-
-        {KEY_TORRENT_CATEGORY, torrent.category()},
-        {KEY_TORRENT_TAGS, Utils::String::joinIntoString(torrent.tags(), u", "_s)},
-        {KEY_TORRENT_SUPER_SEEDING, torrent.superSeeding()},
-        {KEY_TORRENT_FORCE_START, torrent.isForced()},
-        {KEY_TORRENT_SAVE_PATH, torrent.savePath().toString()},
-        {KEY_TORRENT_DOWNLOAD_PATH, torrent.downloadPath().toString()},
-        {KEY_TORRENT_CONTENT_PATH, torrent.contentPath().toString()},
-        {KEY_TORRENT_ROOT_PATH, torrent.rootPath().toString()},
-        {KEY_TORRENT_ADDED_ON, Utils::DateTime::toSecsSinceEpoch(torrent.addedTime())},
-        {KEY_TORRENT_COMPLETION_ON, Utils::DateTime::toSecsSinceEpoch(torrent.completedTime())},
-        {KEY_TORRENT_TRACKER, torrent.currentTracker()},
-        {KEY_TORRENT_TRACKERS_COUNT, torrent.trackers().size()},
-        {KEY_TORRENT_DL_LIMIT, torrent.downloadLimit()},
-        {KEY_TORRENT_UP_LIMIT, torrent.uploadLimit()},
-        {KEY_TORRENT_AMOUNT_DOWNLOADED, torrent.totalDownload()},
-        {KEY_TORRENT_AMOUNT_UPLOADED, torrent.totalUpload()},
-        {KEY_TORRENT_AMOUNT_DOWNLOADED_SESSION, torrent.totalPayloadDownload()},
-        {KEY_TORRENT_AMOUNT_UPLOADED_SESSION, torrent.totalPayloadUpload()},
-        {KEY_TORRENT_AMOUNT_LEFT, torrent.remainingSize()},
-        {KEY_TORRENT_AMOUNT_COMPLETED, torrent.completedSize()},
-        {KEY_TORRENT_MAX_RATIO, torrent.maxRatio()},
-        {KEY_TORRENT_MAX_SEEDING_TIME, torrent.maxSeedingTime()},
-        {KEY_TORRENT_MAX_INACTIVE_SEEDING_TIME, torrent.maxInactiveSeedingTime()},
-        {KEY_TORRENT_RATIO, adjustRatio(torrent.realRatio())},
-        {KEY_TORRENT_RATIO_LIMIT, torrent.ratioLimit()},
-        {KEY_TORRENT_POPULARITY, torrent.popularity()},
-        {KEY_TORRENT_SEEDING_TIME_LIMIT, torrent.seedingTimeLimit()},
-        {KEY_TORRENT_INACTIVE_SEEDING_TIME_LIMIT, torrent.inactiveSeedingTimeLimit()},
-        {KEY_TORRENT_LAST_SEEN_COMPLETE_TIME, Utils::DateTime::toSecsSinceEpoch(torrent.lastSeenComplete())},
-        {KEY_TORRENT_AUTO_TORRENT_MANAGEMENT, torrent.isAutoTMMEnabled()},
-        {KEY_TORRENT_TIME_ACTIVE, torrent.activeTime()},
-        {KEY_TORRENT_SEEDING_TIME, torrent.finishedTime()},
-        {KEY_TORRENT_LAST_ACTIVITY_TIME, getLastActivityTime()},
-        {KEY_TORRENT_AVAILABILITY, torrent.distributedCopies()},
-        {KEY_TORRENT_REANNOUNCE, torrent.nextAnnounce()},
-        {KEY_TORRENT_COMMENT, torrent.comment()},
-        {KEY_TORRENT_PRIVATE, (torrent.hasMetadata() ? torrent.isPrivate() : QVariant())},
-        {KEY_TORRENT_TOTAL_SIZE, torrent.totalSize()},
-        {KEY_TORRENT_HAS_METADATA, torrent.hasMetadata()}
+    SerializedTorrent result;
+    if (isRequested(Field::InfoHashV1))
+        result.infoHashV1 = torrent.infoHash().v1().toString();
+    if (isRequested(Field::InfoHashV2))
+        result.infoHashV2 = torrent.infoHash().v2().toString();
+    if (isRequested(Field::Name))
+        result.name = torrent.name();
+    if (isRequested(Field::MagnetURI))
+        result.magnetURI = torrent.createMagnetURI();
+    if (isRequested(Field::Size))
+        result.size = torrent.wantedSize();
+    if (isRequested(Field::Progress))
+        result.progress = torrent.progress();
+    if (isRequested(Field::DownloadSpeed))
+        result.downloadSpeed = torrent.downloadPayloadRate();
+    if (isRequested(Field::UploadSpeed))
+        result.uploadSpeed = torrent.uploadPayloadRate();
+    if (isRequested(Field::QueuePosition))
+        result.queuePosition = adjustQueuePosition(torrent.queuePosition());
+    if (isRequested(Field::Seeds))
+        result.seeds = torrent.seedsCount();
+    if (isRequested(Field::NumComplete))
+        result.numComplete = torrent.totalSeedsCount();
+    if (isRequested(Field::Leechs))
+        result.leechs = torrent.leechsCount();
+    if (isRequested(Field::NumIncomplete))
+        result.numIncomplete = torrent.totalLeechersCount();
+    if (isRequested(Field::State))
+        result.state = torrent.state();
+    if (isRequested(Field::ETA))
+        result.eta = torrent.eta();
+    if (isRequested(Field::SequentialDownload))
+        result.isSequentialDownload = torrent.isSequentialDownload();
+    if (isRequested(Field::FirstLastPiecePrio))
+        result.hasFirstLastPiecePriority = torrent.hasFirstLastPiecePriority();
+    if (isRequested(Field::Category))
+        result.category = torrent.category();
+    if (isRequested(Field::Tags))
+        result.tags = torrent.tags();
+    if (isRequested(Field::SuperSeeding))
+        result.isSuperSeeding = torrent.superSeeding();
+    if (isRequested(Field::ForceStart))
+        result.isForced = torrent.isForced();
+    if (isRequested(Field::SavePath))
+        result.savePath = torrent.savePath();
+    if (isRequested(Field::DownloadPath))
+        result.downloadPath = torrent.downloadPath();
+    if (isRequested(Field::ContentPath))
+        result.contentPath = torrent.contentPath();
+    if (isRequested(Field::RootPath))
+        result.rootPath = torrent.rootPath();
+    if (isRequested(Field::AddedOn))
+        result.addedOn = Utils::DateTime::toSecsSinceEpoch(torrent.addedTime());
+    if (isRequested(Field::CompletionOn))
+        result.completionOn = Utils::DateTime::toSecsSinceEpoch(torrent.completedTime());
+    if (isRequested(Field::Tracker))
+        result.tracker = torrent.currentTracker();
+    if (isRequested(Field::TrackersCount))
+        result.trackersCount = torrent.trackers().size();
+    if (isRequested(Field::DownloadLimit))
+        result.downloadLimit = torrent.downloadLimit();
+    if (isRequested(Field::UploadLimit))
+        result.uploadLimit = torrent.uploadLimit();
+    if (isRequested(Field::AmountDownloaded))
+        result.amountDownloaded = torrent.totalDownload();
+    if (isRequested(Field::AmountUploaded))
+        result.amountUploaded = torrent.totalUpload();
+    if (isRequested(Field::AmountDownloadedSession))
+        result.amountDownloadedSession = torrent.totalPayloadDownload();
+    if (isRequested(Field::AmountUploadedSession))
+        result.amountUploadedSession = torrent.totalPayloadUpload();
+    if (isRequested(Field::AmountLeft))
+        result.amountLeft = torrent.remainingSize();
+    if (isRequested(Field::AmountCompleted))
+        result.amountCompleted = torrent.completedSize();
+    if (isRequested(Field::MaxRatio))
+        result.maxRatio = torrent.maxRatio();
+    if (isRequested(Field::MaxSeedingTime))
+        result.maxSeedingTime = torrent.maxSeedingTime();
+    if (isRequested(Field::MaxInactiveSeedingTime))
+        result.maxInactiveSeedingTime = torrent.maxInactiveSeedingTime();
+    if (isRequested(Field::Ratio))
+        result.ratio = adjustRatio(torrent.realRatio());
+    if (isRequested(Field::RatioLimit))
+        result.ratioLimit = torrent.ratioLimit();
+    if (isRequested(Field::Popularity))
+        result.popularity = torrent.popularity();
+    if (isRequested(Field::SeedingTimeLimit))
+        result.seedingTimeLimit = torrent.seedingTimeLimit();
+    if (isRequested(Field::InactiveSeedingTimeLimit))
+        result.inactiveSeedingTimeLimit = torrent.inactiveSeedingTimeLimit();
+    if (isRequested(Field::LastSeenCompleteTime))
+        result.lastSeenComplete = Utils::DateTime::toSecsSinceEpoch(torrent.lastSeenComplete());
+    if (isRequested(Field::AutoTorrentManagement))
+        result.isAutoTMMEnabled = torrent.isAutoTMMEnabled();
+    if (isRequested(Field::TimeActive))
+        result.timeActive = torrent.activeTime();
+    if (isRequested(Field::SeedingTime))
+        result.seedingTime = torrent.finishedTime();
+    if (isRequested(Field::LastActivityTime))
+        result.lastActivity = getLastActivityTime();
+    if (isRequested(Field::Availability))
+        result.availability = torrent.distributedCopies();
+    if (isRequested(Field::Reannounce))
+        result.reannounce = torrent.nextAnnounce();
+    if (isRequested(Field::Comment))
+        result.comment = torrent.comment();
+    if (isRequested(Field::Private))
+        result.isPrivate = (torrent.hasMetadata() ? std::optional<bool>(torrent.isPrivate()) : std::nullopt);
+    if (isRequested(Field::TotalSize))
+        result.totalSize = torrent.totalSize();
+    if (isRequested(Field::HasMetadata))
+        result.hasMetadata = torrent.hasMetadata();
+    return result;
+}
+
+SerializedTorrent::Fields changedFields(const SerializedTorrent &prevTorrent, const SerializedTorrent &torrent)
+{
+    SerializedTorrent::Fields fields;
+    visitFields([&fields](const SerializedTorrent::Field field, [[maybe_unused]] const QString &key, const auto &prevValue, const auto &value)
+    {
+        if (!(prevValue == value))
+            fields.set(static_cast<std::size_t>(field));
+    }, prevTorrent, torrent);
+
+    return fields;
+}
+
+void writeFields(Utils::Json::Writer &writer, const SerializedTorrent &torrent, const SerializedTorrent::Fields &fields)
+{
+    writeFieldsImpl(writer, torrent, fields);
+}
+
+void writeFields(Utils::Cbor::Writer &writer, const SerializedTorrent &torrent, const SerializedTorrent::Fields &fields)
+{
+    writeFieldsImpl(writer, torrent, fields);
+}
+
+std::optional<SerializedTorrent::Field> fieldFromKey(const QString &key)
+{
+    static const QHash<QString, SerializedTorrent::Field> fieldsByKey = []
+    {
+        QHash<QString, SerializedTorrent::Field> result;
+        visitFields([&result](const SerializedTorrent::Field field, const QString &key, [[maybe_unused]] const auto &value)
+        {
+            result.insert(key, field);
+        }, SerializedTorrent());
+        return result;
+    }();
+
+    if (const auto iter = fieldsByKey.constFind(key); iter != fieldsByKey.cend())
+        return iter.value();
+    return std::nullopt;
+}
+
+SerializedTorrentSortKey sortKey(const SerializedTorrent &torrent, const SerializedTorrent::Field field)
+{
+    SerializedTorrentSortKey result;
+    visitFields([&result, field](const SerializedTorrent::Field currentField, [[maybe_unused]] const QString &key, const auto &value)
+    {
+        if (currentField == field)
+            result = toSortKey(value);
+    }, torrent);
+
+    return result;
+}
+
+std::pair<qsizetype, qsizetype> pageRange(const qsizetype size, const int offset, const int limit)
+{
+    // the parameters come from the client, so they are widened before any arithmetic
+    qsizetype begin = offset;
+    if (begin < 0)
+        begin += size;
+    if ((begin >= size) || (begin < 0))
+        begin = 0;
+
+    const qsizetype end = (limit > 0) ? std::min((begin + limit), size) : size;
+    return {begin, end};
+}
+
+QList<qsizetype> sortedPageIndexes(const QList<SerializedTorrentSortKey> &sortKeys, const bool reverse, const int offset, const int limit)
+{
+    const qsizetype size = sortKeys.size();
+    const auto [pageBegin, pageEnd] = pageRange(size, offset, limit);
+
+    std::vector<qsizetype> indexes(size);
+    std::iota(indexes.begin(), indexes.end(), 0);
+
+    const auto lessThan = [&sortKeys, reverse](const qsizetype left, const qsizetype right) -> bool
+    {
+        const SerializedTorrentSortKey &leftKey = sortKeys[left];
+        const SerializedTorrentSortKey &rightKey = sortKeys[right];
+        if (leftKey != rightKey)
+            return reverse ? (rightKey < leftKey) : (leftKey < rightKey);
+        return left < right;
     };
+
+    // only the requested page needs to be in order
+    if (pageEnd < size)
+        std::partial_sort(indexes.begin(), (indexes.begin() + pageEnd), indexes.end(), lessThan);
+    else
+        std::sort(indexes.begin(), indexes.end(), lessThan);
+
+    return QList<qsizetype>((indexes.cbegin() + pageBegin), (indexes.cbegin() + pageEnd));
+}
+
+QVariantMap toVariantMap(const SerializedTorrent &torrent)
+{
+    QVariantMap result;
+    visitFields([&result]([[maybe_unused]] const SerializedTorrent::Field field, const QString &key, const auto &value)
+    {
+        result.insert(key, toVariant(value));
+    }, torrent);
+
+    return result;
+}
+
+QVariantMap serialize(const BitTorrent::Torrent &torrent)
+{
+    QVariantMap result = toVariantMap(serializeTorrent(torrent));
+    result.insert(KEY_TORRENT_ID, torrent.id().toString());
+    return result;
 }
@@ -28,13 +28,28 @@
 
 #pragma once
 
+#include <bitset>
+#include <optional>
+#include <utility>
+#include <variant>
+
+#include <QList>
+#include <QString>
 #include <QVariant>
 
+#include "base/bittorrent/torrent.h"
 #include "base/global.h"
+#include "base/path.h"
+#include "base/tagset.h"
+
+namespace Utils::Cbor
+{
+    class Writer;
+}
 
-namespace BitTorrent
+namespace Utils::Json
 {
-    class Torrent;
+    class Writer;
 }
 
 // Torrent keys
@@ -97,4 +112,152 @@ inline const QString KEY_TORRENT_COMMENT = u"comment"_s;
 inline const QString KEY_TORRENT_PRIVATE = u"private"_s;
 inline const QString KEY_TORRENT_HAS_METADATA = u"has_metadata"_s;
 
+// Torrent data in native types, so that its states can be compared field by field
+// and written as JSON without intermediate QVariant/QJsonObject
+struct SerializedTorrent
+{
+    // Field IDs, they are also the bit positions in Fields
+    enum class Field
+    {
+        InfoHashV1,
+        InfoHashV2,
+        Name,
+        MagnetURI,
+        Size,
+        Progress,
+        DownloadSpeed,
+        UploadSpeed,
+        QueuePosition,
+        Seeds,
+        NumComplete,
+        Leechs,
+        NumIncomplete,
+        State,
+        ETA,
+        SequentialDownload,
+        FirstLastPiecePrio,
+        Category,
+        Tags,
+        SuperSeeding,
+        ForceStart,
+        SavePath,
+        DownloadPath,
+        ContentPath,
+        RootPath,
+        AddedOn,
+        CompletionOn,
+        Tracker,
+        TrackersCount,
+        DownloadLimit,
+        UploadLimit,
+        AmountDownloaded,
+        AmountUploaded,
+        AmountDownloadedSession,
+        AmountUploadedSession,
+        AmountLeft,
+        AmountCompleted,
+        MaxRatio,
+        MaxSeedingTime,
+        MaxInactiveSeedingTime,
+        Ratio,
+        RatioLimit,
+        Popularity,
+        SeedingTimeLimit,
+        InactiveSeedingTimeLimit,
+        LastSeenCompleteTime,
+        AutoTorrentManagement,
+        TimeActive,
+        SeedingTime,
+        LastActivityTime,
+        Availability,
+        Reannounce,
+        Comment,
+        Private,
+        TotalSize,
+        HasMetadata,
+
+        Count
+    };
+
+    using Fields = std::bitset<static_cast<std::size_t>(Field::Count)>;
+
+    QString infoHashV1;
+    QString infoHashV2;
+    QString name;
+    QString magnetURI;
+    qlonglong size = 0;
+    qreal progress = 0;
+    int downloadSpeed = 0;
+    int uploadSpeed = 0;
+    int queuePosition = 0;
+    int seeds = 0;
+    int numComplete = 0;
+    int leechs = 0;
+    int numIncomplete = 0;
+    BitTorrent::TorrentState state = BitTorrent::TorrentState::Unknown;
+    qlonglong eta = 0;
+    bool isSequentialDownload = false;
+    bool hasFirstLastPiecePriority = false;
+    QString category;
+    TagSet tags;
+    bool isSuperSeeding = false;
+    bool isForced = false;
+    Path savePath;
+    Path downloadPath;
+    Path contentPath;
+    Path rootPath;
+    qint64 addedOn = 0;
+    qint64 completionOn = 0;
+    QString tracker;
+    qsizetype trackersCount = 0;
+    int downloadLimit = 0;
+    int uploadLimit = 0;
+    qlonglong amountDownloaded = 0;
+    qlonglong amountUploaded = 0;
+    qlonglong amountDownloadedSession = 0;
+    qlonglong amountUploadedSession = 0;
+    qlonglong amountLeft = 0;
+    qlonglong amountCompleted = 0;
+    qreal maxRatio = 0;
+    int maxSeedingTime = 0;
+    int maxInactiveSeedingTime = 0;
+    qreal ratio = 0;
+    qreal ratioLimit = 0;
+    qreal popularity = 0;
+    int seedingTimeLimit = 0;
+    int inactiveSeedingTimeLimit = 0;
+    qint64 lastSeenComplete = 0;
+    bool isAutoTMMEnabled = false;
+    qlonglong timeActive = 0;
+    qlonglong seedingTime = 0;
+    qlonglong lastActivity = 0;
+    qreal availability = 0;
+    qlonglong reannounce = 0;
+    QString comment;
+    std::optional<bool> isPrivate;
+    qlonglong totalSize = 0;
+    bool hasMetadata = false;
+};
+
+// Value of a single field which can be compared regardless of its type,
+// fields that are written as strings are compared as strings
+using SerializedTorrentSortKey = std::variant<std::monostate, bool, qlonglong, qreal, QString>;
+
+SerializedTorrent serializeTorrent(const BitTorrent::Torrent &torrent);
+// only the given fields are computed, the others keep their default values
+SerializedTorrent serializeTorrent(const BitTorrent::Torrent &torrent, const SerializedTorrent::Fields &fields);
+std::optional<SerializedTorrent::Field> fieldFromKey(const QString &key);
+SerializedTorrentSortKey sortKey(const SerializedTorrent &torrent, SerializedTorrent::Field field);
+// returns the [begin, end) range of the page of the list of the given size, negative offset
+// counts from the end of the list, non-positive limit means the page lasts until the end
+std::pair<qsizetype, qsizetype> pageRange(qsizetype size, int offset, int limit);
+// returns the indexes of the items in the page of the list sorted by the given keys,
+// items with equal keys keep their original order so that consecutive pages don't overlap
+QList<qsizetype> sortedPageIndexes(const QList<SerializedTorrentSortKey> &sortKeys, bool reverse, int offset, int limit);
+SerializedTorrent::Fields changedFields(const SerializedTorrent &prevTorrent, const SerializedTorrent &torrent);
+// writes the given fields as the members of the current JSON object
+void writeFields(Utils::Json::Writer &writer, const SerializedTorrent &torrent, const SerializedTorrent::Fields &fields);
+void writeFields(Utils::Cbor::Writer &writer, const SerializedTorrent &torrent, const SerializedTorrent::Fields &fields);
+QVariantMap toVariantMap(const SerializedTorrent &torrent);
+
 QVariantMap serialize(const BitTorrent::Torrent &torrent);
@@ -29,8 +29,8 @@
 #include "synccontroller.h"
 
 #include <algorithm>
+#include <utility>
 
-#include <QJsonArray>
 #include <QJsonObject>
 #include <QMetaObject>
 
@@ -45,11 +45,14 @@
 #include "base/bittorrent/torrentinfo.h"
 #include "base/bittorrent/trackerentrystatus.h"
 #include "base/global.h"
+#include "base/http/eventstream.h"
+#include "base/http/responsegenerator.h"
 #include "base/net/geoipmanager.h"
 #include "base/preferences.h"
+#include "base/utils/cbor.h"
+#include "base/utils/json.h"
 #include "base/utils/string.h"
 #include "apierror.h"
-#include "serialize/serialize_torrent.h"
 
 namespace
 {
@@ -59,6 +62,11 @@ namespace
     const QString KEY_SYNC_MAINDATA_USE_ALT_SPEED_LIMITS = u"use_alt_speed_limits"_s;
     const QString KEY_SYNC_MAINDATA_USE_SUBCATEGORIES = u"use_subcategories"_s;
 
+    // Sync main data stream event type
+    const QString EVENT_SYNC_MAINDATA = u"maindata"_s;
+
+    const SerializedTorrent::Fields ALL_TORRENT_FIELDS = SerializedTorrent::Fields().set();
+
     // Sync torrent peers keys
     const QString KEY_SYNC_TORRENT_PEERS_SHOW_FLAGS = u"show_flags"_s;
 
@@ -92,13 +100,21 @@ namespace
     const QString KEY_TRANSFER_UPSPEED = u"up_info_speed"_s;
 
     // Statistics keys
+    const QString KEY_TRANSFER_ALERT_RATES = u"alert_rates"_s;
     const QString KEY_TRANSFER_ALLTIME_DL = u"alltime_dl"_s;
     const QString KEY_TRANSFER_ALLTIME_UL = u"alltime_ul"_s;
     const QString KEY_TRANSFER_AVERAGE_TIME_QUEUE = u"average_time_queue"_s;
     const QString KEY_TRANSFER_GLOBAL_RATIO = u"global_ratio"_s;
+    const QString KEY_TRANSFER_METADATA_CACHE_HITS = u"metadata_cache_hits"_s;
+    const QString KEY_TRANSFER_METADATA_CACHE_MISSES = u"metadata_cache_misses"_s;
+    const QString KEY_TRANSFER_TORRENT_CACHED_VALUE_HITS = u"torrent_cached_value_hits"_s;
+    const QString KEY_TRANSFER_TORRENT_CACHED_VALUE_MISSES = u"torrent_cached_value_misses"_s;
+    const QString KEY_TRANSFER_HTTP_COMPRESSIONS = u"http_compressions"_s;
+    const QString KEY_TRANSFER_HTTP_COMPRESSION_TIME = u"http_compression_time"_s;
     const QString KEY_TRANSFER_QUEUED_IO_JOBS = u"queued_io_jobs"_s;
     const QString KEY_TRANSFER_READ_CACHE_HITS = u"read_cache_hits"_s;
     const QString KEY_TRANSFER_READ_CACHE_OVERLOAD = u"read_cache_overload"_s;
+    const QString KEY_TRANSFER_READ_CACHE_SIZE = u"read_cache_size"_s;
     const QString KEY_TRANSFER_TOTAL_BUFFERS_SIZE = u"total_buffers_size"_s;
     const QString KEY_TRANSFER_TOTAL_PEER_CONNECTIONS = u"total_peer_connections"_s;
     const QString KEY_TRANSFER_TOTAL_QUEUED_SIZE = u"total_queued_size"_s;
@@ -146,8 +162,9 @@ namespace
         map[KEY_TRANSFER_GLOBAL_RATIO] = ((atd > 0) && (atu > 0)) ? Utils::String::fromDouble(static_cast<qreal>(atu) / atd, 2) : u"-"_s;
         map[KEY_TRANSFER_TOTAL_PEER_CONNECTIONS] = sessionStatus.peersCount;
 
-        const qreal readRatio = cacheStatus.readRatio;  // TODO: remove when LIBTORRENT_VERSION_NUM >= 20000
+        const qreal readRatio = cacheStatus.readRatio;
         map[KEY_TRANSFER_READ_CACHE_HITS] = (readRatio > 0) ? Utils::String::fromDouble(100 * readRatio, 2) : u"0"_s;
+        map[KEY_TRANSFER_READ_CACHE_SIZE] = cacheStatus.readCacheSize;
         map[KEY_TRANSFER_TOTAL_BUFFERS_SIZE] = cacheStatus.totalUsedBuffers * 16 * 1024;
 
         map[KEY_TRANSFER_WRITE_CACHE_OVERLOAD] = ((sessionStatus.diskWriteQueue > 0) && (sessionStatus.peersCount > 0))
@@ -160,6 +177,19 @@ namespace
         map[KEY_TRANSFER_QUEUED_IO_JOBS] = cacheStatus.jobQueueLength;
         map[KEY_TRANSFER_AVERAGE_TIME_QUEUE] = cacheStatus.averageJobTime;
         map[KEY_TRANSFER_TOTAL_QUEUED_SIZE] = cacheStatus.queuedBytes;
+        map[KEY_TRANSFER_METADATA_CACHE_HITS] = sessionStatus.metadataCacheHits;
+        map[KEY_TRANSFER_METADATA_CACHE_MISSES] = sessionStatus.metadataCacheMisses;
+        map[KEY_TRANSFER_TORRENT_CACHED_VALUE_HITS] = sessionStatus.torrentCachedValueHits;
+        map[KEY_TRANSFER_TORRENT_CACHED_VALUE_MISSES] = sessionStatus.torrentCachedValueMisses;
+
+        const Http::CompressionStatistics compressionStatistics = Http::compressionStatistics();
+        map[KEY_TRANSFER_HTTP_COMPRESSIONS] = compressionStatistics.count;
+        map[KEY_TRANSFER_HTTP_COMPRESSION_TIME] = compressionStatistics.totalTime / 1000;  // in milliseconds
+
+        QVariantMap alertRates;
+        for (auto it = sessionStatus.alertRates.cbegin(); it != sessionStatus.alertRates.cend(); ++it)
+            alertRates[it.key()] = it.value();
+        map[KEY_TRANSFER_ALERT_RATES] = alertRates;
 
         map[KEY_TRANSFER_DHT_NODES] = sessionStatus.dhtNodes;
         map[KEY_TRANSFER_CONNECTION_STATUS] = session->isListening()
@@ -383,6 +413,103 @@ namespace
 
         return QJsonObject::fromVariantMap(syncData);
     }
+
+    template <typename Writer>
+    void writeMaindataSyncBuf(Writer &writer, const MaindataSyncBuf &syncBuf, const int id, const bool fullUpdate)
+    {
+        const auto writeStringListItem = [&writer](const QString &key, const QStringList &list)
+        {
+            if (list.isEmpty())
+                return;
+
+            writer.writeKey(key);
+            writer.writeStringList(list);
+        };
+
+        writer.beginObject();
+
+        writer.writeKey(KEY_RESPONSE_ID);
+        writer.writeInt(id);
+        if (fullUpdate)
+        {
+            writer.writeKey(KEY_FULL_UPDATE);
+            writer.writeBool(true);
+        }
+
+        if (!syncBuf.categories.isEmpty())
+        {
+            writer.writeKey(KEY_CATEGORIES);
+            writer.beginObject();
+            for (auto it = syncBuf.categories.cbegin(); it != syncBuf.categories.cend(); ++it)
+            {
+                writer.writeKey(it.key());
+                writer.writeVariant(it.value());
+            }
+            writer.endObject();
+        }
+        writeStringListItem(KEY_CATEGORIES_REMOVED, syncBuf.removedCategories);
+
+        if (!syncBuf.tags.isEmpty())
+        {
+            writer.writeKey(KEY_TAGS);
+            writer.writeVariant(syncBuf.tags);
+        }
+        writeStringListItem(KEY_TAGS_REMOVED, syncBuf.removedTags);
+
+        if (!syncBuf.torrents.isEmpty())
+        {
+            writer.writeKey(KEY_TORRENTS);
+            writer.beginObject();
+            for (auto it = syncBuf.torrents.cbegin(); it != syncBuf.torrents.cend(); ++it)
+            {
+                writer.writeKey(it.key());
+                writer.beginObject();
+                writeFields(writer, it->torrent, it->changedFields);
+                writer.endObject();
+            }
+            writer.endObject();
+        }
+        writeStringListItem(KEY_TORRENTS_REMOVED, syncBuf.removedTorrents);
+
+        if (!syncBuf.trackers.isEmpty())
+        {
+            writer.writeKey(KEY_TRACKERS);
+            writer.beginObject();
+            for (auto it = syncBuf.trackers.cbegin(); it != syncBuf.trackers.cend(); ++it)
+            {
+                writer.writeKey(it.key());
+                writer.writeStringList(it.value());
+            }
+            writer.endObject();
+        }
+        writeStringListItem(KEY_TRACKERS_REMOVED, syncBuf.removedTrackers);
+
+        if (!syncBuf.serverState.isEmpty())
+        {
+            writer.writeKey(KEY_SERVER_STATE);
+            writer.writeVariant(syncBuf.serverState);
+        }
+
+        writer.endObject();
+    }
+
+    QByteArray serializeMaindataSyncBuf(const MaindataSyncBuf &syncBuf, const int id, const bool fullUpdate
+            , const APIResultFormat format = APIResultFormat::JSON)
+    {
+        // most of the data is taken by torrents, it is about 1 KiB per torrent in full
+        const qsizetype reserveSize = (syncBuf.torrents.size() + 1) * (fullUpdate ? 1024 : 128);
+
+        if (format != APIResultFormat::JSON)
+        {
+            Utils::Cbor::Writer writer {reserveSize, (format == APIResultFormat::CBORWithStringRefs)};
+            writeMaindataSyncBuf(writer, syncBuf, id, fullUpdate);
+            return writer.takeData();
+        }
+
+        Utils::Json::Writer writer {reserveSize};
+        writeMaindataSyncBuf(writer, syncBuf, id, fullUpdate);
+        return writer.takeData();
+    }
 }
 
 SyncController::SyncController(IApplication *app, QObject *parent)
@@ -390,9 +517,29 @@ SyncController::SyncController(IApplication *app, QObject *parent)
 {
 }
 
-void SyncController::updateFreeDiskSpace(const qint64 freeDiskSpace)
+SyncController::~SyncController()
 {
-    m_freeDiskSpace = freeDiskSpace;
+    for (const QPointer<Http::EventStream> &stream : asConst(m_sessionMaindataStreams))
+    {
+        if (stream)
+            stream->close();
+    }
+
+    if (m_maindataTracker)
+        m_maindataTracker->removeClient(this);
+}
+
+void SyncController::setMaindataTracker(MaindataTracker *tracker)
+{
+    m_maindataTracker = tracker;
+}
+
+// The controller that isn't given the shared tracker, tracks maindata on its own
+MaindataTracker *SyncController::maindataTracker()
+{
+    if (!m_maindataTracker)
+        m_maindataTracker = new MaindataTracker(this);
+    return m_maindataTracker;
 }
 
 // The function returns the changed data from the server to synchronize with the web client.
@@ -460,60 +607,269 @@ void SyncController::updateFreeDiskSpace(const qint64 freeDiskSpace)
 //   - rid (int): last response id
 void SyncController::maindataAction()
 {
-    if (m_maindataAcceptedID < 0)
-    {
-        makeMaindataSnapshot();
-
-        const auto *btSession = BitTorrent::Session::instance();
-        connect(btSession, &BitTorrent::Session::categoryAdded, this, &SyncController::onCategoryAdded);
-        connect(btSession, &BitTorrent::Session::categoryRemoved, this, &SyncController::onCategoryRemoved);
-        connect(btSession, &BitTorrent::Session::categoryOptionsChanged, this, &SyncController::onCategoryOptionsChanged);
-        connect(btSession, &BitTorrent::Session::subcategoriesSupportChanged, this, &SyncController::onSubcategoriesSupportChanged);
-        connect(btSession, &BitTorrent::Session::tagAdded, this, &SyncController::onTagAdded);
-        connect(btSession, &BitTorrent::Session::tagRemoved, this, &SyncController::onTagRemoved);
-        connect(btSession, &BitTorrent::Session::torrentAdded, this, &SyncController::onTorrentAdded);
-        connect(btSession, &BitTorrent::Session::torrentAboutToBeRemoved, this, &SyncController::onTorrentAboutToBeRemoved);
-        connect(btSession, &BitTorrent::Session::torrentCategoryChanged, this, &SyncController::onTorrentCategoryChanged);
-        connect(btSession, &BitTorrent::Session::torrentMetadataReceived, this, &SyncController::onTorrentMetadataReceived);
-        connect(btSession, &BitTorrent::Session::torrentStopped, this, &SyncController::onTorrentStopped);
-        connect(btSession, &BitTorrent::Session::torrentStarted, this, &SyncController::onTorrentStarted);
-        connect(btSession, &BitTorrent::Session::torrentSavePathChanged, this, &SyncController::onTorrentSavePathChanged);
-        connect(btSession, &BitTorrent::Session::torrentSavingModeChanged, this, &SyncController::onTorrentSavingModeChanged);
-        connect(btSession, &BitTorrent::Session::torrentTagAdded, this, &SyncController::onTorrentTagAdded);
-        connect(btSession, &BitTorrent::Session::torrentTagRemoved, this, &SyncController::onTorrentTagRemoved);
-        connect(btSession, &BitTorrent::Session::torrentsUpdated, this, &SyncController::onTorrentsUpdated);
-        connect(btSession, &BitTorrent::Session::trackersAdded, this, &SyncController::onTorrentTrackersChanged);
-        connect(btSession, &BitTorrent::Session::trackersRemoved, this, &SyncController::onTorrentTrackersChanged);
-        connect(btSession, &BitTorrent::Session::trackersChanged, this, &SyncController::onTorrentTrackersChanged);
-    }
+    MaindataTracker *tracker = maindataTracker();
+    tracker->addClient(this);
 
     const int acceptedID = params()[u"rid"_s].toInt();
-    bool fullUpdate = true;
+    const int id = tracker->updateSnapshot();
+    const QString &resultContentType = (resultFormat() != APIResultFormat::JSON)
+        ? Http::CONTENT_TYPE_CBOR : Http::CONTENT_TYPE_JSON;
+
     if ((acceptedID > 0) && (m_maindataLastSentID > 0))
     {
         if (m_maindataLastSentID == acceptedID)
-        {
             m_maindataAcceptedID = acceptedID;
-            m_maindataSyncBuf = {};
-        }
 
-        if (m_maindataAcceptedID == acceptedID)
+        // We are still able to send changes for the current state of the data having by client
+        // unless they have already been dropped from the log.
+        MaindataSyncBuf syncBuf;
+        if ((m_maindataAcceptedID == acceptedID) && tracker->collectChanges(acceptedID, id, syncBuf))
         {
-            // We are still able to send changes for the current state of the data having by client.
-            fullUpdate = false;
+            setDeferredResult([syncBuf = std::move(syncBuf), id, format = resultFormat()]
+            {
+                return serializeMaindataSyncBuf(syncBuf, id, false, format);
+            }, resultContentType);
+            m_maindataLastSentID = id;
+            return;
         }
     }
 
-    const int id = (m_maindataLastSentID % 1000000) + 1;  // cycle between 1 and 1000000
-    setResult(generateMaindataSyncData(id, fullUpdate));
+    // the copy of the snapshot shares its data until the tracker changes it,
+    // so it is serialized outside of the main thread as it is now
+    setDeferredResult([syncBuf = tracker->snapshot(), id, format = resultFormat()]
+    {
+        return serializeMaindataSyncBuf(syncBuf, id, true, format);
+    }, resultContentType);
     m_maindataLastSentID = id;
 }
 
-void SyncController::makeMaindataSnapshot()
+// Keeps the connection open and pushes the maindata as Server-Sent Events of "maindata" type.
+// The first event contains the full data, the following ones contain the changes in the format
+// of "maindata" action response, so the client never needs to send the response ID back.
+// The changes are tracked once for all the streams, the client that can't keep up with receiving
+// them gets the full data again instead of the changes it missed.
+// The stream is closed when the session it is opened in ends.
+void SyncController::maindataStreamAction()
+{
+    m_sessionMaindataStreams.removeIf([](const QPointer<Http::EventStream> &stream) { return stream.isNull(); });
+
+    Http::EventStream *stream = maindataTracker()->openStream();
+    m_sessionMaindataStreams.append(stream);
+    setResult(stream);
+}
+
+// GET param:
+//   - hash (string): torrent hash (ID)
+//   - rid (int): last response id
+void SyncController::torrentPeersAction()
+{
+    const auto id = BitTorrent::TorrentID::fromString(params()[u"hash"_s]);
+    const BitTorrent::Torrent *torrent = BitTorrent::Session::instance()->getTorrent(id);
+    if (!torrent)
+        throw APIError(APIErrorType::NotFound);
+
+    QVariantMap data;
+    QVariantHash peers;
+
+    const QList<BitTorrent::PeerInfo> peersList = torrent->peers();
+
+    bool resolvePeerCountries = Preferences::instance()->resolvePeerCountries();
+
+    data[KEY_SYNC_TORRENT_PEERS_SHOW_FLAGS] = resolvePeerCountries;
+
+    for (const BitTorrent::PeerInfo &pi : peersList)
+    {
+        if (pi.address().ip.isNull()) continue;
+
+        QVariantMap peer =
+        {
+            {KEY_PEER_IP, pi.address().ip.toString()},
+            {KEY_PEER_PORT, pi.address().port},
+            {KEY_PEER_CLIENT, pi.client()},
+            {KEY_PEER_ID_CLIENT, pi.peerIdClient()},
+            {KEY_PEER_PROGRESS, pi.progress()},
+            {KEY_PEER_DOWN_SPEED, pi.payloadDownSpeed()},
+            {KEY_PEER_UP_SPEED, pi.payloadUpSpeed()},
+            {KEY_PEER_TOT_DOWN, pi.totalDownload()},
+            {KEY_PEER_TOT_UP, pi.totalUpload()},
+            {KEY_PEER_CONNECTION_TYPE, pi.connectionType()},
+            {KEY_PEER_FLAGS, pi.flags()},
+            {KEY_PEER_FLAGS_DESCRIPTION, pi.flagsDescription()},
+            {KEY_PEER_RELEVANCE, pi.relevance()}
+        };
+
+        if (torrent->hasMetadata())
+        {
+            const PathList filePaths = torrent->info().filesForPiece(pi.downloadingPieceIndex());
+            QStringList filesForPiece;
+            filesForPiece.reserve(filePaths.size());
+            for (const Path &filePath : filePaths)
+                filesForPiece.append(filePath.toString());
+            peer.insert(KEY_PEER_FILES, filesForPiece.join(u'\n'));
+        }
+
+        if (resolvePeerCountries)
+        {
+            peer[KEY_PEER_COUNTRY_CODE] = pi.country().toLower();
+            peer[KEY_PEER_COUNTRY] = Net::GeoIPManager::CountryName(pi.country());
+        }
+
+        peers[pi.address().toString()] = peer;
+    }
+    data[u"peers"_s] = peers;
+
+    const int acceptedResponseId = params()[u"rid"_s].toInt();
+    setResult(generateSyncData(acceptedResponseId, data, m_lastAcceptedPeersResponse, m_lastPeersResponse));
+}
+
+void MaindataTracker::addClient(const SyncController *client)
+{
+    m_clients.insert(client);
+}
+
+void MaindataTracker::removeClient(const SyncController *client)
+{
+    m_clients.remove(client);
+    if (!m_clients.isEmpty())
+        return;
+
+    m_streams.removeIf([](const QPointer<Http::EventStream> &stream) { return stream.isNull(); });
+    if (m_streams.isEmpty())
+        stopTracking();
+}
+
+const MaindataSyncBuf &MaindataTracker::snapshot() const
+{
+    return m_snapshot;
+}
+
+bool MaindataTracker::collectChanges(const int fromID, const int toID, MaindataSyncBuf &syncBuf) const
+{
+    return m_changeLog.collectChanges(fromID, toID, syncBuf);
+}
+
+void MaindataTracker::updateFreeDiskSpace(const qint64 freeDiskSpace)
+{
+    m_freeDiskSpace = freeDiskSpace;
+}
+
+Http::EventStream *MaindataTracker::openStream()
+{
+    updateSnapshot();
+
+    if (m_streams.isEmpty())
+    {
+        m_streamLastSentID = m_snapshotID;
+        // changes are accumulated since the last broadcast so the snapshot can be brought up to date
+        connect(BitTorrent::Session::instance(), &BitTorrent::Session::statsUpdated
+                , this, &MaindataTracker::broadcast, Qt::QueuedConnection);
+    }
+
+    auto *stream = new Http::EventStream(this);
+    // the stream can get some of these changes again with the next broadcast, that's harmless
+    stream->send(EVENT_SYNC_MAINDATA, serializeMaindataSyncBuf(m_snapshot, m_snapshotID, true));
+
+    m_streams.append(stream);
+    return stream;
+}
+
+void MaindataTracker::broadcast()
+{
+    m_streams.removeIf([](const QPointer<Http::EventStream> &stream) { return stream.isNull(); });
+    if (m_streams.isEmpty())
+    {
+        disconnect(BitTorrent::Session::instance(), &BitTorrent::Session::statsUpdated
+                , this, &MaindataTracker::broadcast);
+        if (m_clients.isEmpty())
+            stopTracking();
+        return;
+    }
+
+    const int id = updateSnapshot();
+    MaindataSyncBuf syncBuf;
+    const bool hasChanges = (id != m_streamLastSentID);
+    const bool isChangeLogValid = m_changeLog.collectChanges(m_streamLastSentID, id, syncBuf);
+    m_streamLastSentID = id;
+
+    QByteArray changesData;
+    if (hasChanges && isChangeLogValid)
+        changesData = serializeMaindataSyncBuf(syncBuf, id, false);
+    QByteArray fullData;
+
+    for (const QPointer<Http::EventStream> &stream : asConst(m_streams))
+    {
+        if (stream->isOverflowed() || !isChangeLogValid)
+        {
+            if (fullData.isEmpty())
+                fullData = serializeMaindataSyncBuf(m_snapshot, id, true);
+
+            if (stream->send(EVENT_SYNC_MAINDATA, fullData))
+                stream->resetOverflow();
+        }
+        else if (hasChanges)
+        {
+            stream->send(EVENT_SYNC_MAINDATA, changesData);
+        }
+    }
+}
+
+void MaindataTracker::startTracking()
+{
+    makeSnapshot();
+
+    const auto *btSession = BitTorrent::Session::instance();
+    connect(btSession, &BitTorrent::Session::categoryAdded, this, &MaindataTracker::onCategoryAdded);
+    connect(btSession, &BitTorrent::Session::categoryRemoved, this, &MaindataTracker::onCategoryRemoved);
+    connect(btSession, &BitTorrent::Session::categoryOptionsChanged, this, &MaindataTracker::onCategoryOptionsChanged);
+    connect(btSession, &BitTorrent::Session::subcategoriesSupportChanged, this, &MaindataTracker::onSubcategoriesSupportChanged);
+    connect(btSession, &BitTorrent::Session::tagAdded, this, &MaindataTracker::onTagAdded);
+    connect(btSession, &BitTorrent::Session::tagRemoved, this, &MaindataTracker::onTagRemoved);
+    connect(btSession, &BitTorrent::Session::torrentAdded, this, &MaindataTracker::onTorrentAdded);
+    connect(btSession, &BitTorrent::Session::torrentAboutToBeRemoved, this, &MaindataTracker::onTorrentAboutToBeRemoved);
+    connect(btSession, &BitTorrent::Session::torrentCategoryChanged, this, &MaindataTracker::onTorrentCategoryChanged);
+    connect(btSession, &BitTorrent::Session::torrentMetadataReceived, this, &MaindataTracker::onTorrentMetadataReceived);
+    connect(btSession, &BitTorrent::Session::torrentStopped, this, &MaindataTracker::onTorrentStopped);
+    connect(btSession, &BitTorrent::Session::torrentStarted, this, &MaindataTracker::onTorrentStarted);
+    connect(btSession, &BitTorrent::Session::torrentSavePathChanged, this, &MaindataTracker::onTorrentSavePathChanged);
+    connect(btSession, &BitTorrent::Session::torrentSavingModeChanged, this, &MaindataTracker::onTorrentSavingModeChanged);
+    connect(btSession, &BitTorrent::Session::torrentTagAdded, this, &MaindataTracker::onTorrentTagAdded);
+    connect(btSession, &BitTorrent::Session::torrentTagRemoved, this, &MaindataTracker::onTorrentTagRemoved);
+    connect(btSession, &BitTorrent::Session::torrentsUpdated, this, &MaindataTracker::onTorrentsUpdated);
+    connect(btSession, &BitTorrent::Session::trackersAdded, this, &MaindataTracker::onTorrentTrackersChanged);
+    connect(btSession, &BitTorrent::Session::trackersRemoved, this, &MaindataTracker::onTorrentTrackersChanged);
+    connect(btSession, &BitTorrent::Session::trackersChanged, this, &MaindataTracker::onTorrentTrackersChanged);
+}
+
+// Nobody is interested in maindata anymore, so there is no need to keep the snapshot of it
+void MaindataTracker::stopTracking()
+{
+    if (m_snapshotID == 0)
+        return;
+
+    disconnect(BitTorrent::Session::instance(), nullptr, this, nullptr);
+
+    m_knownTrackers.clear();
+    m_updatedCategories.clear();
+    m_removedCategories.clear();
+    m_addedTags.clear();
+    m_removedTags.clear();
+    m_updatedTrackers.clear();
+    m_removedTrackers.clear();
+    m_updatedTorrents.clear();
+    m_removedTorrents.clear();
+
+    m_snapshot = {};
+    m_changeLog.clear();
+    m_snapshotID = 0;
+}
+
+void MaindataTracker::makeSnapshot()
 {
     m_knownTrackers.clear();
-    m_maindataAcceptedID = 0;
-    m_maindataSnapshot = {};
+    m_snapshot = {};
+    m_changeLog.clear();
+    // ID 0 is reserved for the clients that have no data yet
+    m_snapshotID = 1;
 
     const auto *session = BitTorrent::Session::instance();
 
@@ -521,13 +877,10 @@ void SyncController::makeMaindataSnapshot()
     {
         const BitTorrent::TorrentID torrentID = torrent->id();
 
-        QVariantMap serializedTorrent = serialize(*torrent);
-        serializedTorrent.remove(KEY_TORRENT_ID);
-
         for (const BitTorrent::TrackerEntryStatus &status : asConst(torrent->trackers()))
             m_knownTrackers[status.url].insert(torrentID);
 
-        m_maindataSnapshot.torrents[torrentID.toString()] = serializedTorrent;
+        m_snapshot.torrents[torrentID.toString()] = {serializeTorrent(*torrent), ALL_TORRENT_FIELDS};
     }
 
     const QStringList categoriesList = session->categories();
@@ -538,11 +891,11 @@ void SyncController::makeMaindataSnapshot()
         // adjust it to be compatible with existing WebAPI
         category[u"savePath"_s] = category.take(u"save_path"_s);
         category.insert(u"name"_s, categoryName);
-        m_maindataSnapshot.categories[categoryName] = category.toVariantMap();
+        m_snapshot.categories[categoryName] = category.toVariantMap();
     }
 
     for (const Tag &tag : asConst(session->tags()))
-        m_maindataSnapshot.tags.append(tag.toString());
+        m_snapshot.tags.append(tag.toString());
 
     for (auto trackersIter = m_knownTrackers.cbegin(); trackersIter != m_knownTrackers.cend(); ++trackersIter)
     {
@@ -550,39 +903,27 @@ void SyncController::makeMaindataSnapshot()
         for (const BitTorrent::TorrentID &torrentID : asConst(trackersIter.value()))
             torrentIDs.append(torrentID.toString());
 
-        m_maindataSnapshot.trackers[trackersIter.key()] = torrentIDs;
+        m_snapshot.trackers[trackersIter.key()] = torrentIDs;
     }
 
-    m_maindataSnapshot.serverState = getTransferInfo();
-    m_maindataSnapshot.serverState[KEY_TRANSFER_FREESPACEONDISK] = m_freeDiskSpace;
-    m_maindataSnapshot.serverState[KEY_SYNC_MAINDATA_QUEUEING] = session->isQueueingSystemEnabled();
-    m_maindataSnapshot.serverState[KEY_SYNC_MAINDATA_USE_ALT_SPEED_LIMITS] = session->isAltGlobalSpeedLimitEnabled();
-    m_maindataSnapshot.serverState[KEY_SYNC_MAINDATA_REFRESH_INTERVAL] = session->refreshInterval();
-    m_maindataSnapshot.serverState[KEY_SYNC_MAINDATA_USE_SUBCATEGORIES] = session->isSubcategoriesEnabled();
+    m_snapshot.serverState = getTransferInfo();
+    m_snapshot.serverState[KEY_TRANSFER_FREESPACEONDISK] = m_freeDiskSpace;
+    m_snapshot.serverState[KEY_SYNC_MAINDATA_QUEUEING] = session->isQueueingSystemEnabled();
+    m_snapshot.serverState[KEY_SYNC_MAINDATA_USE_ALT_SPEED_LIMITS] = session->isAltGlobalSpeedLimitEnabled();
+    m_snapshot.serverState[KEY_SYNC_MAINDATA_REFRESH_INTERVAL] = session->refreshInterval();
+    m_snapshot.serverState[KEY_SYNC_MAINDATA_USE_SUBCATEGORIES] = session->isSubcategoriesEnabled();
 }
 
-QJsonObject SyncController::generateMaindataSyncData(const int id, const bool fullUpdate)
+// Applies the tracked changes to the snapshot and appends them to the change log
+int MaindataTracker::updateSnapshot()
 {
-    // if need to update existing sync data
-    for (const QString &category : asConst(m_updatedCategories))
-        m_maindataSyncBuf.removedCategories.removeOne(category);
-    for (const QString &category : asConst(m_removedCategories))
-        m_maindataSyncBuf.categories.remove(category);
-
-    for (const QString &tag : asConst(m_addedTags))
-        m_maindataSyncBuf.removedTags.removeOne(tag);
-    for (const QString &tag : asConst(m_removedTags))
-        m_maindataSyncBuf.tags.removeOne(tag);
-
-    for (const BitTorrent::TorrentID &torrentID : asConst(m_updatedTorrents))
-        m_maindataSyncBuf.removedTorrents.removeOne(torrentID.toString());
-    for (const BitTorrent::TorrentID &torrentID : asConst(m_removedTorrents))
-        m_maindataSyncBuf.torrents.remove(torrentID.toString());
+    if (m_snapshotID == 0)
+    {
+        startTracking();
+        return m_snapshotID;
+    }
 
-    for (const QString &tracker : asConst(m_updatedTrackers))
-        m_maindataSyncBuf.removedTrackers.removeOne(tracker);
-    for (const QString &tracker : asConst(m_removedTrackers))
-        m_maindataSyncBuf.trackers.remove(tracker);
+    MaindataSyncBuf change;
 
     const auto *session = BitTorrent::Session::instance();
 
@@ -594,30 +935,33 @@ QJsonObject SyncController::generateMaindataSyncData(const int id, const bool fu
         category[u"savePath"_s] = category.take(u"save_path"_s);
         category.insert(u"name"_s, categoryName);
 
-        auto &categorySnapshot = m_maindataSnapshot.categories[categoryName];
-        processMap(categorySnapshot, category, m_maindataSyncBuf.categories[categoryName]);
+        auto &categorySnapshot = m_snapshot.categories[categoryName];
+        QVariantMap categoryChange;
+        processMap(categorySnapshot, category, categoryChange);
+        if (!categoryChange.isEmpty())
+            change.categories[categoryName] = categoryChange;
         categorySnapshot = category;
     }
     m_updatedCategories.clear();
 
     for (const QString &category : asConst(m_removedCategories))
     {
-        m_maindataSyncBuf.removedCategories.append(category);
-        m_maindataSnapshot.categories.remove(category);
+        change.removedCategories.append(category);
+        m_snapshot.categories.remove(category);
     }
     m_removedCategories.clear();
 
     for (const QString &tag : asConst(m_addedTags))
     {
-        m_maindataSyncBuf.tags.append(tag);
-        m_maindataSnapshot.tags.append(tag);
+        change.tags.append(tag);
+        m_snapshot.tags.append(tag);
     }
     m_addedTags.clear();
 
     for (const QString &tag : asConst(m_removedTags))
     {
-        m_maindataSyncBuf.removedTags.append(tag);
-        m_maindataSnapshot.tags.removeOne(tag);
+        change.removedTags.append(tag);
+        m_snapshot.tags.removeOne(tag);
     }
     m_removedTags.clear();
 
@@ -626,19 +970,29 @@ QJsonObject SyncController::generateMaindataSyncData(const int id, const bool fu
         const BitTorrent::Torrent *torrent = session->getTorrent(torrentID);
         Q_ASSERT(torrent);
 
-        QVariantMap serializedTorrent = serialize(*torrent);
-        serializedTorrent.remove(KEY_TORRENT_ID);
+        SerializedTorrent serializedTorrent = serializeTorrent(*torrent);
+        const QString torrentIDStr = torrentID.toString();
+        const auto torrentSnapshotIter = m_snapshot.torrents.find(torrentIDStr);
+        if (torrentSnapshotIter == m_snapshot.torrents.end())
+        {
+            change.torrents[torrentIDStr] = {serializedTorrent, ALL_TORRENT_FIELDS};
+            m_snapshot.torrents.insert(torrentIDStr, {std::move(serializedTorrent), ALL_TORRENT_FIELDS});
+            continue;
+        }
 
-        auto &torrentSnapshot = m_maindataSnapshot.torrents[torrentID.toString()];
-        processMap(torrentSnapshot, serializedTorrent, m_maindataSyncBuf.torrents[torrentID.toString()]);
-        torrentSnapshot = serializedTorrent;
+        const SerializedTorrent::Fields fields = changedFields(torrentSnapshotIter->torrent, serializedTorrent);
+        if (fields.none())
+            continue;
+
+        torrentSnapshotIter->torrent = serializedTorrent;
+        change.torrents[torrentIDStr] = {std::move(serializedTorrent), fields};
     }
     m_updatedTorrents.clear();
 
     for (const BitTorrent::TorrentID &torrentID : asConst(m_removedTorrents))
     {
-        m_maindataSyncBuf.removedTorrents.append(torrentID.toString());
-        m_maindataSnapshot.torrents.remove(torrentID.toString());
+        change.removedTorrents.append(torrentID.toString());
+        m_snapshot.torrents.remove(torrentID.toString());
     }
     m_removedTorrents.clear();
 
@@ -650,15 +1004,15 @@ QJsonObject SyncController::generateMaindataSyncData(const int id, const bool fu
         for (const BitTorrent::TorrentID &torrentID : torrentIDs)
             serializedTorrentIDs.append(torrentID.toString());
 
-        m_maindataSyncBuf.trackers[tracker] = serializedTorrentIDs;
-        m_maindataSnapshot.trackers[tracker] = serializedTorrentIDs;
+        change.trackers[tracker] = serializedTorrentIDs;
+        m_snapshot.trackers[tracker] = serializedTorrentIDs;
     }
     m_updatedTrackers.clear();
 
     for (const QString &tracker : asConst(m_removedTrackers))
     {
-        m_maindataSyncBuf.removedTrackers.append(tracker);
-        m_maindataSnapshot.trackers.remove(tracker);
+        change.removedTrackers.append(tracker);
+        m_snapshot.trackers.remove(tracker);
     }
     m_removedTrackers.clear();
 
@@ -668,147 +1022,43 @@ QJsonObject SyncController::generateMaindataSyncData(const int id, const bool fu
     serverState[KEY_SYNC_MAINDATA_USE_ALT_SPEED_LIMITS] = session->isAltGlobalSpeedLimitEnabled();
     serverState[KEY_SYNC_MAINDATA_REFRESH_INTERVAL] = session->refreshInterval();
     serverState[KEY_SYNC_MAINDATA_USE_SUBCATEGORIES] = session->isSubcategoriesEnabled();
-    processMap(m_maindataSnapshot.serverState, serverState, m_maindataSyncBuf.serverState);
-    m_maindataSnapshot.serverState = serverState;
-
-    QJsonObject syncData;
-    syncData[KEY_RESPONSE_ID] = id;
-    if (fullUpdate)
-    {
-        m_maindataSyncBuf = m_maindataSnapshot;
-        syncData[KEY_FULL_UPDATE] = true;
-    }
-
-    if (!m_maindataSyncBuf.categories.isEmpty())
-    {
-        QJsonObject categories;
-        for (auto it = m_maindataSyncBuf.categories.cbegin(); it != m_maindataSyncBuf.categories.cend(); ++it)
-            categories[it.key()] = QJsonObject::fromVariantMap(it.value());
-        syncData[KEY_CATEGORIES] = categories;
-    }
-    if (!m_maindataSyncBuf.removedCategories.isEmpty())
-        syncData[KEY_CATEGORIES_REMOVED] = QJsonArray::fromStringList(m_maindataSyncBuf.removedCategories);
-
-    if (!m_maindataSyncBuf.tags.isEmpty())
-        syncData[KEY_TAGS] = QJsonArray::fromVariantList(m_maindataSyncBuf.tags);
-    if (!m_maindataSyncBuf.removedTags.isEmpty())
-        syncData[KEY_TAGS_REMOVED] = QJsonArray::fromStringList(m_maindataSyncBuf.removedTags);
+    processMap(m_snapshot.serverState, serverState, change.serverState);
+    m_snapshot.serverState = serverState;
 
-    if (!m_maindataSyncBuf.torrents.isEmpty())
-    {
-        QJsonObject torrents;
-        for (auto it = m_maindataSyncBuf.torrents.cbegin(); it != m_maindataSyncBuf.torrents.cend(); ++it)
-            torrents[it.key()] = QJsonObject::fromVariantMap(it.value());
-        syncData[KEY_TORRENTS] = torrents;
-    }
-    if (!m_maindataSyncBuf.removedTorrents.isEmpty())
-        syncData[KEY_TORRENTS_REMOVED] = QJsonArray::fromStringList(m_maindataSyncBuf.removedTorrents);
-
-    if (!m_maindataSyncBuf.trackers.isEmpty())
-    {
-        QJsonObject trackers;
-        for (auto it = m_maindataSyncBuf.trackers.cbegin(); it != m_maindataSyncBuf.trackers.cend(); ++it)
-            trackers[it.key()] = QJsonArray::fromStringList(it.value());
-        syncData[KEY_TRACKERS] = trackers;
-    }
-    if (!m_maindataSyncBuf.removedTrackers.isEmpty())
-        syncData[KEY_TRACKERS_REMOVED] = QJsonArray::fromStringList(m_maindataSyncBuf.removedTrackers);
-
-    if (!m_maindataSyncBuf.serverState.isEmpty())
-        syncData[KEY_SERVER_STATE] = QJsonObject::fromVariantMap(m_maindataSyncBuf.serverState);
-
-    return syncData;
-}
-
-// GET param:
-//   - hash (string): torrent hash (ID)
-//   - rid (int): last response id
-void SyncController::torrentPeersAction()
-{
-    const auto id = BitTorrent::TorrentID::fromString(params()[u"hash"_s]);
-    const BitTorrent::Torrent *torrent = BitTorrent::Session::instance()->getTorrent(id);
-    if (!torrent)
-        throw APIError(APIErrorType::NotFound);
-
-    QVariantMap data;
-    QVariantHash peers;
-
-    const QList<BitTorrent::PeerInfo> peersList = torrent->peers();
-
-    bool resolvePeerCountries = Preferences::instance()->resolvePeerCountries();
-
-    data[KEY_SYNC_TORRENT_PEERS_SHOW_FLAGS] = resolvePeerCountries;
-
-    for (const BitTorrent::PeerInfo &pi : peersList)
-    {
-        if (pi.address().ip.isNull()) continue;
-
-        QVariantMap peer =
-        {
-            {KEY_PEER_IP, pi.address().ip.toString()},
-            {KEY_PEER_PORT, pi.address().port},
-            {KEY_PEER_CLIENT, pi.client()},
-            {KEY_PEER_ID_CLIENT, pi.peerIdClient()},
-            {KEY_PEER_PROGRESS, pi.progress()},
-            {KEY_PEER_DOWN_SPEED, pi.payloadDownSpeed()},
-            {KEY_PEER_UP_SPEED, pi.payloadUpSpeed()},
-            {KEY_PEER_TOT_DOWN, pi.totalDownload()},
-            {KEY_PEER_TOT_UP, pi.totalUpload()},
-            {KEY_PEER_CONNECTION_TYPE, pi.connectionType()},
-            {KEY_PEER_FLAGS, pi.flags()},
-            {KEY_PEER_FLAGS_DESCRIPTION, pi.flagsDescription()},
-            {KEY_PEER_RELEVANCE, pi.relevance()}
-        };
+    if (change.isEmpty())
+        return m_snapshotID;
 
-        if (torrent->hasMetadata())
-        {
-            const PathList filePaths = torrent->info().filesForPiece(pi.downloadingPieceIndex());
-            QStringList filesForPiece;
-            filesForPiece.reserve(filePaths.size());
-            for (const Path &filePath : filePaths)
-                filesForPiece.append(filePath.toString());
-            peer.insert(KEY_PEER_FILES, filesForPiece.join(u'\n'));
-        }
-
-        if (resolvePeerCountries)
-        {
-            peer[KEY_PEER_COUNTRY_CODE] = pi.country().toLower();
-            peer[KEY_PEER_COUNTRY] = Net::GeoIPManager::CountryName(pi.country());
-        }
-
-        peers[pi.address().toString()] = peer;
-    }
-    data[u"peers"_s] = peers;
-
-    const int acceptedResponseId = params()[u"rid"_s].toInt();
-    setResult(generateSyncData(acceptedResponseId, data, m_lastAcceptedPeersResponse, m_lastPeersResponse));
+    // clients that fall behind the log are sent the full data instead
+    ++m_snapshotID;
+    m_changeLog.append(m_snapshotID, std::move(change), m_snapshot.itemCount());
+    return m_snapshotID;
 }
 
-void SyncController::onCategoryAdded(const QString &categoryName)
+void MaindataTracker::onCategoryAdded(const QString &categoryName)
 {
     m_removedCategories.remove(categoryName);
     m_updatedCategories.insert(categoryName);
 }
 
-void SyncController::onCategoryRemoved(const QString &categoryName)
+void MaindataTracker::onCategoryRemoved(const QString &categoryName)
 {
     m_updatedCategories.remove(categoryName);
     m_removedCategories.insert(categoryName);
 }
 
-void SyncController::onCategoryOptionsChanged(const QString &categoryName)
+void MaindataTracker::onCategoryOptionsChanged(const QString &categoryName)
 {
     Q_ASSERT(!m_removedCategories.contains(categoryName));
 
     m_updatedCategories.insert(categoryName);
 }
 
-void SyncController::onSubcategoriesSupportChanged()
+void MaindataTracker::onSubcategoriesSupportChanged()
 {
     const QStringList categoriesList = BitTorrent::Session::instance()->categories();
     for (const auto &categoryName : categoriesList)
     {
-        if (!m_maindataSnapshot.categories.contains(categoryName))
+        if (!m_snapshot.categories.contains(categoryName))
         {
             m_removedCategories.remove(categoryName);
             m_updatedCategories.insert(categoryName);
@@ -816,19 +1066,19 @@ void SyncController::onSubcategoriesSupportChanged()
     }
 }
 
-void SyncController::onTagAdded(const Tag &tag)
+void MaindataTracker::onTagAdded(const Tag &tag)
 {
     m_removedTags.remove(tag.toString());
     m_addedTags.insert(tag.toString());
 }
 
-void SyncController::onTagRemoved(const Tag &tag)
+void MaindataTracker::onTagRemoved(const Tag &tag)
 {
     m_addedTags.remove(tag.toString());
     m_removedTags.insert(tag.toString());
 }
 
-void SyncController::onTorrentAdded(BitTorrent::Torrent *torrent)
+void MaindataTracker::onTorrentAdded(BitTorrent::Torrent *torrent)
 {
     const BitTorrent::TorrentID torrentID = torrent->id();
 
@@ -843,7 +1093,7 @@ void SyncController::onTorrentAdded(BitTorrent::Torrent *torrent)
     }
 }
 
-void SyncController::onTorrentAboutToBeRemoved(BitTorrent::Torrent *torrent)
+void MaindataTracker::onTorrentAboutToBeRemoved(BitTorrent::Torrent *torrent)
 {
     const BitTorrent::TorrentID torrentID = torrent->id();
 
@@ -872,54 +1122,54 @@ void SyncController::onTorrentAboutToBeRemoved(BitTorrent::Torrent *torrent)
     }
 }
 
-void SyncController::onTorrentCategoryChanged(BitTorrent::Torrent *torrent
+void MaindataTracker::onTorrentCategoryChanged(BitTorrent::Torrent *torrent
         , [[maybe_unused]] const QString &oldCategory)
 {
     m_updatedTorrents.insert(torrent->id());
 }
 
-void SyncController::onTorrentMetadataReceived(BitTorrent::Torrent *torrent)
+void MaindataTracker::onTorrentMetadataReceived(BitTorrent::Torrent *torrent)
 {
     m_updatedTorrents.insert(torrent->id());
 }
 
-void SyncController::onTorrentStopped(BitTorrent::Torrent *torrent)
+void MaindataTracker::onTorrentStopped(BitTorrent::Torrent *torrent)
 {
     m_updatedTorrents.insert(torrent->id());
 }
 
-void SyncController::onTorrentStarted(BitTorrent::Torrent *torrent)
+void MaindataTracker::onTorrentStarted(BitTorrent::Torrent *torrent)
 {
     m_updatedTorrents.insert(torrent->id());
 }
 
-void SyncController::onTorrentSavePathChanged(BitTorrent::Torrent *torrent)
+void MaindataTracker::onTorrentSavePathChanged(BitTorrent::Torrent *torrent)
 {
     m_updatedTorrents.insert(torrent->id());
 }
 
-void SyncController::onTorrentSavingModeChanged(BitTorrent::Torrent *torrent)
+void MaindataTracker::onTorrentSavingModeChanged(BitTorrent::Torrent *torrent)
 {
     m_updatedTorrents.insert(torrent->id());
 }
 
-void SyncController::onTorrentTagAdded(BitTorrent::Torrent *torrent, [[maybe_unused]] const Tag &tag)
+void MaindataTracker::onTorrentTagAdded(BitTorrent::Torrent *torrent, [[maybe_unused]] const Tag &tag)
 {
     m_updatedTorrents.insert(torrent->id());
 }
 
-void SyncController::onTorrentTagRemoved(BitTorrent::Torrent *torrent, [[maybe_unused]] const Tag &tag)
+void MaindataTracker::onTorrentTagRemoved(BitTorrent::Torrent *torrent, [[maybe_unused]] const Tag &tag)
 {
     m_updatedTorrents.insert(torrent->id());
 }
 
-void SyncController::onTorrentsUpdated(const QList<BitTorrent::Torrent *> &torrents)
+void MaindataTracker::onTorrentsUpdated(const QList<BitTorrent::Torrent *> &torrents)
 {
     for (const BitTorrent::Torrent *torrent : torrents)
         m_updatedTorrents.insert(torrent->id());
 }
 
-void SyncController::onTorrentTrackersChanged(BitTorrent::Torrent *torrent)
+void MaindataTracker::onTorrentTrackersChanged(BitTorrent::Torrent *torrent)
 {
     using namespace BitTorrent;
 
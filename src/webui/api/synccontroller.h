@@ -28,38 +28,59 @@
 
 #pragma once
 
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
 #include <QSet>
 #include <QVariantMap>
 
 #include "base/bittorrent/infohash.h"
 #include "base/tag.h"
 #include "apicontroller.h"
+#include "maindatachangelog.h"
 
 namespace BitTorrent
 {
     class Torrent;
 }
 
-class SyncController : public APIController
+namespace Http
+{
+    class EventStream;
+}
+
+class SyncController;
+
+// Keeps the only snapshot of maindata and the log of the recent changes of it for all the sessions
+// as long as there are clients of maindata action or live streams.
+class MaindataTracker final : public QObject
 {
     Q_OBJECT
-    Q_DISABLE_COPY_MOVE(SyncController)
+    Q_DISABLE_COPY_MOVE(MaindataTracker)
 
 public:
-    using APIController::APIController;
+    using QObject::QObject;
 
-    explicit SyncController(IApplication *app, QObject *parent = nullptr);
+    void addClient(const SyncController *client);
+    void removeClient(const SyncController *client);
+
+    // Applies the tracked changes to the snapshot, returns the ID of the updated snapshot
+    int updateSnapshot();
+    const MaindataSyncBuf &snapshot() const;
+    bool collectChanges(int fromID, int toID, MaindataSyncBuf &syncBuf) const;
+
+    // The stream is owned by the tracker, the first event it gets is the full data
+    Http::EventStream *openStream();
 
 public slots:
     void updateFreeDiskSpace(qint64 freeDiskSpace);
 
-private slots:
-    void maindataAction();
-    void torrentPeersAction();
-
 private:
-    void makeMaindataSnapshot();
-    QJsonObject generateMaindataSyncData(int id, bool fullUpdate);
+    void startTracking();
+    void stopTracking();
+    void makeSnapshot();
+    void broadcast();
 
     void onCategoryAdded(const QString &categoryName);
     void onCategoryRemoved(const QString &categoryName);
@@ -82,9 +103,6 @@ private:
 
     qint64 m_freeDiskSpace = 0;
 
-    QVariantMap m_lastPeersResponse;
-    QVariantMap m_lastAcceptedPeersResponse;
-
     QHash<QString, QSet<BitTorrent::TorrentID>> m_knownTrackers;
 
     QSet<QString> m_updatedCategories;
@@ -96,22 +114,43 @@ private:
     QSet<BitTorrent::TorrentID> m_updatedTorrents;
     QSet<BitTorrent::TorrentID> m_removedTorrents;
 
-    struct MaindataSyncBuf
-    {
-        QHash<QString, QVariantMap> categories;
-        QVariantList tags;
-        QHash<QString, QVariantMap> torrents;
-        QHash<QString, QStringList> trackers;
-        QVariantMap serverState;
-
-        QStringList removedCategories;
-        QStringList removedTags;
-        QStringList removedTorrents;
-        QStringList removedTrackers;
-    };
-
-    MaindataSyncBuf m_maindataSnapshot;
-    MaindataSyncBuf m_maindataSyncBuf;
+    MaindataSyncBuf m_snapshot;
+    int m_snapshotID = 0;
+    MaindataChangeLog m_changeLog;
+    QSet<const SyncController *> m_clients;
+    QList<QPointer<Http::EventStream>> m_streams;
+    int m_streamLastSentID = 0;
+};
+
+class SyncController : public APIController
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(SyncController)
+
+public:
+    using APIController::APIController;
+
+    explicit SyncController(IApplication *app, QObject *parent = nullptr);
+    ~SyncController() override;
+
+    // maindata changes are tracked by the given tracker on behalf of this controller
+    void setMaindataTracker(MaindataTracker *tracker);
+
+private slots:
+    void maindataAction();
+    void maindataStreamAction();
+    void torrentPeersAction();
+
+private:
+    MaindataTracker *maindataTracker();
+
+    QVariantMap m_lastPeersResponse;
+    QVariantMap m_lastAcceptedPeersResponse;
+
+    // the client of maindata action is only tracked by the snapshot IDs it was sent
+    QPointer<MaindataTracker> m_maindataTracker;
+    // the streams are owned by the tracker, but they are closed along with the session they are opened in
+    QList<QPointer<Http::EventStream>> m_sessionMaindataStreams;
     int m_maindataLastSentID = 0;
-    int m_maindataAcceptedID = -1;
+    int m_maindataAcceptedID = 0;
 };
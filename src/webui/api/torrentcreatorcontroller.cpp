@@ -43,6 +43,8 @@
 const QString KEY_COMMENT = u"comment"_s;
 const QString KEY_ERROR_MESSAGE = u"errorMessage"_s;
 const QString KEY_FORMAT = u"format"_s;
+const QString KEY_HASH_CACHE_HITS = u"hashCacheHits"_s;
+const QString KEY_HASH_CACHE_MISSES = u"hashCacheMisses"_s;
 const QString KEY_OPTIMIZE_ALIGNMENT = u"optimizeAlignment"_s;
 const QString KEY_PADDED_FILE_SIZE_LIMIT = u"paddedFileSizeLimit"_s;
 const QString KEY_PIECE_SIZE = u"pieceSize"_s;
@@ -58,6 +60,7 @@ const QString KEY_TIME_STARTED = u"timeStarted"_s;
 const QString KEY_TORRENT_FILE_PATH = u"torrentFilePath"_s;
 const QString KEY_TRACKERS = u"trackers"_s;
 const QString KEY_URL_SEEDS = u"urlSeeds"_s;
+const QString KEY_USE_HASH_CACHE = u"useHashCache"_s;
 
 namespace
 {
@@ -121,6 +124,7 @@ void TorrentCreatorController::addTaskAction()
         .isPrivate = parseBool(params()[KEY_PRIVATE]).value_or(false),
 #ifdef QBT_USES_LIBTORRENT2
         .torrentFormat = parseTorrentFormat(params()[KEY_FORMAT].toLower()),
+        .isHashCacheEnabled = parseBool(params()[KEY_USE_HASH_CACHE]).value_or(false),
 #else
         .isAlignmentOptimized = parseBool(params()[KEY_OPTIMIZE_ALIGNMENT]).value_or(true),
         .paddedFileSizeLimit = parseInt(params()[KEY_PADDED_FILE_SIZE_LIMIT]).value_or(-1),
@@ -165,6 +169,7 @@ void TorrentCreatorController::statusAction()
             {KEY_TIME_ADDED, task->timeAdded().toString()},
 #ifdef QBT_USES_LIBTORRENT2
             {KEY_FORMAT, torrentFormatToString(task->params().torrentFormat)},
+            {KEY_USE_HASH_CACHE, task->params().isHashCacheEnabled},
 #else
             {KEY_OPTIMIZE_ALIGNMENT, task->params().isAlignmentOptimized},
             {KEY_PADDED_FILE_SIZE_LIMIT, task->params().paddedFileSizeLimit},
@@ -202,6 +207,13 @@ void TorrentCreatorController::statusAction()
             else
             {
                 taskJson[KEY_PIECE_SIZE] = task->result().pieceSize;
+#ifdef QBT_USES_LIBTORRENT2
+                if (task->params().isHashCacheEnabled)
+                {
+                    taskJson[KEY_HASH_CACHE_HITS] = task->result().hashCacheHits;
+                    taskJson[KEY_HASH_CACHE_MISSES] = task->result().hashCacheMisses;
+                }
+#endif
             }
         }
         else if (task->isRunning())
@@ -28,7 +28,9 @@
 
 #include "torrentscontroller.h"
 
+#include <algorithm>
 #include <functional>
+#include <utility>
 
 #include <QBitArray>
 #include <QJsonArray>
@@ -52,11 +54,14 @@
 #include "base/bittorrent/trackerentrystatus.h"
 #include "base/interfaces/iapplication.h"
 #include "base/global.h"
+#include "base/http/types.h"
 #include "base/logger.h"
 #include "base/net/downloadmanager.h"
 #include "base/torrentfilter.h"
+#include "base/utils/cbor.h"
 #include "base/utils/datetime.h"
 #include "base/utils/fs.h"
+#include "base/utils/json.h"
 #include "base/utils/sslkey.h"
 #include "base/utils/string.h"
 #include "apierror.h"
@@ -255,6 +260,21 @@ namespace
         return idList;
     }
 
+    template <typename Writer>
+    void writeTorrentList(Writer &writer, const QList<std::pair<QString, SerializedTorrent>> &torrents, const SerializedTorrent::Fields &fields)
+    {
+        writer.beginArray();
+        for (const auto &[torrentID, torrent] : torrents)
+        {
+            writer.beginObject();
+            writer.writeKey(KEY_TORRENT_ID);
+            writer.writeString(torrentID);
+            writeFields(writer, torrent, fields);
+            writer.endObject();
+        }
+        writer.endArray();
+    }
+
     nonstd::expected<QUrl, QString> validateWebSeedUrl(const QString &urlStr)
     {
         const QString normalizedUrlStr = QUrl::fromPercentEncoding(urlStr.toLatin1());
@@ -306,6 +326,7 @@ void TorrentsController::countAction()
 //   - reverse (bool): enable reverse sorting
 //   - limit (int): set limit number of torrents returned (if greater than 0, otherwise - unlimited)
 //   - offset (int): set offset (if less than 0 - offset from end)
+//   - fields (string): keys of the dictionary to be returned, separated by | ("hash" is always returned; empty means all keys)
 void TorrentsController::infoAction()
 {
     const QString filter {params()[u"filter"_s]};
@@ -313,10 +334,25 @@ void TorrentsController::infoAction()
     const std::optional<Tag> tag = getOptionalTag(params(), u"tag"_s);
     const QString sortedColumn {params()[u"sort"_s]};
     const bool reverse {parseBool(params()[u"reverse"_s]).value_or(false)};
-    int limit {params()[u"limit"_s].toInt()};
-    int offset {params()[u"offset"_s].toInt()};
+    const int limit {params()[u"limit"_s].toInt()};
+    const int offset {params()[u"offset"_s].toInt()};
     const QStringList hashes {params()[u"hashes"_s].split(u'|', Qt::SkipEmptyParts)};
     const std::optional<bool> isPrivate = parseBool(params()[u"private"_s]);
+    const QStringList fieldKeys {params()[u"fields"_s].split(u'|', Qt::SkipEmptyParts)};
+
+    SerializedTorrent::Fields fields;
+    if (fieldKeys.isEmpty())
+        fields.set();
+    for (const QString &fieldKey : fieldKeys)
+    {
+        if (fieldKey == KEY_TORRENT_ID)
+            continue;
+
+        const std::optional<SerializedTorrent::Field> field = fieldFromKey(fieldKey);
+        if (!field)
+            throw APIError(APIErrorType::BadParams, tr("'fields' parameter is invalid"));
+        fields.set(static_cast<std::size_t>(*field));
+    }
 
     std::optional<TorrentIDSet> idSet;
     if (!hashes.isEmpty())
@@ -327,11 +363,11 @@ void TorrentsController::infoAction()
     }
 
     const TorrentFilter torrentFilter {filter, idSet, category, tag, isPrivate};
-    QVariantList torrentList;
+    QList<const BitTorrent::Torrent *> torrentList;
     for (const BitTorrent::Torrent *torrent : asConst(BitTorrent::Session::instance()->torrents()))
     {
         if (torrentFilter.match(torrent))
-            torrentList.append(serialize(*torrent));
+            torrentList.append(torrent);
     }
 
     if (torrentList.isEmpty())
@@ -342,58 +378,69 @@ void TorrentsController::infoAction()
 
     if (!sortedColumn.isEmpty())
     {
-        if (!torrentList[0].toMap().contains(sortedColumn))
-            throw APIError(APIErrorType::BadParams, tr("'sort' parameter is invalid"));
-
-        const auto lessThan = [](const QVariant &left, const QVariant &right) -> bool
+        // the ID isn't a field of SerializedTorrent since it is always present
+        std::optional<SerializedTorrent::Field> sortField;
+        if (sortedColumn != KEY_TORRENT_ID)
         {
-            Q_ASSERT(left.userType() == right.userType());
+            sortField = fieldFromKey(sortedColumn);
+            if (!sortField)
+                throw APIError(APIErrorType::BadParams, tr("'sort' parameter is invalid"));
+        }
 
-            switch (left.userType())
-            {
-            case QMetaType::Bool:
-                return left.value<bool>() < right.value<bool>();
-            case QMetaType::Double:
-                return left.value<double>() < right.value<double>();
-            case QMetaType::Float:
-                return left.value<float>() < right.value<float>();
-            case QMetaType::Int:
-                return left.value<int>() < right.value<int>();
-            case QMetaType::LongLong:
-                return left.value<qlonglong>() < right.value<qlonglong>();
-            case QMetaType::QString:
-                return left.value<QString>() < right.value<QString>();
-            default:
-                qWarning("Unhandled QVariant comparison, type: %d, name: %s"
-                        , left.userType(), left.metaType().name());
-                break;
-            }
-            return false;
-        };
+        SerializedTorrent::Fields sortFields;
+        if (sortField)
+            sortFields.set(static_cast<std::size_t>(*sortField));
 
-        std::sort(torrentList.begin(), torrentList.end()
-            , [reverse, &sortedColumn, &lessThan](const QVariant &torrent1, const QVariant &torrent2)
+        QList<SerializedTorrentSortKey> sortKeys;
+        sortKeys.reserve(torrentList.size());
+        for (const BitTorrent::Torrent *torrent : asConst(torrentList))
         {
-            const QVariant value1 {torrent1.toMap().value(sortedColumn)};
-            const QVariant value2 {torrent2.toMap().value(sortedColumn)};
-            return reverse ? lessThan(value2, value1) : lessThan(value1, value2);
-        });
-    }
+            sortKeys.append(sortField ? sortKey(serializeTorrent(*torrent, sortFields), *sortField)
+                : SerializedTorrentSortKey(torrent->id().toString()));
+        }
 
-    const int size = torrentList.size();
-    // normalize offset
-    if (offset < 0)
-        offset = size + offset;
-    if ((offset >= size) || (offset < 0))
-        offset = 0;
-    // normalize limit
-    if (limit <= 0)
-        limit = -1; // unlimited
+        const QList<qsizetype> pageIndexes = sortedPageIndexes(sortKeys, reverse, offset, limit);
+        QList<const BitTorrent::Torrent *> sortedTorrentList;
+        sortedTorrentList.reserve(pageIndexes.size());
+        for (const qsizetype index : pageIndexes)
+            sortedTorrentList.append(torrentList[index]);
+        torrentList = sortedTorrentList;
+    }
+    else
+    {
+        const auto [pageBegin, pageEnd] = pageRange(torrentList.size(), offset, limit);
+        if ((pageBegin > 0) || (pageEnd < torrentList.size()))
+            torrentList = torrentList.mid(pageBegin, (pageEnd - pageBegin));
+    }
 
-    if ((limit > 0) || (offset > 0))
-        torrentList = torrentList.mid(offset, limit);
+    // only the returned page is serialized, the state of its torrents is taken here,
+    // while it is written outside of the main thread
+    QList<std::pair<QString, SerializedTorrent>> serializedTorrents;
+    serializedTorrents.reserve(torrentList.size());
+    for (const BitTorrent::Torrent *torrent : asConst(torrentList))
+        serializedTorrents.emplaceBack(torrent->id().toString(), serializeTorrent(*torrent, fields));
 
-    setResult(QJsonArray::fromVariantList(torrentList));
+    // it is about 1 KiB per torrent in full
+    const qsizetype reserveSize = (serializedTorrents.size() + 1) * (fieldKeys.isEmpty() ? 1024 : 128);
+    if (resultFormat() != APIResultFormat::JSON)
+    {
+        const bool useStringRefs = (resultFormat() == APIResultFormat::CBORWithStringRefs);
+        setDeferredResult([serializedTorrents, fields, reserveSize, useStringRefs]
+        {
+            Utils::Cbor::Writer writer {reserveSize, useStringRefs};
+            writeTorrentList(writer, serializedTorrents, fields);
+            return writer.takeData();
+        }, Http::CONTENT_TYPE_CBOR);
+    }
+    else
+    {
+        setDeferredResult([serializedTorrents, fields, reserveSize]
+        {
+            Utils::Json::Writer writer {reserveSize};
+            writeTorrentList(writer, serializedTorrents, fields);
+            return writer.takeData();
+        }, Http::CONTENT_TYPE_JSON);
+    }
 }
 
 // Returns the properties for a torrent in JSON format.
@@ -28,14 +28,19 @@
 
 #include "transfercontroller.h"
 
+#include <QJsonArray>
 #include <QJsonObject>
 #include <QList>
 
+#include "base/bittorrent/diskiostatus.h"
 #include "base/bittorrent/peeraddress.h"
 #include "base/bittorrent/peerinfo.h"
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/sessionstatus.h"
 #include "base/global.h"
+#include "base/http/types.h"
+#include "base/utils/cbor.h"
+#include "base/utils/json.h"
 #include "base/utils/string.h"
 #include "apierror.h"
 
@@ -48,6 +53,70 @@ const QString KEY_TRANSFER_UPRATELIMIT = u"up_rate_limit"_s;
 const QString KEY_TRANSFER_DHT_NODES = u"dht_nodes"_s;
 const QString KEY_TRANSFER_CONNECTION_STATUS = u"connection_status"_s;
 
+const QString KEY_DISK_DEVICE = u"device"_s;
+const QString KEY_DISK_ROTATIONAL = u"rotational"_s;
+const QString KEY_DISK_TOTAL_READ = u"total_read"_s;
+const QString KEY_DISK_TOTAL_WRITTEN = u"total_written"_s;
+const QString KEY_DISK_TOTAL_HASHED = u"total_hashed"_s;
+const QString KEY_DISK_READ_RATE = u"read_rate"_s;
+const QString KEY_DISK_WRITE_RATE = u"write_rate"_s;
+const QString KEY_DISK_HASH_RATE = u"hash_rate"_s;
+const QString KEY_DISK_QUEUE_DEPTH = u"queue_depth"_s;
+const QString KEY_DISK_WAITING_JOBS = u"waiting_jobs"_s;
+const QString KEY_DISK_READ_LATENCY = u"read_latency"_s;
+const QString KEY_DISK_WRITE_LATENCY = u"write_latency"_s;
+const QString KEY_DISK_HASH_LATENCY = u"hash_latency"_s;
+const QString KEY_DISK_MOVE_STORAGE_LATENCY = u"move_storage_latency"_s;
+const QString KEY_LATENCY_COUNT = u"count"_s;
+const QString KEY_LATENCY_AVERAGE = u"average"_s;
+const QString KEY_LATENCY_MAX = u"max"_s;
+const QString KEY_LATENCY_HISTOGRAM = u"histogram"_s;
+
+namespace
+{
+    template <typename Writer>
+    void writeTransferInfo(Writer &writer, const TransferInfoSnapshot &snapshot)
+    {
+        const BitTorrent::SessionStatus &sessionStatus = snapshot.status;
+
+        writer.beginObject();
+        writer.writeKey(KEY_TRANSFER_DLSPEED);
+        writer.writeInt(sessionStatus.payloadDownloadRate);
+        writer.writeKey(KEY_TRANSFER_DLDATA);
+        writer.writeInt(sessionStatus.totalPayloadDownload);
+        writer.writeKey(KEY_TRANSFER_UPSPEED);
+        writer.writeInt(sessionStatus.payloadUploadRate);
+        writer.writeKey(KEY_TRANSFER_UPDATA);
+        writer.writeInt(sessionStatus.totalPayloadUpload);
+        writer.writeKey(KEY_TRANSFER_DLRATELIMIT);
+        writer.writeInt(snapshot.downloadSpeedLimit);
+        writer.writeKey(KEY_TRANSFER_UPRATELIMIT);
+        writer.writeInt(snapshot.uploadSpeedLimit);
+        writer.writeKey(KEY_TRANSFER_DHT_NODES);
+        writer.writeInt(sessionStatus.dhtNodes);
+        writer.writeKey(KEY_TRANSFER_CONNECTION_STATUS);
+        if (!snapshot.isListening)
+            writer.writeString(u"disconnected");
+        else
+            writer.writeString(sessionStatus.hasIncomingConnections ? u"connected" : u"firewalled");
+        writer.endObject();
+    }
+
+    QJsonObject serializeLatency(const BitTorrent::DiskJobLatencyStatus &latencyStatus)
+    {
+        QJsonArray histogram;
+        for (const qint64 jobsCount : latencyStatus.histogram)
+            histogram.append(jobsCount);
+
+        return {
+            {KEY_LATENCY_COUNT, latencyStatus.count},
+            {KEY_LATENCY_AVERAGE, ((latencyStatus.count > 0) ? (latencyStatus.totalTime / latencyStatus.count) : 0)},
+            {KEY_LATENCY_MAX, latencyStatus.maxTime},
+            {KEY_LATENCY_HISTOGRAM, histogram}
+        };
+    }
+}
+
 // Returns the global transfer information in JSON format.
 // The return value is a JSON-formatted dictionary.
 // The dictionary keys are:
@@ -61,23 +130,87 @@ const QString KEY_TRANSFER_CONNECTION_STATUS = u"connection_status"_s;
 //   - "connection_status": Connection status
 void TransferController::infoAction()
 {
-    const BitTorrent::SessionStatus &sessionStatus = BitTorrent::Session::instance()->status();
-
-    QJsonObject dict;
-
-    dict[KEY_TRANSFER_DLSPEED] = static_cast<qint64>(sessionStatus.payloadDownloadRate);
-    dict[KEY_TRANSFER_DLDATA] = static_cast<qint64>(sessionStatus.totalPayloadDownload);
-    dict[KEY_TRANSFER_UPSPEED] = static_cast<qint64>(sessionStatus.payloadUploadRate);
-    dict[KEY_TRANSFER_UPDATA] = static_cast<qint64>(sessionStatus.totalPayloadUpload);
-    dict[KEY_TRANSFER_DLRATELIMIT] = BitTorrent::Session::instance()->downloadSpeedLimit();
-    dict[KEY_TRANSFER_UPRATELIMIT] = BitTorrent::Session::instance()->uploadSpeedLimit();
-    dict[KEY_TRANSFER_DHT_NODES] = static_cast<qint64>(sessionStatus.dhtNodes);
-    if (!BitTorrent::Session::instance()->isListening())
-        dict[KEY_TRANSFER_CONNECTION_STATUS] = u"disconnected"_s;
-    else
-        dict[KEY_TRANSFER_CONNECTION_STATUS] = sessionStatus.hasIncomingConnections ? u"connected"_s : u"firewalled"_s;
-
-    setResult(dict);
+    // the snapshot is serialized outside of the main thread
+    setDeferredResult(infoGenerator(makeInfoSnapshot(), resultFormat()), resultMimeType(resultFormat()));
+}
+
+TransferInfoSnapshot TransferController::makeInfoSnapshot()
+{
+    const auto *session = BitTorrent::Session::instance();
+
+    // the status is the snapshot of the session state as of the last stats update
+    TransferInfoSnapshot snapshot;
+    snapshot.status = session->status();
+    snapshot.downloadSpeedLimit = session->downloadSpeedLimit();
+    snapshot.uploadSpeedLimit = session->uploadSpeedLimit();
+    snapshot.isListening = session->isListening();
+    return snapshot;
+}
+
+std::function<QByteArray ()> TransferController::infoGenerator(const TransferInfoSnapshot &snapshot, const APIResultFormat resultFormat)
+{
+    if (resultFormat != APIResultFormat::JSON)
+    {
+        const bool useStringRefs = (resultFormat == APIResultFormat::CBORWithStringRefs);
+        return [snapshot, useStringRefs]
+        {
+            Utils::Cbor::Writer writer {0, useStringRefs};
+            writeTransferInfo(writer, snapshot);
+            return writer.takeData();
+        };
+    }
+
+    return [snapshot]
+    {
+        Utils::Json::Writer writer;
+        writeTransferInfo(writer, snapshot);
+        return writer.takeData();
+    };
+}
+
+// Returns the disk I/O statistics per storage device in JSON format.
+// The return value is a JSON-formatted list of dictionaries.
+// The dictionary keys are:
+//   - "device": Storage device name
+//   - "rotational": Whether the device is rotational (i.e. HDD)
+//   - "total_read": Data read this session
+//   - "total_written": Data written this session
+//   - "total_hashed": Data hashed this session (when checking torrents or verifying pieces)
+//   - "read_rate": Read rate
+//   - "write_rate": Write rate
+//   - "hash_rate": Hashing rate
+//   - "queue_depth": Number of disk jobs that are not completed yet
+//   - "waiting_jobs": Number of disk jobs held in device queue (only rotational devices are queued)
+//   - "read_latency", "write_latency", "hash_latency", "move_storage_latency": Job latency statistics
+// Latency statistics dictionary keys are:
+//   - "count": Number of completed jobs
+//   - "average": Average job latency (in microseconds)
+//   - "max": Maximum job latency (in microseconds)
+//   - "histogram": Number of jobs by latency, N-th item counts jobs completed in [2^(N-1), 2^N) microseconds
+void TransferController::diskStatsAction()
+{
+    QJsonArray devices;
+    for (const BitTorrent::DiskDeviceIOStatus &deviceStatus : BitTorrent::Session::instance()->diskIOStatus())
+    {
+        devices.append(QJsonObject {
+            {KEY_DISK_DEVICE, deviceStatus.device},
+            {KEY_DISK_ROTATIONAL, deviceStatus.isRotational},
+            {KEY_DISK_TOTAL_READ, deviceStatus.totalRead},
+            {KEY_DISK_TOTAL_WRITTEN, deviceStatus.totalWritten},
+            {KEY_DISK_TOTAL_HASHED, deviceStatus.totalHashed},
+            {KEY_DISK_READ_RATE, deviceStatus.readRate},
+            {KEY_DISK_WRITE_RATE, deviceStatus.writeRate},
+            {KEY_DISK_HASH_RATE, deviceStatus.hashRate},
+            {KEY_DISK_QUEUE_DEPTH, deviceStatus.queueDepth},
+            {KEY_DISK_WAITING_JOBS, deviceStatus.waitingJobs},
+            {KEY_DISK_READ_LATENCY, serializeLatency(deviceStatus.readLatency)},
+            {KEY_DISK_WRITE_LATENCY, serializeLatency(deviceStatus.writeLatency)},
+            {KEY_DISK_HASH_LATENCY, serializeLatency(deviceStatus.hashLatency)},
+            {KEY_DISK_MOVE_STORAGE_LATENCY, serializeLatency(deviceStatus.moveStorageLatency)}
+        });
+    }
+
+    setResult(devices);
 }
 
 void TransferController::uploadLimitAction()
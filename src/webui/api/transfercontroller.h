@@ -28,8 +28,22 @@
 
 #pragma once
 
+#include <functional>
+
+#include <QByteArray>
+
+#include "base/bittorrent/sessionstatus.h"
 #include "apicontroller.h"
 
+// Global transfer state as of the last session stats update
+struct TransferInfoSnapshot
+{
+    BitTorrent::SessionStatus status;
+    int downloadSpeedLimit = 0;
+    int uploadSpeedLimit = 0;
+    bool isListening = false;
+};
+
 class TransferController : public APIController
 {
     Q_OBJECT
@@ -38,8 +52,13 @@ class TransferController : public APIController
 public:
     using APIController::APIController;
 
+    static TransferInfoSnapshot makeInfoSnapshot();
+    // the returned generator can be called in any thread
+    static std::function<QByteArray ()> infoGenerator(const TransferInfoSnapshot &snapshot, APIResultFormat resultFormat);
+
 private slots:
     void infoAction();
+    void diskStatsAction();
     void speedLimitsModeAction();
     void setSpeedLimitsModeAction();
     void toggleSpeedLimitsModeAction();
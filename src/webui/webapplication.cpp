@@ -32,7 +32,9 @@
 #include <algorithm>
 #include <chrono>
 
+#include <QCryptographicHash>
 #include <QDateTime>
+#include <QDeadlineTimer>
 #include <QDebug>
 #include <QDir>
 #include <QFileInfo>
@@ -40,6 +42,7 @@
 #include <QMetaObject>
 #include <QMimeDatabase>
 #include <QMimeType>
+#include <QMutexLocker>
 #include <QNetworkCookie>
 #include <QRegularExpression>
 #include <QThread>
@@ -47,11 +50,14 @@
 #include <QUrl>
 
 #include "base/algorithm.h"
+#include "base/bittorrent/session.h"
 #include "base/bittorrent/torrentcreationmanager.h"
 #include "base/http/httperror.h"
+#include "base/http/responsegenerator.h"
 #include "base/logger.h"
 #include "base/preferences.h"
 #include "base/types.h"
+#include "base/utils/cbor.h"
 #include "base/utils/fs.h"
 #include "base/utils/io.h"
 #include "base/utils/misc.h"
@@ -108,6 +114,88 @@ namespace
         return hostHeader;
     }
 
+    enum class OriginCheckResult
+    {
+        Allowed,
+        OriginMismatch,
+        RefererMismatch
+    };
+
+    OriginCheckResult checkRequestOrigin(const Http::Request &request)
+    {
+        // https://www.owasp.org/index.php/Cross-Site_Request_Forgery_(CSRF)_Prevention_Cheat_Sheet#Verifying_Same_Origin_with_Standard_Headers
+
+        const auto isSameOrigin = [](const QUrl &left, const QUrl &right) -> bool
+        {
+            // [rfc6454] 5. Comparing Origins
+            return ((left.port() == right.port())
+                    // && (left.scheme() == right.scheme())  // not present in this context
+                    && (left.host() == right.host()));
+        };
+
+        const QString targetOrigin = request.headers.value(Http::HEADER_X_FORWARDED_HOST, request.headers.value(Http::HEADER_HOST));
+        const QString originValue = request.headers.value(Http::HEADER_ORIGIN);
+        const QString refererValue = request.headers.value(Http::HEADER_REFERER);
+
+        // owasp.org recommends to block the request without both headers, but doing so
+        // will inevitably lead Web API users to spoof headers so lets be permissive here
+
+        // sent with CORS requests, as well as with POST requests
+        if (!originValue.isEmpty())
+            return isSameOrigin(urlFromHostHeader(targetOrigin), originValue) ? OriginCheckResult::Allowed : OriginCheckResult::OriginMismatch;
+
+        if (!refererValue.isEmpty())
+            return isSameOrigin(urlFromHostHeader(targetOrigin), refererValue) ? OriginCheckResult::Allowed : OriginCheckResult::RefererMismatch;
+
+        return OriginCheckResult::Allowed;
+    }
+
+    enum class HostHeaderCheckResult
+    {
+        Valid,
+        PortMismatch,
+        HostMismatch
+    };
+
+    HostHeaderCheckResult checkHostHeader(const Http::Request &request, const Http::Environment &env, const QStringList &domains)
+    {
+        const QUrl hostHeader = urlFromHostHeader(request.headers[Http::HEADER_HOST]);
+        const QString requestHost = hostHeader.host();
+
+        // (if present) try matching host header's port with local port
+        const int requestPort = hostHeader.port();
+        if ((requestPort != -1) && (env.localPort != requestPort))
+            return HostHeaderCheckResult::PortMismatch;
+
+        // try matching host header with local address
+        const bool sameAddr = env.localAddress.isEqual(QHostAddress(requestHost));
+
+        if (sameAddr)
+            return HostHeaderCheckResult::Valid;
+
+        // try matching host header with domain list
+        for (const auto &domain : domains)
+        {
+            const QRegularExpression domainRegex {Utils::String::wildcardToRegexPattern(domain), QRegularExpression::CaseInsensitiveOption};
+            if (requestHost.contains(domainRegex))
+                return HostHeaderCheckResult::Valid;
+        }
+
+        return HostHeaderCheckResult::HostMismatch;
+    }
+
+    qint64 currentActivityTime()
+    {
+        return QDeadlineTimer::current().deadline();
+    }
+
+    bool hasActivityExpired(const WebSession::ActivityTimestamp &activityTimestamp, const qint64 seconds)
+    {
+        if (seconds <= 0)
+            return false;
+        return ((currentActivityTime() - activityTimestamp.load()) > (seconds * 1000));
+    }
+
     QString getCachingInterval(QString contentType)
     {
         contentType = contentType.toLower();
@@ -124,6 +212,64 @@ namespace
         return u"no-store"_s;
     }
 
+    APIResultFormat selectResultFormat(const QStringView acceptHeader)
+    {
+        // [rfc9110] 12.5.1. Accept
+        // CBOR has to be requested explicitly, since wildcards are sent by the clients expecting JSON.
+        // String references are used only if requested by "stringref=1" parameter.
+        for (const QStringView mediaRange : acceptHeader.split(u',', Qt::SkipEmptyParts))
+        {
+            const QList<QStringView> params = mediaRange.split(u';');
+            if (params.first().trimmed().compare(Http::CONTENT_TYPE_CBOR, Qt::CaseInsensitive) != 0)
+                continue;
+
+            bool useStringRefs = false;
+            for (qsizetype i = 1; i < params.size(); ++i)
+            {
+                const QStringView trimmedParam = params[i].trimmed();
+                if (trimmedParam.startsWith(u"q=") && (trimmedParam.sliced(2).toDouble() <= 0))
+                    return APIResultFormat::JSON;
+                if (trimmedParam == u"stringref=1")
+                    useStringRefs = true;
+            }
+            return useStringRefs ? APIResultFormat::CBORWithStringRefs : APIResultFormat::CBOR;
+        }
+        return APIResultFormat::JSON;
+    }
+
+    QString generateCacheID()
+    {
+        return QString::number(Utils::Random::rand(), 36);
+    }
+
+    QString hashFileContent(const QByteArray &data)
+    {
+        // it must not contain '-' which separates the content coding in ETags
+        return QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex().left(32));
+    }
+
+    bool matchesETag(const QStringView ifNoneMatch, const QString &fileHash)
+    {
+        // [rfc9110] 13.1.2. If-None-Match
+        // It uses the weak comparison, so the representations that differ only in content coding match too
+        for (QStringView tag : ifNoneMatch.split(u',', Qt::SkipEmptyParts))
+        {
+            tag = tag.trimmed();
+            if (tag == u"*")
+                return true;
+
+            if (tag.startsWith(u"W/"))
+                tag = tag.sliced(2);
+            if ((tag.size() < 2) || !tag.startsWith(u'"') || !tag.endsWith(u'"'))
+                continue;
+
+            const QStringView opaqueTag = tag.sliced(1, (tag.size() - 2));
+            if (opaqueTag.left(opaqueTag.indexOf(u'-')) == fileHash)
+                return true;
+        }
+        return false;
+    }
+
     QString createLanguagesOptionsHtml()
     {
         // List language files
@@ -159,12 +305,13 @@ namespace
 
 WebApplication::WebApplication(IApplication *app, QObject *parent)
     : ApplicationComponent(app, parent)
-    , m_cacheID {QString::number(Utils::Random::rand(), 36)}
+    , m_cacheID {generateCacheID()}
     , m_authController {new AuthController(this, app, this)}
     , m_workerThread {new QThread}
     , m_freeDiskSpaceChecker {new FreeDiskSpaceChecker}
     , m_freeDiskSpaceCheckingTimer {new QTimer(this)}
     , m_torrentCreationManager {new BitTorrent::TorrentCreationManager(app, this)}
+    , m_maindataTracker {new MaindataTracker(this)}
 {
     declarePublicAPI(u"auth/login"_s);
 
@@ -182,6 +329,10 @@ WebApplication::WebApplication(IApplication *app, QObject *parent)
         m_sessionCookieName = DEFAULT_SESSION_COOKIE_NAME;
     }
 
+    // compressing files at the best level takes a while, it shouldn't compete with the rest of the app
+    m_fileCompressionThreadPool.setMaxThreadCount(1);
+    m_fileCompressionThreadPool.setThreadPriority(QThread::LowPriority);
+
     m_freeDiskSpaceChecker->moveToThread(m_workerThread.get());
     connect(m_workerThread.get(), &QThread::finished, m_freeDiskSpaceChecker, &QObject::deleteLater);
     m_workerThread->start();
@@ -191,10 +342,16 @@ WebApplication::WebApplication(IApplication *app, QObject *parent)
     connect(m_freeDiskSpaceCheckingTimer, &QTimer::timeout, m_freeDiskSpaceChecker, &FreeDiskSpaceChecker::check);
     connect(m_freeDiskSpaceChecker, &FreeDiskSpaceChecker::checked, m_freeDiskSpaceCheckingTimer, qOverload<>(&QTimer::start));
     QMetaObject::invokeMethod(m_freeDiskSpaceChecker, &FreeDiskSpaceChecker::check);
+
+    connect(m_freeDiskSpaceChecker, &FreeDiskSpaceChecker::checked, m_maindataTracker, &MaindataTracker::updateFreeDiskSpace);
+
+    connect(BitTorrent::Session::instance(), &BitTorrent::Session::statsUpdated, this, &WebApplication::publishConcurrentRequestData);
 }
 
 WebApplication::~WebApplication()
 {
+    m_fileCompressionThreadPool.clear();
+
     // cleanup sessions data
     qDeleteAll(m_sessions);
 }
@@ -357,11 +514,36 @@ void WebApplication::doProcessRequest()
 
     try
     {
-        const APIResult result = controller->run(action, m_params, data);
+        // the same URL returns the different content types depending on "Accept" header
+        setHeader({Http::HEADER_VARY, u"Accept"_s});
+
+        const APIResultFormat resultFormat = selectResultFormat(request().headers.value(Http::HEADER_ACCEPT));
+        const APIResult result = controller->run(action, m_params, data, resultFormat);
+        if (result.eventStream)
+        {
+            setEventStream(result.eventStream);
+            return;
+        }
+
+        if (result.dataGenerator)
+        {
+            printGenerated(result.dataGenerator, result.mimeType);
+            return;
+        }
+
         switch (result.data.userType())
         {
         case QMetaType::QJsonDocument:
-            print(result.data.toJsonDocument().toJson(QJsonDocument::Compact), Http::CONTENT_TYPE_JSON);
+            if (resultFormat != APIResultFormat::JSON)
+            {
+                Utils::Cbor::Writer writer {0, (resultFormat == APIResultFormat::CBORWithStringRefs)};
+                writer.writeVariant(result.data.toJsonDocument().toVariant());
+                print(writer.takeData(), Http::CONTENT_TYPE_CBOR);
+            }
+            else
+            {
+                print(result.data.toJsonDocument().toJson(QJsonDocument::Compact), Http::CONTENT_TYPE_JSON);
+            }
             break;
         case QMetaType::QByteArray:
             {
@@ -410,7 +592,7 @@ void WebApplication::configure()
     {
         m_isAltUIUsed = isAltUIUsed;
         m_rootFolder = rootFolder;
-        m_translatedFiles.clear();
+        resetFileCache();
         if (!m_isAltUIUsed)
             LogMsg(tr("Using built-in WebUI."));
         else
@@ -421,7 +603,8 @@ void WebApplication::configure()
     if (m_currentLocale != newLocale)
     {
         m_currentLocale = newLocale;
-        m_translatedFiles.clear();
+        // translated files are changed, so the URLs referring to them have to be changed too
+        resetFileCache();
 
         m_translationFileLoaded = m_translator.load((m_rootFolder / Path(u"translations/webui_"_s) + newLocale).data());
         if (m_translationFileLoaded)
@@ -523,6 +706,8 @@ void WebApplication::configure()
         if (m_trustedReverseProxyList.isEmpty())
             m_isReverseProxySupportEnabled = false;
     }
+
+    publishConcurrentRequestData();
 }
 
 void WebApplication::declarePublicAPI(const QString &apiPath)
@@ -534,14 +719,13 @@ void WebApplication::sendFile(const Path &path)
 {
     const QDateTime lastModified = Utils::Fs::lastModified(path);
 
-    // find translated file in cache
+    // files of built-in WebUI are cached along with their translations
     if (!m_isAltUIUsed)
     {
-        if (const auto it = m_translatedFiles.constFind(path);
-            (it != m_translatedFiles.constEnd()) && (lastModified <= it->lastModified))
+        if (const auto it = m_cachedFiles.constFind(path);
+            (it != m_cachedFiles.constEnd()) && (lastModified <= it->lastModified))
         {
-            print(it->data, it->mimeType);
-            setHeader({Http::HEADER_CACHE_CONTROL, getCachingInterval(it->mimeType)});
+            sendCachedFile(*it);
             return;
         }
     }
@@ -587,13 +771,107 @@ void WebApplication::sendFile(const Path &path)
             dataStr.replace(u"${LANGUAGE_OPTIONS}"_s, createLanguagesOptionsHtml());
 
         data = dataStr.toUtf8();
-        m_translatedFiles[path] = {data, mimeType.name(), lastModified}; // caching translated file
+    }
+
+    if (!m_isAltUIUsed)
+    {
+        const QString hash = hashFileContent(data);
+        const CachedFile &cachedFile = m_cachedFiles.insert(path, {data, mimeType.name(), lastModified, hash}).value();
+        sendCachedFile(cachedFile);
+        return;
     }
 
     print(data, mimeType.name());
     setHeader({Http::HEADER_CACHE_CONTROL, getCachingInterval(mimeType.name())});
 }
 
+void WebApplication::sendCachedFile(const CachedFile &file)
+{
+    // the URLs with cache ID are changed whenever the content they refer to can change
+    const bool isVersionedURL = (request().query.value(u"v"_s) == m_cacheID.toLatin1());
+    setHeader({Http::HEADER_CACHE_CONTROL, (isVersionedURL
+        ? u"private, max-age=31536000, immutable"_s : getCachingInterval(file.mimeType))});
+    setHeader({Http::HEADER_VARY, u"Accept-Encoding"_s});
+
+    const QString encoding = Http::isCompressible(file.mimeType, file.data.size())
+        ? Http::selectContentEncoding(request().headers.value(Http::HEADER_ACCEPT_ENCODING))
+        : QString();
+
+    QString etag = u"\"%1\""_s.arg(file.hash);
+    const QByteArray *content = &file.data;
+    QString contentEncoding;
+    bool isCompressed = true;
+    if (!encoding.isEmpty())
+    {
+        const QString compressedFileID = file.hash + u'-' + encoding;
+        if (const auto it = m_compressedFiles.constFind(compressedFileID); it != m_compressedFiles.cend())
+        {
+            if (!it->isEmpty())
+            {
+                etag = u"\"%1\""_s.arg(compressedFileID);
+                content = &it.value();
+                contentEncoding = encoding;
+            }
+        }
+        else
+        {
+            // until it is done, the file is compressed for each response by the connection,
+            // so the response content isn't known here
+            compressCachedFile(file, encoding);
+            etag.prepend(u"W/");
+            isCompressed = false;
+        }
+    }
+
+    setHeader({Http::HEADER_ETAG, etag});
+    if (matchesETag(request().headers.value(Http::HEADER_IF_NONE_MATCH), file.hash))
+    {
+        status(304, u"Not Modified"_s);
+        return;
+    }
+
+    if (isCompressed)
+        printEncoded(*content, file.mimeType, contentEncoding);
+    else
+        print(file.data, file.mimeType);
+}
+
+void WebApplication::compressCachedFile(const CachedFile &file, const QString &encoding)
+{
+    const QString compressedFileID = file.hash + u'-' + encoding;
+    if (m_pendingFileCompressions.contains(compressedFileID))
+        return;
+
+    m_pendingFileCompressions.insert(compressedFileID);
+    m_fileCompressionThreadPool.start([this, compressedFileID, encoding, data = file.data, generation = m_fileCacheGeneration]
+    {
+        bool ok = false;
+        QByteArray compressedData = Http::compress(data, encoding, Http::CompressionLevel::Best, &ok);
+        if (!ok || !Http::isCompressionWorthwhile(data.size(), compressedData.size()))
+            compressedData.clear();
+
+        QMetaObject::invokeMethod(this, [this, compressedFileID, compressedData = std::move(compressedData), generation]
+        {
+            // the file could be compressed again for the reset cache by now
+            if (generation != m_fileCacheGeneration)
+                return;
+
+            m_pendingFileCompressions.remove(compressedFileID);
+            m_compressedFiles.insert(compressedFileID, compressedData);
+        }, Qt::QueuedConnection);
+    });
+}
+
+// The compressions that are still running finish in vain, their results belong to the previous generation
+void WebApplication::resetFileCache()
+{
+    m_cachedFiles.clear();
+    m_compressedFiles.clear();
+    m_pendingFileCompressions.clear();
+    ++m_fileCacheGeneration;
+    m_cacheID = generateCacheID();
+}
+
 Http::Response WebApplication::processRequest(const Http::Request &request, const Http::Environment &env)
 {
     m_currentSession = nullptr;
@@ -638,9 +916,95 @@ Http::Response WebApplication::processRequest(const Http::Request &request, cons
     for (const Http::Header &prebuiltHeader : asConst(m_prebuiltHeaders))
         setHeader(prebuiltHeader);
 
+    // the request could change the data the read-only requests are answered from
+    if (m_request.method != Http::METHOD_GET)
+        publishConcurrentRequestData();
+
+    if (!m_isFirstResponseSent) [[unlikely]]
+    {
+        m_isFirstResponseSent = true;
+        LogMsg(tr("WebUI is serving requests. Time since startup: %1 ms").arg(app()->elapsedSinceStartup()));
+    }
+
     return response();
 }
 
+std::optional<Http::Response> WebApplication::processRequestConcurrently(const Http::Request &request, const Http::Environment &env)
+{
+    // Only the read-only API requests that can be answered from the published data are processed here.
+    // The rest of them, including the ones that are going to be rejected, are left to the main thread.
+    if (request.method != Http::METHOD_GET)
+        return std::nullopt;
+
+    const bool isTransferInfoRequest = (request.path == u"/api/v2/transfer/info");
+    const bool isMainLogRequest = (request.path == u"/api/v2/log/main");
+    if (!isTransferInfoRequest && !isMainLogRequest)
+        return std::nullopt;
+
+    std::shared_ptr<const ConcurrentRequestData> data;
+    {
+        const QMutexLocker locker {&m_concurrentRequestDataMutex};
+        data = m_concurrentRequestData;
+    }
+
+    if (!data)
+        return std::nullopt;
+
+    if ((data->isCSRFProtectionEnabled && (checkRequestOrigin(request) != OriginCheckResult::Allowed))
+        || (data->isHostHeaderValidationEnabled && (checkHostHeader(request, env, data->domainList) != HostHeaderCheckResult::Valid)))
+    {
+        return std::nullopt;
+    }
+
+    const QString sessionId = parseCookie(request.headers.value(u"cookie"_s)).value(data->sessionCookieName);
+    const std::shared_ptr<WebSession::ActivityTimestamp> activityTimestamp = data->sessionActivityTimestamps.value(sessionId);
+    if (!activityTimestamp || hasActivityExpired(*activityTimestamp, data->sessionTimeout))
+        return std::nullopt;
+
+    activityTimestamp->store(currentActivityTime());
+
+    const APIResultFormat resultFormat = selectResultFormat(request.headers.value(Http::HEADER_ACCEPT));
+
+    Http::Response response;
+    // the same URL returns the different content types depending on "Accept" header
+    response.headers[Http::HEADER_VARY] = u"Accept"_s;
+    response.headers[Http::HEADER_CONTENT_TYPE] = resultMimeType(resultFormat);
+    if (isTransferInfoRequest)
+    {
+        response.contentGenerator = TransferController::infoGenerator(data->transferInfo, resultFormat);
+    }
+    else
+    {
+        StringMap params;
+        for (auto iter = request.query.cbegin(); iter != request.query.cend(); ++iter)
+            params[iter.key()] = QString::fromUtf8(iter.value());
+        response.contentGenerator = LogController::mainLogGenerator(params, resultFormat);
+    }
+
+    for (const Http::Header &prebuiltHeader : asConst(data->prebuiltHeaders))
+        response.headers[prebuiltHeader.name] = prebuiltHeader.value;
+
+    return response;
+}
+
+void WebApplication::publishConcurrentRequestData()
+{
+    auto data = std::make_shared<ConcurrentRequestData>();
+    data->domainList = m_domainList;
+    data->prebuiltHeaders = m_prebuiltHeaders;
+    data->sessionCookieName = m_sessionCookieName;
+    data->sessionTimeout = m_sessionTimeout;
+    data->isCSRFProtectionEnabled = m_isCSRFProtectionEnabled;
+    data->isHostHeaderValidationEnabled = m_isHostHeaderValidationEnabled;
+    data->sessionActivityTimestamps.reserve(m_sessions.size());
+    for (const WebSession *session : asConst(m_sessions))
+        data->sessionActivityTimestamps.insert(session->id(), session->activityTimestamp());
+    data->transferInfo = TransferController::makeInfoSnapshot();
+
+    const QMutexLocker locker {&m_concurrentRequestDataMutex};
+    m_concurrentRequestData = std::move(data);
+}
+
 QString WebApplication::clientId() const
 {
     return m_clientAddress.toString();
@@ -664,6 +1028,7 @@ void WebApplication::sessionInitialize()
                 // session is outdated - removing it
                 delete m_sessions.take(sessionId);
                 m_currentSession = nullptr;
+                publishConcurrentRequestData();
             }
             else
             {
@@ -737,11 +1102,13 @@ void WebApplication::sessionStart()
     m_currentSession->registerAPIController(u"torrents"_s, new TorrentsController(app(), this));
     m_currentSession->registerAPIController(u"transfer"_s, new TransferController(app(), this));
 
-    auto *syncController = new SyncController(app(), this);
-    syncController->updateFreeDiskSpace(m_freeDiskSpaceChecker->lastResult());
-    connect(m_freeDiskSpaceChecker, &FreeDiskSpaceChecker::checked, syncController, &SyncController::updateFreeDiskSpace);
+    // it is destroyed along with the session so that the tracker stops tracking maindata for it
+    auto *syncController = new SyncController(app(), m_currentSession);
+    syncController->setMaindataTracker(m_maindataTracker);
     m_currentSession->registerAPIController(u"sync"_s, syncController);
 
+    publishConcurrentRequestData();
+
     QNetworkCookie cookie {m_sessionCookieName.toLatin1(), m_currentSession->id().toLatin1()};
     cookie.setHttpOnly(true);
     cookie.setSecure(m_isSecureCookieEnabled && m_isHttpsEnabled);
@@ -763,95 +1130,50 @@ void WebApplication::sessionEnd()
 
     delete m_sessions.take(m_currentSession->id());
     m_currentSession = nullptr;
+    publishConcurrentRequestData();
 
     setHeader({Http::HEADER_SET_COOKIE, QString::fromLatin1(cookie.toRawForm())});
 }
 
 bool WebApplication::isCrossSiteRequest(const Http::Request &request) const
 {
-    // https://www.owasp.org/index.php/Cross-Site_Request_Forgery_(CSRF)_Prevention_Cheat_Sheet#Verifying_Same_Origin_with_Standard_Headers
-
-    const auto isSameOrigin = [](const QUrl &left, const QUrl &right) -> bool
-    {
-        // [rfc6454] 5. Comparing Origins
-        return ((left.port() == right.port())
-                // && (left.scheme() == right.scheme())  // not present in this context
-                && (left.host() == right.host()));
-    };
-
     const QString targetOrigin = request.headers.value(Http::HEADER_X_FORWARDED_HOST, request.headers.value(Http::HEADER_HOST));
-    const QString originValue = request.headers.value(Http::HEADER_ORIGIN);
-    const QString refererValue = request.headers.value(Http::HEADER_REFERER);
 
-    if (originValue.isEmpty() && refererValue.isEmpty())
+    switch (checkRequestOrigin(request))
     {
-        // owasp.org recommends to block this request, but doing so will inevitably lead Web API users to spoof headers
-        // so lets be permissive here
+    case OriginCheckResult::OriginMismatch:
+        LogMsg(tr("WebUI: Origin header & Target origin mismatch! Source IP: '%1'. Origin header: '%2'. Target origin: '%3'")
+               .arg(m_env.clientAddress.toString(), request.headers.value(Http::HEADER_ORIGIN), targetOrigin)
+               , Log::WARNING);
+        return true;
+    case OriginCheckResult::RefererMismatch:
+        LogMsg(tr("WebUI: Referer header & Target origin mismatch! Source IP: '%1'. Referer header: '%2'. Target origin: '%3'")
+               .arg(m_env.clientAddress.toString(), request.headers.value(Http::HEADER_REFERER), targetOrigin)
+               , Log::WARNING);
+        return true;
+    default:
         return false;
     }
-
-    // sent with CORS requests, as well as with POST requests
-    if (!originValue.isEmpty())
-    {
-        const bool isInvalid = !isSameOrigin(urlFromHostHeader(targetOrigin), originValue);
-        if (isInvalid)
-        {
-            LogMsg(tr("WebUI: Origin header & Target origin mismatch! Source IP: '%1'. Origin header: '%2'. Target origin: '%3'")
-                   .arg(m_env.clientAddress.toString(), originValue, targetOrigin)
-                   , Log::WARNING);
-        }
-        return isInvalid;
-    }
-
-    if (!refererValue.isEmpty())
-    {
-        const bool isInvalid = !isSameOrigin(urlFromHostHeader(targetOrigin), refererValue);
-        if (isInvalid)
-        {
-            LogMsg(tr("WebUI: Referer header & Target origin mismatch! Source IP: '%1'. Referer header: '%2'. Target origin: '%3'")
-                   .arg(m_env.clientAddress.toString(), refererValue, targetOrigin)
-                   , Log::WARNING);
-        }
-        return isInvalid;
-    }
-
-    return true;
 }
 
 bool WebApplication::validateHostHeader(const QStringList &domains) const
 {
-    const QUrl hostHeader = urlFromHostHeader(m_request.headers[Http::HEADER_HOST]);
-    const QString requestHost = hostHeader.host();
-
-    // (if present) try matching host header's port with local port
-    const int requestPort = hostHeader.port();
-    if ((requestPort != -1) && (m_env.localPort != requestPort))
+    switch (checkHostHeader(m_request, m_env, domains))
     {
+    case HostHeaderCheckResult::PortMismatch:
         LogMsg(tr("WebUI: Invalid Host header, port mismatch. Request source IP: '%1'. Server port: '%2'. Received Host header: '%3'")
                .arg(m_env.clientAddress.toString()).arg(m_env.localPort)
                .arg(m_request.headers[Http::HEADER_HOST])
                 , Log::WARNING);
         return false;
-    }
-
-    // try matching host header with local address
-    const bool sameAddr = m_env.localAddress.isEqual(QHostAddress(requestHost));
-
-    if (sameAddr)
+    case HostHeaderCheckResult::HostMismatch:
+        LogMsg(tr("WebUI: Invalid Host header. Request source IP: '%1'. Received Host header: '%2'")
+               .arg(m_env.clientAddress.toString(), m_request.headers[Http::HEADER_HOST])
+                , Log::WARNING);
+        return false;
+    default:
         return true;
-
-    // try matching host header with domain list
-    for (const auto &domain : domains)
-    {
-        const QRegularExpression domainRegex {Utils::String::wildcardToRegexPattern(domain), QRegularExpression::CaseInsensitiveOption};
-        if (requestHost.contains(domainRegex))
-            return true;
     }
-
-    LogMsg(tr("WebUI: Invalid Host header. Request source IP: '%1'. Received Host header: '%2'")
-           .arg(m_env.clientAddress.toString(), m_request.headers[Http::HEADER_HOST])
-            , Log::WARNING);
-    return false;
 }
 
 QHostAddress WebApplication::resolveClientAddress() const
@@ -904,14 +1226,17 @@ QString WebSession::id() const
 
 bool WebSession::hasExpired(const qint64 seconds) const
 {
-    if (seconds <= 0)
-        return false;
-    return m_timer.hasExpired(seconds * 1000);
+    return hasActivityExpired(*m_activityTimestamp, seconds);
 }
 
 void WebSession::updateTimestamp()
 {
-    m_timer.start();
+    m_activityTimestamp->store(currentActivityTime());
+}
+
+std::shared_ptr<WebSession::ActivityTimestamp> WebSession::activityTimestamp() const
+{
+    return m_activityTimestamp;
 }
 
 void WebSession::registerAPIController(const QString &scope, APIController *controller)
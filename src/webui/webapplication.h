@@ -29,18 +29,22 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <optional>
 #include <type_traits>
 #include <utility>
 
 #include <QDateTime>
-#include <QElapsedTimer>
 #include <QHash>
 #include <QHostAddress>
 #include <QList>
 #include <QMap>
+#include <QMutex>
 #include <QObject>
 #include <QRegularExpression>
 #include <QSet>
+#include <QThreadPool>
 #include <QTranslator>
 
 #include "base/applicationcomponent.h"
@@ -53,14 +57,16 @@
 #include "base/utils/thread.h"
 #include "base/utils/version.h"
 #include "api/isessionmanager.h"
+#include "api/transfercontroller.h"
 
-inline const Utils::Version<3, 2> API_VERSION {2, 11, 3};
+inline const Utils::Version<3, 2> API_VERSION {2, 11, 17};
 
 class QTimer;
 
 class APIController;
 class AuthController;
 class FreeDiskSpaceChecker;
+class MaindataTracker;
 class WebApplication;
 
 namespace BitTorrent
@@ -71,19 +77,24 @@ namespace BitTorrent
 class WebSession final : public ApplicationComponent<QObject>, public ISession
 {
 public:
+    // monotonic time of the last request of the session in milliseconds, it is
+    // also updated by the I/O threads of the server when they answer the session requests
+    using ActivityTimestamp = std::atomic<qint64>;
+
     explicit WebSession(const QString &sid, IApplication *app);
 
     QString id() const override;
 
     bool hasExpired(qint64 seconds) const;
     void updateTimestamp();
+    std::shared_ptr<ActivityTimestamp> activityTimestamp() const;
 
     void registerAPIController(const QString &scope, APIController *controller);
     APIController *getAPIController(const QString &scope) const;
 
 private:
     const QString m_sid;
-    QElapsedTimer m_timer;  // timestamp
+    std::shared_ptr<ActivityTimestamp> m_activityTimestamp = std::make_shared<ActivityTimestamp>();
     QMap<QString, APIController *> m_apiControllers;
 };
 
@@ -99,6 +110,7 @@ public:
     ~WebApplication() override;
 
     Http::Response processRequest(const Http::Request &request, const Http::Environment &env) override;
+    std::optional<Http::Response> processRequestConcurrently(const Http::Request &request, const Http::Environment &env) override;
 
     const Http::Request &request() const;
     const Http::Environment &env() const;
@@ -107,6 +119,29 @@ public:
     void setPasswordHash(const QByteArray &passwordHash);
 
 private:
+    struct CachedFile
+    {
+        QByteArray data;
+        QString mimeType;
+        QDateTime lastModified;
+        // identifies the content in ETags and in the cache of compressed files
+        QString hash;
+    };
+
+    // The data used to answer the read-only API requests in the I/O threads of the server.
+    // It isn't modified once published, the main thread publishes the new one whenever it changes.
+    struct ConcurrentRequestData
+    {
+        QStringList domainList;
+        QList<Http::Header> prebuiltHeaders;
+        QString sessionCookieName;
+        int sessionTimeout = 0;
+        bool isCSRFProtectionEnabled = true;
+        bool isHostHeaderValidationEnabled = true;
+        QHash<QString, std::shared_ptr<WebSession::ActivityTimestamp>> sessionActivityTimestamps;
+        TransferInfoSnapshot transferInfo;
+    };
+
     QString clientId() const override;
     WebSession *session() override;
     void sessionStart() override;
@@ -114,10 +149,14 @@ private:
 
     void doProcessRequest();
     void configure();
+    void publishConcurrentRequestData();
 
     void declarePublicAPI(const QString &apiPath);
 
     void sendFile(const Path &path);
+    void sendCachedFile(const CachedFile &file);
+    void compressCachedFile(const CachedFile &file, const QString &encoding);
+    void resetFileCache();
     void sendWebUIFile();
 
     void translateDocument(QString &data) const;
@@ -141,7 +180,8 @@ private:
     Http::Request m_request;
     Http::Environment m_env;
     QHash<QString, QString> m_params;
-    const QString m_cacheID;
+    // it is renewed whenever the content of the files referring to it can change
+    QString m_cacheID;
 
     const QRegularExpression m_apiPathPattern {u"^/api/v2/(?<scope>[A-Za-z_][A-Za-z_0-9]*)/(?<action>[A-Za-z_][A-Za-z_0-9]*)$"_s};
 
@@ -171,6 +211,7 @@ private:
         {{u"search"_s, u"stop"_s}, Http::METHOD_POST},
         {{u"search"_s, u"uninstallPlugin"_s}, Http::METHOD_POST},
         {{u"search"_s, u"updatePlugins"_s}, Http::METHOD_POST},
+        {{u"sync"_s, u"maindataStream"_s}, Http::METHOD_GET},
         {{u"torrentcreator"_s, u"addTask"_s}, Http::METHOD_POST},
         {{u"torrentcreator"_s, u"deleteTask"_s}, Http::METHOD_POST},
         {{u"torrents"_s, u"add"_s}, Http::METHOD_POST},
@@ -223,13 +264,15 @@ private:
     bool m_isAltUIUsed = false;
     Path m_rootFolder;
 
-    struct TranslatedFile
-    {
-        QByteArray data;
-        QString mimeType;
-        QDateTime lastModified;
-    };
-    QHash<Path, TranslatedFile> m_translatedFiles;
+    QHash<Path, CachedFile> m_cachedFiles;
+    // compressed data of the cached files, keyed by hash and content coding,
+    // it is empty when compressing doesn't make the file smaller
+    QHash<QString, QByteArray> m_compressedFiles;
+    QSet<QString> m_pendingFileCompressions;
+    // the results of the compressions started before the cache was reset are dropped
+    quint64 m_fileCacheGeneration = 0;
+    // it must be destroyed before the data it delivers the results to
+    QThreadPool m_fileCompressionThreadPool;
     QString m_currentLocale;
     QTranslator m_translator;
     bool m_translationFileLoaded = false;
@@ -254,9 +297,15 @@ private:
     QHostAddress m_clientAddress;
 
     QList<Http::Header> m_prebuiltHeaders;
+    bool m_isFirstResponseSent = false;
+
+    mutable QMutex m_concurrentRequestDataMutex;
+    std::shared_ptr<const ConcurrentRequestData> m_concurrentRequestData;
 
     Utils::Thread::UniquePtr m_workerThread;
     FreeDiskSpaceChecker *m_freeDiskSpaceChecker = nullptr;
     QTimer *m_freeDiskSpaceCheckingTimer = nullptr;
     BitTorrent::TorrentCreationManager *m_torrentCreationManager = nullptr;
+    // tracks maindata changes once for all the sessions
+    MaindataTracker *m_maindataTracker = nullptr;
 };
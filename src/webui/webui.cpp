@@ -48,6 +48,12 @@ WebUI::WebUI(IApplication *app, const QByteArray &tempPasswordHash)
     connect(Preferences::instance(), &Preferences::changed, this, &WebUI::configure);
 }
 
+WebUI::~WebUI()
+{
+    // the connections of the server use the web application from their threads until they are gone
+    delete m_httpServer;
+}
+
 void WebUI::configure()
 {
     m_isErrored = false; // clear previous error state
@@ -53,6 +53,7 @@ class WebUI final : public ApplicationComponent<QObject>
 
 public:
     explicit WebUI(IApplication *app, const QByteArray &tempPasswordHash = {});
+    ~WebUI() override;
 
     bool isEnabled() const;
     bool isErrored() const;
@@ -0,0 +1,287 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+// Replays the trace of piece reads and writes against each disk IO backend.
+// The trace is generated unless it is given in the file set by QBT_DISK_IO_TRACE
+// environment variable, one job per line: "<r|w> <piece> <offset> <length>".
+// Run the test with "-tickcounter" or "-iterations <n>" options to compare the backends.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+
+#ifdef QBT_USES_LIBTORRENT2
+#include <libtorrent/disk_buffer_holder.hpp>
+#include <libtorrent/disk_interface.hpp>
+#include <libtorrent/file_storage.hpp>
+#include <libtorrent/io_context.hpp>
+#include <libtorrent/mmap_disk_io.hpp>
+#include <libtorrent/performance_counters.hpp>
+#include <libtorrent/posix_disk_io.hpp>
+#include <libtorrent/settings_pack.hpp>
+#include <libtorrent/storage_defs.hpp>
+#endif
+
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QObject>
+#include <QRandomGenerator>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/global.h"
+
+#ifdef QBT_USES_LIBTORRENT2
+#include "base/bittorrent/customstorage.h"
+#include "base/bittorrent/diskiostatistics.h"
+#include "base/bittorrent/diskreadcache.h"
+#include "base/bittorrent/fastrecheckregistry.h"
+
+namespace
+{
+    const int PIECE_SIZE = 256 * 1024;
+    const int FILE_COUNT = 4;
+    const qint64 FILE_SIZE = 4 * 1024 * 1024;
+    const int GENERATED_READS = 2048;
+
+    enum class Backend
+    {
+        MMap,
+        Posix,
+        CustomMMap,
+        CustomPosix,
+        CustomIOUring
+    };
+
+    struct TraceJob
+    {
+        bool isWrite = false;
+        lt::peer_request request;
+    };
+
+    QList<TraceJob> generateTrace(const int pieceCount)
+    {
+        // the torrent is downloaded sequentially and then random blocks are seeded
+        QList<TraceJob> trace;
+        for (int piece = 0; piece < pieceCount; ++piece)
+        {
+            for (int offset = 0; offset < PIECE_SIZE; offset += lt::default_block_size)
+                trace.append({true, {lt::piece_index_t(piece), offset, lt::default_block_size}});
+        }
+
+        QRandomGenerator randomGenerator {42};
+        const int blocksPerPiece = PIECE_SIZE / lt::default_block_size;
+        for (int i = 0; i < GENERATED_READS; ++i)
+        {
+            const int piece = randomGenerator.bounded(pieceCount);
+            const int offset = randomGenerator.bounded(blocksPerPiece) * lt::default_block_size;
+            trace.append({false, {lt::piece_index_t(piece), offset, lt::default_block_size}});
+        }
+
+        return trace;
+    }
+
+    QList<TraceJob> loadTrace(const QString &fileName)
+    {
+        QFile file {fileName};
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+            return {};
+
+        QList<TraceJob> trace;
+        while (!file.atEnd())
+        {
+            const QList<QByteArray> fields = file.readLine().simplified().split(' ');
+            if (fields.size() != 4)
+                continue;
+
+            const int length = std::min(fields[3].toInt(), lt::default_block_size);
+            trace.append({(fields[0] == "w"), {lt::piece_index_t(fields[1].toInt()), fields[2].toInt(), length}});
+        }
+
+        return trace;
+    }
+
+    QByteArray blockData(const lt::peer_request &request)
+    {
+        QByteArray data {request.length, Qt::Uninitialized};
+        for (int i = 0; i < request.length; ++i)
+            data[i] = static_cast<char>((static_cast<int>(request.piece) * 31) + ((request.start + i) * 7));
+        return data;
+    }
+
+    std::unique_ptr<lt::disk_interface> createDiskIO(const Backend backend, lt::io_context &ioContext
+            , const lt::settings_interface &settings, lt::counters &counters)
+    {
+        const auto customDiskIO = [&](DiskIOConstructor nativeDiskIOConstructor, const bool useIOUring)
+        {
+            return customDiskIOConstructor(std::move(nativeDiskIOConstructor), std::make_shared<BitTorrent::DiskIOStatistics>()
+                    , std::make_shared<BitTorrent::DiskReadCache>(), std::make_shared<BitTorrent::FastRecheckRegistry>()
+                    , useIOUring)(ioContext, settings, counters);
+        };
+
+        switch (backend)
+        {
+        case Backend::MMap:
+            return lt::mmap_disk_io_constructor(ioContext, settings, counters);
+        case Backend::Posix:
+            return lt::posix_disk_io_constructor(ioContext, settings, counters);
+        case Backend::CustomMMap:
+            return customDiskIO(lt::mmap_disk_io_constructor, false);
+        case Backend::CustomPosix:
+            return customDiskIO(lt::posix_disk_io_constructor, false);
+        case Backend::CustomIOUring:
+            return customDiskIO(lt::default_disk_io_constructor, true);
+        }
+
+        return nullptr;
+    }
+}
+
+Q_DECLARE_METATYPE(Backend)
+#endif
+
+class TestBitTorrentDiskIO final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBitTorrentDiskIO)
+
+public:
+    TestBitTorrentDiskIO() = default;
+
+private slots:
+#ifdef QBT_USES_LIBTORRENT2
+    void testReplayTrace_data() const
+    {
+        QTest::addColumn<Backend>("backend");
+
+        QTest::newRow("mmap") << Backend::MMap;
+        QTest::newRow("posix") << Backend::Posix;
+        QTest::newRow("custom mmap") << Backend::CustomMMap;
+        QTest::newRow("custom posix") << Backend::CustomPosix;
+#ifdef QBT_USES_IO_URING
+        QTest::newRow("custom io_uring") << Backend::CustomIOUring;
+#endif
+    }
+
+    void testReplayTrace() const
+    {
+        QFETCH(Backend, backend);
+
+        const QTemporaryDir saveDir;
+        QVERIFY(saveDir.isValid());
+
+        lt::file_storage files;
+        files.set_piece_length(PIECE_SIZE);
+        for (int i = 0; i < FILE_COUNT; ++i)
+            files.add_file(("trace/file" + std::to_string(i)), FILE_SIZE);
+        files.set_num_pieces(static_cast<int>((files.total_size() + PIECE_SIZE - 1) / PIECE_SIZE));
+        files.set_name("trace");
+
+        const QString traceFileName = qEnvironmentVariable("QBT_DISK_IO_TRACE");
+        const QList<TraceJob> trace = traceFileName.isEmpty() ? generateTrace(files.num_pieces()) : loadTrace(traceFileName);
+        QVERIFY(!trace.isEmpty());
+
+        lt::io_context ioContext;
+        const lt::settings_pack settings = lt::default_settings();
+        lt::counters counters;
+        const std::unique_ptr<lt::disk_interface> diskIO = createDiskIO(backend, ioContext, settings, counters);
+        QVERIFY(diskIO);
+
+        // the parameters refer to the path and the priorities, so they must outlive the parameters
+        const std::string savePath = saveDir.path().toStdString();
+        const lt::aux::vector<lt::download_priority_t, lt::file_index_t> priorities;
+        const lt::storage_params storageParams {files, nullptr, savePath, lt::storage_mode_sparse, priorities, lt::sha1_hash()};
+        const auto torrent = std::make_shared<int>();
+        lt::storage_holder storage = diskIO->new_torrent(storageParams, torrent);
+
+        int failedJobs = 0;
+        int mismatchedBlocks = 0;
+        QBENCHMARK
+        {
+            QSet<QPair<int, int>> writtenBlocks;
+            int pendingJobs = 0;
+            for (const TraceJob &job : trace)
+            {
+                ++pendingJobs;
+                const QPair<int, int> blockKey {static_cast<int>(job.request.piece), job.request.start};
+                if (job.isWrite)
+                {
+                    writtenBlocks.insert(blockKey);
+                    const QByteArray data = blockData(job.request);
+                    diskIO->async_write(storage, job.request, data.constData(), nullptr
+                            , [&pendingJobs, &failedJobs](const lt::storage_error &error)
+                    {
+                        --pendingJobs;
+                        if (error)
+                            ++failedJobs;
+                    }, {});
+                }
+                else
+                {
+                    const bool isWritten = writtenBlocks.contains(blockKey);
+                    diskIO->async_read(storage, job.request
+                            , [&pendingJobs, &failedJobs, &mismatchedBlocks, request = job.request, isWritten]
+                                    (const lt::disk_buffer_holder &buffer, const lt::storage_error &error)
+                    {
+                        --pendingJobs;
+                        if (error)
+                            ++failedJobs;
+                        else if (isWritten && (QByteArray(buffer.data(), buffer.size()) != blockData(request)))
+                            ++mismatchedBlocks;
+                    }, {});
+                }
+
+                diskIO->submit_jobs();
+            }
+
+            ioContext.restart();
+            while (pendingJobs > 0)
+                ioContext.run_one();
+        }
+
+        QCOMPARE(failedJobs, 0);
+        QCOMPARE(mismatchedBlocks, 0);
+
+        storage.reset();
+        diskIO->abort(true);
+        ioContext.restart();
+        ioContext.poll();
+    }
+#else
+    void testReplayTrace() const
+    {
+        QSKIP("Custom disk IO requires libtorrent 2.0");
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(TestBitTorrentDiskIO)
+#include "testbittorrentdiskio.moc"
@@ -0,0 +1,149 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <libtorrent/hasher.hpp>
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QTest>
+
+#include "base/bittorrent/infohash.h"
+#include "base/global.h"
+
+namespace
+{
+    QList<BitTorrent::TorrentID> generateIDs(const int count, const int offset = 0)
+    {
+        QList<BitTorrent::TorrentID> ids;
+        ids.reserve(count);
+        for (int i = offset; i < (offset + count); ++i)
+            ids.append(lt::hasher(reinterpret_cast<const char *>(&i), static_cast<int>(sizeof(i))).final());
+        return ids;
+    }
+
+    // hashes and compares the IDs the way it was done before they were hashed in place
+    struct CopyingTorrentID
+    {
+        BitTorrent::TorrentID id;
+
+        friend bool operator==(const CopyingTorrentID &left, const CopyingTorrentID &right)
+        {
+            return (static_cast<BitTorrent::TorrentID::UnderlyingType>(left.id)
+                == static_cast<BitTorrent::TorrentID::UnderlyingType>(right.id));
+        }
+
+        friend std::size_t qHash(const CopyingTorrentID &key, const std::size_t seed = 0)
+        {
+            return ::qHash(static_cast<BitTorrent::TorrentID::UnderlyingType>(key.id), seed);
+        }
+    };
+
+    template <typename Key>
+    void benchmarkLookup(const QList<BitTorrent::TorrentID> &ids)
+    {
+        QHash<Key, int> hash;
+        hash.reserve(ids.size());
+        for (int i = 0; i < ids.size(); ++i)
+            hash.insert(Key {ids[i]}, i);
+
+        qint64 sum = 0;
+        QBENCHMARK
+        {
+            for (const BitTorrent::TorrentID &id : ids)
+                sum += hash.value(Key {id});
+        }
+        QVERIFY(sum > 0);
+    }
+}
+
+class TestBittorrentInfoHash final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentInfoHash)
+
+public:
+    TestBittorrentInfoHash() = default;
+
+private slots:
+    void testTorrentIDHash() const
+    {
+        const auto id1 = BitTorrent::TorrentID::fromString(u"0123456789abcdef0123456789abcdef01234567"_s);
+        const auto id2 = BitTorrent::TorrentID::fromString(u"0123456789ABCDEF0123456789ABCDEF01234567"_s);
+        const auto id3 = BitTorrent::TorrentID::fromString(u"fedcba9876543210fedcba9876543210fedcba98"_s);
+
+        QVERIFY(id1.isValid());
+        QCOMPARE(id1, id2);
+        QCOMPARE(qHash(id1), qHash(id2));
+        QCOMPARE(qHash(id1, 42), qHash(id2, 42));
+        QVERIFY(id1 != id3);
+        QVERIFY(qHash(id1) != qHash(id3));
+    }
+
+    void testTorrentIDLookup() const
+    {
+        const QList<BitTorrent::TorrentID> ids = generateIDs(1000);
+        const QList<BitTorrent::TorrentID> unknownIDs = generateIDs(1000, 1000);
+
+        QHash<BitTorrent::TorrentID, int> hash;
+        for (int i = 0; i < ids.size(); ++i)
+            hash.insert(ids[i], i);
+        QCOMPARE(hash.size(), ids.size());
+
+        for (int i = 0; i < ids.size(); ++i)
+            QCOMPARE(hash.value(ids[i], -1), i);
+        for (const BitTorrent::TorrentID &id : unknownIDs)
+            QVERIFY(!hash.contains(id));
+    }
+
+    void benchmarkTorrentIDLookup_data() const
+    {
+        QTest::addColumn<int>("count");
+        QTest::addColumn<bool>("isCopying");
+
+        QTest::newRow("10k, copying") << 10'000 << true;
+        QTest::newRow("10k, in place") << 10'000 << false;
+        QTest::newRow("100k, copying") << 100'000 << true;
+        QTest::newRow("100k, in place") << 100'000 << false;
+    }
+
+    void benchmarkTorrentIDLookup() const
+    {
+        QFETCH(int, count);
+        QFETCH(bool, isCopying);
+
+        const QList<BitTorrent::TorrentID> ids = generateIDs(count);
+        if (isCopying)
+            benchmarkLookup<CopyingTorrentID>(ids);
+        else
+            benchmarkLookup<BitTorrent::TorrentID>(ids);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentInfoHash)
+#include "testbittorrentinfohash.moc"
@@ -0,0 +1,257 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <algorithm>
+
+#include <QByteArray>
+#include <QObject>
+#include <QRandomGenerator>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/http/requestparser.h"
+
+using Http::RequestParser;
+
+namespace
+{
+    const QByteArray BOUNDARY = QByteArrayLiteral("----qBittorrentTestBoundary");
+
+    QByteArray makeMultipartRequest(const QByteArray &fileData)
+    {
+        const QByteArray body = "--" + BOUNDARY + "\r\n"
+            "Content-Disposition: form-data; name=\"savepath\"\r\n"
+            "\r\n"
+            "/downloads\r\n"
+            "--" + BOUNDARY + "\r\n"
+            "Content-Disposition: form-data; name=\"torrents\"; filename=\"a.torrent\"\r\n"
+            "Content-Type: application/x-bittorrent\r\n"
+            "\r\n"
+            + fileData + "\r\n"
+            "--" + BOUNDARY + "\r\n"
+            "Content-Disposition: form-data; name=\"torrents\"; filename=\"b.torrent\"\r\n"
+            "Content-Type: application/x-bittorrent\r\n"
+            "\r\n"
+            + fileData.left(fileData.size() / 2) + "\r\n"
+            "--" + BOUNDARY + "--\r\n";
+
+        return "POST /api/v2/torrents/add HTTP/1.1\r\n"
+            "Host: localhost:8080\r\n"
+            "Content-Type: multipart/form-data; boundary=" + BOUNDARY + "\r\n"
+            "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+            "\r\n"
+            + body;
+    }
+
+    QByteArray makeRandomData(const qsizetype size, QRandomGenerator &rng)
+    {
+        QByteArray data {size, Qt::Uninitialized};
+        for (char &c : data)
+            c = static_cast<char>(rng.bounded(256));
+        return data;
+    }
+
+    // feeds the parser with the growing buffer the same way `Http::Connection` does
+    RequestParser::ParseResult parseInChunks(const QByteArray &data, const qsizetype maxChunkSize, QRandomGenerator &rng)
+    {
+        RequestParser parser;
+        QByteArray buffer;
+        qsizetype pos = 0;
+        while (pos < data.size())
+        {
+            const qsizetype chunkSize = 1 + rng.bounded(maxChunkSize);
+            buffer.append(QByteArrayView(data).sliced(pos, std::min(chunkSize, (data.size() - pos))));
+            pos += chunkSize;
+
+            RequestParser::ParseResult result = parser.parse(buffer);
+            if (result.status != RequestParser::ParseStatus::Incomplete)
+                return result;
+        }
+
+        return {RequestParser::ParseStatus::Incomplete, {}, 0};
+    }
+
+    void compareRequests(const Http::Request &left, const Http::Request &right)
+    {
+        QCOMPARE(left.method, right.method);
+        QCOMPARE(left.path, right.path);
+        QCOMPARE(left.version, right.version);
+        QCOMPARE(left.headers, right.headers);
+        QCOMPARE(left.query, right.query);
+        QCOMPARE(left.posts, right.posts);
+        QCOMPARE(left.files.size(), right.files.size());
+        for (qsizetype i = 0; i < left.files.size(); ++i)
+        {
+            QCOMPARE(left.files[i].filename, right.files[i].filename);
+            QCOMPARE(left.files[i].type, right.files[i].type);
+            QCOMPARE(left.files[i].data, right.files[i].data);
+        }
+    }
+}
+
+class TestHttpRequestParser final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestHttpRequestParser)
+
+public:
+    TestHttpRequestParser() = default;
+
+private slots:
+    void testGet() const
+    {
+        const QByteArray data = QByteArrayLiteral("GET /api/v2/sync/maindata?rid=5&foo=a+b HTTP/1.1\r\n"
+            "Host: localhost\r\n"
+            "Accept-Encoding: gzip\r\n"
+            "\r\n"
+            "GET / HTTP/1.1\r\n");
+
+        RequestParser parser;
+        const RequestParser::ParseResult result = parser.parse(data);
+        QCOMPARE(result.status, RequestParser::ParseStatus::OK);
+        QCOMPARE(static_cast<qsizetype>(result.frameSize), data.indexOf("GET /", 1));
+        QCOMPARE(result.request.method, u"GET"_s);
+        QCOMPARE(result.request.path, u"/api/v2/sync/maindata"_s);
+        QCOMPARE(result.request.query.value(u"rid"_s), QByteArrayLiteral("5"));
+        QCOMPARE(result.request.query.value(u"foo"_s), QByteArrayLiteral("a b"));
+        QCOMPARE(result.request.headers.value(u"accept-encoding"_s), u"gzip"_s);
+
+        // the parser is reset after the request is parsed
+        QCOMPARE(parser.parse(data.mid(result.frameSize)).status, RequestParser::ParseStatus::Incomplete);
+    }
+
+    void testPostFormEncoded() const
+    {
+        const QByteArray data = QByteArrayLiteral("POST /api/v2/auth/login HTTP/1.1\r\n"
+            "Content-Type: application/x-www-form-urlencoded\r\n"
+            "Content-Length: 27\r\n"
+            "\r\n"
+            "username=admin&password=a+b");
+
+        RequestParser parser;
+        QCOMPARE(parser.parse(data.chopped(1)).status, RequestParser::ParseStatus::Incomplete);
+
+        const RequestParser::ParseResult result = parser.parse(data);
+        QCOMPARE(result.status, RequestParser::ParseStatus::OK);
+        QCOMPARE(static_cast<qsizetype>(result.frameSize), data.size());
+        QCOMPARE(result.request.posts.value(u"username"_s), u"admin"_s);
+        QCOMPARE(result.request.posts.value(u"password"_s), u"a b"_s);
+    }
+
+    void testBadRequests() const
+    {
+        QCOMPARE(RequestParser().parse(QByteArrayLiteral("PUT / HTTP/1.1\r\n\r\n")).status, RequestParser::ParseStatus::BadMethod);
+        QCOMPARE(RequestParser().parse(QByteArrayLiteral("GET /\r\n\r\n")).status, RequestParser::ParseStatus::BadRequest);
+        QCOMPARE(RequestParser().parse(QByteArrayLiteral("POST / HTTP/1.1\r\nContent-Length: -1\r\n\r\n")).status
+            , RequestParser::ParseStatus::BadRequest);
+        QCOMPARE(RequestParser().parse(QByteArrayLiteral("POST / HTTP/1.1\r\nContent-Length: 999999999\r\n\r\n")).status
+            , RequestParser::ParseStatus::BadRequest);
+        QCOMPARE(RequestParser().parse(QByteArrayLiteral("POST / HTTP/1.1\r\nContent-Type: multipart/form-data\r\nContent-Length: 2\r\n\r\n")).status
+            , RequestParser::ParseStatus::BadRequest);
+    }
+
+    void testMultipartInChunks() const
+    {
+        QRandomGenerator rng {42};
+        const QByteArray fileData = makeRandomData(100 * 1024, rng);
+        const QByteArray data = makeMultipartRequest(fileData);
+
+        const RequestParser::ParseResult expected = RequestParser().parse(data);
+        QCOMPARE(expected.status, RequestParser::ParseStatus::OK);
+        QCOMPARE(static_cast<qsizetype>(expected.frameSize), data.size());
+        QCOMPARE(expected.request.posts.value(u"savepath"_s), u"/downloads"_s);
+        QCOMPARE(expected.request.files.size(), 2);
+        QCOMPARE(expected.request.files[0].filename, u"a.torrent"_s);
+        QCOMPARE(expected.request.files[0].data, fileData);
+        QCOMPARE(expected.request.files[1].data, fileData.left(fileData.size() / 2));
+
+        // delimiters must be found regardless of where the chunks are split
+        for (const qsizetype maxChunkSize : {1, 3, 7, 64, 1000, 65536})
+        {
+            const RequestParser::ParseResult result = parseInChunks(data, maxChunkSize, rng);
+            QCOMPARE(result.status, RequestParser::ParseStatus::OK);
+            QCOMPARE(result.frameSize, expected.frameSize);
+            compareRequests(result.request, expected.request);
+        }
+    }
+
+    void testFuzz() const
+    {
+        QRandomGenerator rng {1337};
+        const QByteArray validData = makeMultipartRequest(makeRandomData(4096, rng));
+
+        for (int i = 0; i < 500; ++i)
+        {
+            // corrupt a few random bytes of the valid request, or use completely random data
+            QByteArray data = validData;
+            if ((i % 10) == 0)
+            {
+                data = makeRandomData(rng.bounded(1, 8192), rng);
+            }
+            else
+            {
+                const int corruptions = rng.bounded(1, 8);
+                for (int j = 0; j < corruptions; ++j)
+                    data[rng.bounded(data.size())] = static_cast<char>(rng.bounded(256));
+            }
+
+            // incremental parsing must give the same result as parsing the whole data at once
+            const RequestParser::ParseResult expected = RequestParser().parse(data);
+            const RequestParser::ParseResult result = parseInChunks(data, rng.bounded(1, 2048), rng);
+            QCOMPARE(result.status, expected.status);
+            if (expected.status == RequestParser::ParseStatus::OK)
+            {
+                QCOMPARE(result.frameSize, expected.frameSize);
+                compareRequests(result.request, expected.request);
+            }
+        }
+    }
+
+    void benchmarkMultipartUpload() const
+    {
+        QRandomGenerator rng {7};
+        const QByteArray data = makeMultipartRequest(makeRandomData(8 * 1024 * 1024, rng));
+        const qsizetype chunkSize = 64 * 1024;
+
+        QBENCHMARK
+        {
+            RequestParser parser;
+            QByteArray buffer;
+            RequestParser::ParseResult result;
+            for (qsizetype pos = 0; pos < data.size(); pos += chunkSize)
+            {
+                buffer.append(QByteArrayView(data).sliced(pos, std::min(chunkSize, (data.size() - pos))));
+                result = parser.parse(buffer);
+            }
+            QCOMPARE(result.status, RequestParser::ParseStatus::OK);
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(TestHttpRequestParser)
+#include "testhttprequestparser.moc"
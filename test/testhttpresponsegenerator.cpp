@@ -0,0 +1,109 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QObject>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/http/responsegenerator.h"
+#include "base/http/types.h"
+
+class TestHttpResponseGenerator final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestHttpResponseGenerator)
+
+public:
+    TestHttpResponseGenerator() = default;
+
+private slots:
+    void testSelectContentEncoding() const
+    {
+        QCOMPARE(Http::selectContentEncoding(u""), QString());
+        QCOMPARE(Http::selectContentEncoding(u"identity"), QString());
+        QCOMPARE(Http::selectContentEncoding(u"gzip"), Http::CONTENT_ENCODING_GZIP);
+        QCOMPARE(Http::selectContentEncoding(u"GZIP;q=0.5"), Http::CONTENT_ENCODING_GZIP);
+        QCOMPARE(Http::selectContentEncoding(u"gzip;q=0"), QString());
+        QCOMPARE(Http::selectContentEncoding(u"*"), Http::CONTENT_ENCODING_GZIP);
+        QCOMPARE(Http::selectContentEncoding(u"*, gzip;q=0"), QString());
+        QCOMPARE(Http::selectContentEncoding(u"deflate, gzip;q=invalid"), QString());
+
+#ifdef QBT_USES_ZSTD
+        QCOMPARE(Http::selectContentEncoding(u"gzip, deflate, br, zstd"), Http::CONTENT_ENCODING_ZSTD);
+        QCOMPARE(Http::selectContentEncoding(u"gzip, zstd;q=0.5"), Http::CONTENT_ENCODING_GZIP);
+#else
+        QCOMPARE(Http::selectContentEncoding(u"gzip;q=0.5, zstd"), Http::CONTENT_ENCODING_GZIP);
+#endif
+
+#ifdef QBT_USES_BROTLI
+        QCOMPARE(Http::selectContentEncoding(u"gzip, br"), Http::CONTENT_ENCODING_BROTLI);
+#else
+        QCOMPARE(Http::selectContentEncoding(u"gzip;q=0.5, br"), Http::CONTENT_ENCODING_GZIP);
+#endif
+    }
+
+    void testIsCompressible() const
+    {
+        QVERIFY(!Http::isCompressible(Http::CONTENT_TYPE_JS, 1024));
+        QVERIFY(Http::isCompressible(Http::CONTENT_TYPE_JS, 1025));
+        QVERIFY(!Http::isCompressible(Http::CONTENT_TYPE_PNG, 4096));
+    }
+
+    void testIsCompressionWorthwhile() const
+    {
+        QVERIFY(Http::isCompressionWorthwhile(2048, 1000));
+        QVERIFY(Http::isCompressionWorthwhile(2048, 2023));
+        QVERIFY(!Http::isCompressionWorthwhile(2048, 2024));
+        QVERIFY(!Http::isCompressionWorthwhile(2048, 4096));
+    }
+
+    void testCompressContent() const
+    {
+        const QByteArray content = QByteArray("qBittorrent ").repeated(1024);
+        const Http::CompressionStatistics statisticsBefore = Http::compressionStatistics();
+
+        Http::Response response;
+        response.headers[Http::HEADER_CONTENT_TYPE] = Http::CONTENT_TYPE_JSON;
+        response.content = content;
+        Http::compressContent(response, Http::CONTENT_ENCODING_GZIP);
+        QCOMPARE(response.headers.value(Http::HEADER_CONTENT_ENCODING), Http::CONTENT_ENCODING_GZIP);
+        QVERIFY(response.content.size() < content.size());
+        QCOMPARE(Http::compressionStatistics().count, (statisticsBefore.count + 1));
+
+        Http::Response encodedResponse;
+        encodedResponse.content = content;
+        encodedResponse.isCompressionAllowed = false;
+        Http::compressContent(encodedResponse, Http::CONTENT_ENCODING_GZIP);
+        QVERIFY(!encodedResponse.headers.contains(Http::HEADER_CONTENT_ENCODING));
+        QCOMPARE(encodedResponse.content, content);
+        QCOMPARE(Http::compressionStatistics().count, (statisticsBefore.count + 1));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestHttpResponseGenerator)
+#include "testhttpresponsegenerator.moc"
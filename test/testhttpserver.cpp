@@ -0,0 +1,224 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <atomic>
+#include <functional>
+#include <optional>
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <QObject>
+#include <QPointer>
+#include <QTcpSocket>
+#include <QTest>
+#include <QThread>
+
+#include "base/global.h"
+#include "base/http/eventstream.h"
+#include "base/http/irequesthandler.h"
+#include "base/http/server.h"
+#include "base/http/types.h"
+
+namespace
+{
+    class RequestHandler final : public Http::IRequestHandler
+    {
+    public:
+        std::function<Http::Response (const Http::Request &request)> handler;
+        std::function<std::optional<Http::Response> (const Http::Request &request)> concurrentHandler;
+
+        Http::Response processRequest(const Http::Request &request, [[maybe_unused]] const Http::Environment &env) override
+        {
+            return handler(request);
+        }
+
+        std::optional<Http::Response> processRequestConcurrently(const Http::Request &request, [[maybe_unused]] const Http::Environment &env) override
+        {
+            if (!concurrentHandler)
+                return std::nullopt;
+            return concurrentHandler(request);
+        }
+    };
+
+    QByteArray makeRequest(const QString &path)
+    {
+        return "GET " + path.toLatin1() + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    }
+}
+
+class TestHttpServer final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestHttpServer)
+
+public:
+    TestHttpServer() = default;
+
+private slots:
+    void init()
+    {
+        m_server = new Http::Server(&m_requestHandler, this);
+        QVERIFY(m_server->listen(QHostAddress::LocalHost));
+
+        m_socket = new QTcpSocket(this);
+        connect(m_socket, &QIODevice::readyRead, this, [this] { m_received += m_socket->readAll(); });
+        m_socket->connectToHost(QHostAddress::LocalHost, m_server->serverPort());
+        QTRY_COMPARE(m_socket->state(), QAbstractSocket::ConnectedState);
+    }
+
+    void cleanup()
+    {
+        delete m_socket;
+        delete m_server;
+        m_received.clear();
+        m_requestHandler.concurrentHandler = {};
+    }
+
+    void testGeneratedContent()
+    {
+        std::atomic<QThread *> generatorThread = nullptr;
+        m_requestHandler.handler = [&generatorThread](const Http::Request &)
+        {
+            Http::Response response;
+            response.headers[Http::HEADER_CONTENT_TYPE] = Http::CONTENT_TYPE_TXT;
+            response.contentGenerator = [&generatorThread]
+            {
+                generatorThread = QThread::currentThread();
+                return QByteArray("generated content");
+            };
+            return response;
+        };
+
+        m_socket->write(makeRequest(u"/"_s));
+        QTRY_VERIFY(m_received.endsWith("\r\n\r\ngenerated content"));
+        QVERIFY(generatorThread.load());
+        QVERIFY(generatorThread.load() != thread());
+    }
+
+    void testPipelinedRequests()
+    {
+        const int requestCount = 100;
+
+        m_requestHandler.handler = [](const Http::Request &request)
+        {
+            Http::Response response;
+            response.headers[Http::HEADER_CONTENT_TYPE] = Http::CONTENT_TYPE_TXT;
+            response.content = "<" + request.path.toLatin1() + ">";
+            return response;
+        };
+
+        // all the requests arrive at once, while only some of them are processed at a time
+        QByteArray requests;
+        for (int i = 0; i < requestCount; ++i)
+            requests += makeRequest(u"/%1"_s.arg(i));
+        m_socket->write(requests);
+
+        QTRY_VERIFY(m_received.contains("</" + QByteArray::number(requestCount - 1) + ">"));
+
+        // responses are sent in the order of the requests
+        qsizetype pos = 0;
+        for (int i = 0; i < requestCount; ++i)
+        {
+            const qsizetype responsePos = m_received.indexOf("</" + QByteArray::number(i) + ">", pos);
+            QVERIFY(responsePos > pos);
+            pos = responsePos;
+        }
+    }
+
+    void testConcurrentlyProcessedRequests()
+    {
+        std::atomic<QThread *> handlerThread = nullptr;
+        m_requestHandler.concurrentHandler = [&handlerThread](const Http::Request &request) -> std::optional<Http::Response>
+        {
+            if (request.path != u"/concurrent")
+                return std::nullopt;
+
+            handlerThread = QThread::currentThread();
+
+            Http::Response response;
+            response.headers[Http::HEADER_CONTENT_TYPE] = Http::CONTENT_TYPE_TXT;
+            response.content = "concurrent";
+            return response;
+        };
+
+        bool isProcessed = false;
+        m_requestHandler.handler = [&isProcessed](const Http::Request &request)
+        {
+            isProcessed = true;
+
+            Http::Response response;
+            response.headers[Http::HEADER_CONTENT_TYPE] = Http::CONTENT_TYPE_TXT;
+            response.content = "<" + request.path.toLatin1() + ">";
+            return response;
+        };
+
+        m_socket->write(makeRequest(u"/concurrent"_s));
+        QTRY_VERIFY(m_received.endsWith("\r\n\r\nconcurrent"));
+        QVERIFY(!isProcessed);
+        QVERIFY(handlerThread.load());
+        QVERIFY(handlerThread.load() != thread());
+
+        // the requests the handler declines are processed in the main thread
+        m_socket->write(makeRequest(u"/other"_s));
+        QTRY_VERIFY(m_received.endsWith("</other>"));
+        QVERIFY(isProcessed);
+    }
+
+    void testUndeliveredEventStream()
+    {
+        QPointer<Http::EventStream> stream;
+        bool isProcessed = false;
+        m_requestHandler.handler = [this, &stream, &isProcessed](const Http::Request &)
+        {
+            // the connection is closed while the request is being processed
+            m_socket->abort();
+            QTest::qWait(500);
+
+            stream = new Http::EventStream(this);
+            isProcessed = true;
+
+            Http::Response response;
+            response.eventStream = stream;
+            return response;
+        };
+
+        m_socket->write(makeRequest(u"/events"_s));
+        QTRY_VERIFY(isProcessed);
+        // the stream that can't be sent is deleted, since no connection takes it
+        QTRY_VERIFY(stream.isNull());
+    }
+
+private:
+    RequestHandler m_requestHandler;
+    Http::Server *m_server = nullptr;
+    QTcpSocket *m_socket = nullptr;
+    QByteArray m_received;
+};
+
+QTEST_GUILESS_MAIN(TestHttpServer)
+#include "testhttpserver.moc"
@@ -0,0 +1,169 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <limits>
+
+#include <QByteArray>
+#include <QCborMap>
+#include <QCborValue>
+#include <QObject>
+#include <QTest>
+#include <QVariantMap>
+
+#include "base/global.h"
+#include "base/utils/cbor.h"
+
+class TestUtilsCbor final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestUtilsCbor)
+
+public:
+    TestUtilsCbor() = default;
+
+private slots:
+    void testWriteValues() const
+    {
+        Utils::Cbor::Writer writer;
+        writer.beginArray();
+        writer.writeInt(0);
+        writer.writeInt(23);
+        writer.writeInt(24);
+        writer.writeInt(-1);
+        writer.writeInt(-500);
+        writer.writeInt(1'000'000);
+        writer.writeBool(true);
+        writer.writeNull();
+        writer.writeDouble(0.5);
+        writer.writeDouble(0.1);
+        writer.endArray();
+
+        QCOMPARE(writer.data(), QByteArray::fromHex("9f" "00" "17" "1818" "20" "3901f3" "1a000f4240"
+            "f5" "f6" "fa3f000000" "fb3fb999999999999a" "ff"));
+    }
+
+    void testWriteStringsWithoutStringRefs() const
+    {
+        Utils::Cbor::Writer writer;
+        writer.beginArray();
+        writer.writeString(u"abc"_s);
+        writer.writeString(u"abc"_s);
+        writer.endArray();
+
+        QCOMPARE(writer.data(), QByteArray::fromHex("9f" "63616263" "63616263" "ff"));
+    }
+
+    void testWriteStringRefs() const
+    {
+        Utils::Cbor::Writer writer {0, true};
+        writer.beginArray();
+        writer.writeString(u"ab"_s); // too short to be referred to
+        writer.writeString(u"ab"_s);
+        writer.writeString(u"abc"_s);
+        writer.writeString(u"abcd"_s);
+        writer.writeString(u"abc"_s);
+        writer.writeString(u"abcd"_s);
+        writer.endArray();
+
+        QCOMPARE(writer.data(), QByteArray::fromHex("d90100" "9f" "626162" "626162" "63616263" "6461626364"
+            "d81900" "d81901" "ff"));
+    }
+
+    void testTakeDataResetsStringRefs() const
+    {
+        Utils::Cbor::Writer writer {0, true};
+        writer.writeString(u"abc"_s);
+        const QByteArray data = writer.takeData();
+
+        writer.writeString(u"abc"_s);
+        QCOMPARE(writer.data(), data);
+    }
+
+    void testWriteVariant() const
+    {
+        const QVariantMap map {
+            {u"int"_s, 42},
+            {u"string"_s, u"ü 日本"_s},
+            {u"list"_s, QVariantList {true, 1.5}},
+            {u"map"_s, QVariantMap {{u"int"_s, -1}}}
+        };
+
+        Utils::Cbor::Writer writer;
+        writer.writeVariant(map);
+
+        const QCborValue value = QCborValue::fromCbor(writer.data());
+        QVERIFY(value.isMap());
+
+        const QCborMap result = value.toMap();
+        QCOMPARE(result.value(u"int"_s).toInteger(), 42);
+        QCOMPARE(result.value(u"string"_s).toString(), u"ü 日本"_s);
+        QCOMPARE(result.value(u"list"_s).toVariant(), QVariant(QVariantList {true, 1.5}));
+        QCOMPARE(result.value(u"map"_s).toMap().value(u"int"_s).toInteger(), -1);
+    }
+
+    void testWriteUnsignedVariant() const
+    {
+        Utils::Cbor::Writer writer;
+        writer.beginArray();
+        writer.writeVariant(std::numeric_limits<quint64>::max());
+        writer.writeVariant(std::numeric_limits<uint>::max());
+        writer.endArray();
+
+        QCOMPARE(writer.data(), QByteArray::fromHex("9f" "1bffffffffffffffff" "1affffffff" "ff"));
+    }
+
+    void testWriteVariantWithStringRefs() const
+    {
+        const QVariantMap map {
+            {u"int"_s, 42},
+            {u"map"_s, QVariantMap {{u"int"_s, -1}}}
+        };
+
+        Utils::Cbor::Writer writer {0, true};
+        writer.writeVariant(map);
+
+        // the only repeated string is "int" which is resolved by QCborValue as a tag,
+        // so the nested map is checked separately
+        const QCborValue value = QCborValue::fromCbor(writer.data());
+        QVERIFY(value.isTag());
+        QCOMPARE(value.tag(), QCborTag(256));
+
+        const QCborMap result = value.taggedValue().toMap();
+        QCOMPARE(result.value(u"int"_s).toInteger(), 42);
+
+        const QCborMap nestedMap = result.value(u"map"_s).toMap();
+        QCOMPARE(nestedMap.size(), 1);
+        const QCborValue nestedKey = nestedMap.keys().first();
+        QVERIFY(nestedKey.isTag());
+        QCOMPARE(nestedKey.tag(), QCborTag(25));
+        QCOMPARE(nestedMap.value(nestedKey).toInteger(), -1);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestUtilsCbor)
+#include "testutilscbor.moc"
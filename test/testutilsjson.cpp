@@ -0,0 +1,136 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <limits>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QObject>
+#include <QTest>
+#include <QVariantMap>
+
+#include "base/global.h"
+#include "base/utils/json.h"
+
+class TestUtilsJson final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestUtilsJson)
+
+public:
+    TestUtilsJson() = default;
+
+private slots:
+    void testWriteObject() const
+    {
+        Utils::Json::Writer writer;
+        writer.beginObject();
+        writer.writeKey(u"int"_s);
+        writer.writeInt(-42);
+        writer.writeKey(u"bool"_s);
+        writer.writeBool(true);
+        writer.writeKey(u"null"_s);
+        writer.writeNull();
+        writer.writeKey(u"list"_s);
+        writer.writeStringList({u"a"_s, u"b"_s});
+        writer.writeKey(u"empty"_s);
+        writer.beginObject();
+        writer.endObject();
+        writer.endObject();
+
+        QCOMPARE(writer.data(), QByteArray(R"({"int":-42,"bool":true,"null":null,"list":["a","b"],"empty":{}})"));
+    }
+
+    void testWriteString() const
+    {
+        const QString str = u"quote\" backslash\\ tab\t nl\n ctrl\x01 ü 日本"_s;
+
+        Utils::Json::Writer writer;
+        writer.beginArray();
+        writer.writeString(str);
+        writer.endArray();
+
+        QCOMPARE(writer.data(), u"[\"quote\\\" backslash\\\\ tab\\t nl\\n ctrl\\u0001 ü 日本\"]"_s.toUtf8());
+
+        QJsonParseError error;
+        const QJsonDocument doc = QJsonDocument::fromJson(writer.data(), &error);
+        QCOMPARE(error.error, QJsonParseError::NoError);
+        QCOMPARE(doc.array().at(0).toString(), str);
+    }
+
+    void testWriteDouble() const
+    {
+        Utils::Json::Writer writer;
+        writer.beginArray();
+        writer.writeDouble(0.1);
+        writer.writeDouble(1);
+        writer.writeDouble(-2.5e-7);
+        writer.writeDouble(std::numeric_limits<double>::quiet_NaN());
+        writer.writeDouble(std::numeric_limits<double>::infinity());
+        writer.endArray();
+
+        const QJsonArray array = QJsonDocument::fromJson(writer.data()).array();
+        QCOMPARE(array.size(), 5);
+        QCOMPARE(array.at(0).toDouble(), 0.1);
+        QCOMPARE(array.at(1).toDouble(), 1.0);
+        QCOMPARE(array.at(2).toDouble(), -2.5e-7);
+        QVERIFY(array.at(3).isNull());
+        QVERIFY(array.at(4).isNull());
+    }
+
+    void testWriteVariant() const
+    {
+        const QVariantMap map {
+            {u"string"_s, u"value"_s},
+            {u"number"_s, 1.5},
+            {u"longlong"_s, Q_INT64_C(1) << 40},
+            {u"map"_s, QVariantMap {{u"nested"_s, false}}},
+            {u"list"_s, QVariantList {1, u"two"_s, QVariant()}}
+        };
+
+        Utils::Json::Writer writer;
+        writer.writeVariant(map);
+
+        QCOMPARE(QJsonDocument::fromJson(writer.data()).object(), QJsonObject::fromVariantMap(map));
+    }
+
+    void testWriteUnsignedVariant() const
+    {
+        Utils::Json::Writer writer;
+        writer.beginArray();
+        writer.writeVariant(std::numeric_limits<quint64>::max());
+        writer.writeVariant(std::numeric_limits<uint>::max());
+        writer.endArray();
+
+        QCOMPARE(writer.data(), QByteArray("[18446744073709551615,4294967295]"));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestUtilsJson)
+#include "testutilsjson.moc"
@@ -0,0 +1,223 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QObject>
+#include <QTest>
+
+#include "base/global.h"
+#include "webui/api/maindatachangelog.h"
+
+namespace
+{
+    const SerializedTorrent::Fields ALL_TORRENT_FIELDS = SerializedTorrent::Fields().set();
+
+    SerializedTorrent makeTorrent(const QString &hash, const QString &name)
+    {
+        SerializedTorrent torrent;
+        torrent.infoHashV1 = hash;
+        torrent.name = name;
+        return torrent;
+    }
+
+    SerializedTorrent::Fields fields(const SerializedTorrent::Field field)
+    {
+        SerializedTorrent::Fields result;
+        result.set(static_cast<std::size_t>(field));
+        return result;
+    }
+
+    MaindataSyncBuf addedTorrent(const QString &hash, const QString &name)
+    {
+        MaindataSyncBuf change;
+        change.torrents[hash] = {makeTorrent(hash, name), ALL_TORRENT_FIELDS};
+        return change;
+    }
+
+    MaindataSyncBuf renamedTorrent(const QString &hash, const QString &name)
+    {
+        MaindataSyncBuf change;
+        change.torrents[hash] = {makeTorrent(hash, name), fields(SerializedTorrent::Field::Name)};
+        return change;
+    }
+
+    MaindataSyncBuf removedTorrent(const QString &hash)
+    {
+        MaindataSyncBuf change;
+        change.removedTorrents.append(hash);
+        return change;
+    }
+}
+
+class TestWebUIMaindataChangeLog final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestWebUIMaindataChangeLog)
+
+public:
+    TestWebUIMaindataChangeLog() = default;
+
+private slots:
+    void testMergeAdd() const
+    {
+        MaindataSyncBuf syncBuf;
+        mergeMaindataSyncBuf(syncBuf, addedTorrent(u"a"_s, u"A"_s));
+
+        MaindataSyncBuf change = addedTorrent(u"b"_s, u"B"_s);
+        change.tags.append(u"tag"_s);
+        change.categories[u"cat"_s] = {{u"name"_s, u"cat"_s}, {u"savePath"_s, u"/downloads"_s}};
+        change.trackers[u"udp://tracker"_s] = {u"b"_s};
+        mergeMaindataSyncBuf(syncBuf, change);
+
+        QCOMPARE(syncBuf.torrents.size(), 2);
+        QCOMPARE(syncBuf.torrents[u"a"_s].torrent.name, u"A"_s);
+        QCOMPARE(syncBuf.torrents[u"b"_s].changedFields, ALL_TORRENT_FIELDS);
+        QCOMPARE(syncBuf.tags, QVariantList {u"tag"_s});
+        QCOMPARE(syncBuf.categories[u"cat"_s].value(u"savePath"_s).toString(), u"/downloads"_s);
+        QCOMPARE(syncBuf.trackers[u"udp://tracker"_s], QStringList {u"b"_s});
+        QVERIFY(syncBuf.removedTorrents.isEmpty());
+    }
+
+    void testMergeUpdate() const
+    {
+        MaindataSyncBuf syncBuf;
+        mergeMaindataSyncBuf(syncBuf, renamedTorrent(u"a"_s, u"A1"_s));
+
+        MaindataSyncBuf change;
+        SerializedTorrent torrent = makeTorrent(u"a"_s, u"A1"_s);
+        torrent.downloadSpeed = 1024;
+        change.torrents[u"a"_s] = {torrent, fields(SerializedTorrent::Field::DownloadSpeed)};
+        change.categories[u"cat"_s] = {{u"savePath"_s, u"/other"_s}};
+        change.serverState = {{u"dl_info_speed"_s, 1024}};
+        mergeMaindataSyncBuf(syncBuf, change);
+        mergeMaindataSyncBuf(syncBuf, renamedTorrent(u"a"_s, u"A2"_s));
+
+        // the fields changed earlier are still reported, with the latest values
+        const TorrentSyncData &syncData = syncBuf.torrents[u"a"_s];
+        QCOMPARE(syncData.torrent.name, u"A2"_s);
+        QCOMPARE(syncData.changedFields
+                , (fields(SerializedTorrent::Field::Name) | fields(SerializedTorrent::Field::DownloadSpeed)));
+        QCOMPARE(syncBuf.categories[u"cat"_s].value(u"savePath"_s).toString(), u"/other"_s);
+        QCOMPARE(syncBuf.serverState.value(u"dl_info_speed"_s).toInt(), 1024);
+    }
+
+    void testMergeRemove() const
+    {
+        MaindataSyncBuf syncBuf;
+        mergeMaindataSyncBuf(syncBuf, renamedTorrent(u"a"_s, u"A1"_s));
+
+        MaindataSyncBuf change = removedTorrent(u"a"_s);
+        change.removedTags.append(u"tag"_s);
+        change.removedCategories.append(u"cat"_s);
+        change.removedTrackers.append(u"udp://tracker"_s);
+        mergeMaindataSyncBuf(syncBuf, change);
+
+        QVERIFY(syncBuf.torrents.isEmpty());
+        QCOMPARE(syncBuf.removedTorrents, QStringList {u"a"_s});
+        QCOMPARE(syncBuf.removedTags, QStringList {u"tag"_s});
+        QCOMPARE(syncBuf.removedCategories, QStringList {u"cat"_s});
+        QCOMPARE(syncBuf.removedTrackers, QStringList {u"udp://tracker"_s});
+    }
+
+    void testMergeReAdd() const
+    {
+        MaindataSyncBuf syncBuf;
+        mergeMaindataSyncBuf(syncBuf, renamedTorrent(u"a"_s, u"A1"_s));
+        mergeMaindataSyncBuf(syncBuf, removedTorrent(u"a"_s));
+
+        MaindataSyncBuf change = addedTorrent(u"a"_s, u"A2"_s);
+        change.tags.append(u"tag"_s);
+        mergeMaindataSyncBuf(syncBuf, change);
+
+        MaindataSyncBuf tagRemoval;
+        tagRemoval.removedTags.append(u"tag"_s);
+        mergeMaindataSyncBuf(syncBuf, tagRemoval);
+
+        MaindataSyncBuf tagReAddition;
+        tagReAddition.tags.append(u"tag"_s);
+        mergeMaindataSyncBuf(syncBuf, tagReAddition);
+
+        QVERIFY(syncBuf.removedTorrents.isEmpty());
+        QCOMPARE(syncBuf.torrents[u"a"_s].torrent.name, u"A2"_s);
+        QCOMPARE(syncBuf.torrents[u"a"_s].changedFields, ALL_TORRENT_FIELDS);
+        QVERIFY(syncBuf.removedTags.isEmpty());
+        QCOMPARE(syncBuf.tags, QVariantList {u"tag"_s});
+    }
+
+    void testCollectChanges() const
+    {
+        MaindataChangeLog changeLog;
+        changeLog.append(2, addedTorrent(u"a"_s, u"A"_s), 0);
+        changeLog.append(3, renamedTorrent(u"a"_s, u"A1"_s), 0);
+        changeLog.append(4, removedTorrent(u"a"_s), 0);
+
+        MaindataSyncBuf syncBuf;
+        QVERIFY(changeLog.collectChanges(4, 4, syncBuf));
+        QVERIFY(syncBuf.isEmpty());
+
+        QVERIFY(changeLog.collectChanges(2, 4, syncBuf));
+        QVERIFY(syncBuf.torrents.isEmpty());
+        QCOMPARE(syncBuf.removedTorrents, QStringList {u"a"_s});
+
+        syncBuf = {};
+        QVERIFY(changeLog.collectChanges(1, 4, syncBuf));
+        QVERIFY(syncBuf.torrents.isEmpty());
+        QCOMPARE(syncBuf.removedTorrents, QStringList {u"a"_s});
+
+        syncBuf = {};
+        QVERIFY(changeLog.collectChanges(1, 3, syncBuf));
+        QCOMPARE(syncBuf.torrents[u"a"_s].torrent.name, u"A1"_s);
+        QCOMPARE(syncBuf.torrents[u"a"_s].changedFields, ALL_TORRENT_FIELDS);
+
+        syncBuf = {};
+        QVERIFY(!changeLog.collectChanges(5, 4, syncBuf));
+        QVERIFY(!changeLog.collectChanges(0, 4, syncBuf));
+        QVERIFY(syncBuf.isEmpty());
+    }
+
+    void testTrimChangeLog() const
+    {
+        MaindataChangeLog changeLog;
+        for (int id = 2; id <= 1001; ++id)
+            changeLog.append(id, renamedTorrent(u"a"_s, QString::number(id)), 0);
+
+        QCOMPARE(changeLog.size(), 256);
+
+        // the changes dropped from the log can't be collected anymore
+        MaindataSyncBuf syncBuf;
+        QVERIFY(!changeLog.collectChanges((1001 - 257), 1001, syncBuf));
+        QVERIFY(changeLog.collectChanges((1001 - 256), 1001, syncBuf));
+        QCOMPARE(syncBuf.torrents[u"a"_s].torrent.name, u"1001"_s);
+
+        changeLog.clear();
+        QCOMPARE(changeLog.size(), 0);
+        QVERIFY(!changeLog.collectChanges(1000, 1001, syncBuf));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestWebUIMaindataChangeLog)
+#include "testwebuimaindatachangelog.moc"
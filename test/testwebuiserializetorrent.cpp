@@ -0,0 +1,289 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <limits>
+#include <utility>
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/path.h"
+#include "base/tag.h"
+#include "base/utils/cbor.h"
+#include "base/utils/json.h"
+#include "webui/api/serialize/serialize_torrent.h"
+
+namespace
+{
+    const int BENCHMARK_TORRENTS_COUNT = 50'000;
+
+    SerializedTorrent makeTorrent(const int index)
+    {
+        const QString hash = u"%1"_s.arg(index, 40, 16, u'0');
+
+        SerializedTorrent torrent;
+        torrent.infoHashV1 = hash;
+        torrent.name = u"Synthetic torrent #%1"_s.arg(index);
+        torrent.magnetURI = u"magnet:?xt=urn:btih:"_s + hash;
+        torrent.size = (Q_INT64_C(1) << 30) + index;
+        torrent.progress = (index % 100) / 100.0;
+        torrent.downloadSpeed = (index % 7) * 1024;
+        torrent.uploadSpeed = (index % 5) * 1024;
+        torrent.queuePosition = index + 1;
+        torrent.seeds = index % 10;
+        torrent.numComplete = index % 50;
+        torrent.state = BitTorrent::TorrentState::Downloading;
+        torrent.eta = 3600;
+        torrent.category = u"category %1"_s.arg(index % 20);
+        torrent.tags = {Tag(u"tag %1"_s.arg(index % 3)), Tag(u"tag %1"_s.arg(index % 5))};
+        torrent.savePath = Path(u"/downloads/category %1"_s.arg(index % 20));
+        torrent.contentPath = torrent.savePath / Path(torrent.name);
+        torrent.rootPath = torrent.contentPath;
+        torrent.addedOn = 1700000000 + index;
+        torrent.completionOn = -1;
+        torrent.tracker = u"udp://tracker.example.org:1337/announce"_s;
+        torrent.trackersCount = 1;
+        torrent.amountDownloaded = torrent.size / 2;
+        torrent.amountLeft = torrent.size - torrent.amountDownloaded;
+        torrent.ratio = 0.25;
+        torrent.ratioLimit = -2;
+        torrent.seedingTimeLimit = -2;
+        torrent.inactiveSeedingTimeLimit = -2;
+        torrent.comment = u"Comment with \"quotes\" and\nnew line"_s;
+        torrent.isPrivate = ((index % 2) == 0);
+        torrent.totalSize = torrent.size;
+        torrent.hasMetadata = true;
+        return torrent;
+    }
+
+    template <typename Writer>
+    void writeTorrents(Writer &writer, const QList<SerializedTorrent> &torrents)
+    {
+        const SerializedTorrent::Fields allFields = SerializedTorrent::Fields().set();
+
+        writer.beginObject();
+        for (const SerializedTorrent &torrent : torrents)
+        {
+            writer.writeKey(torrent.infoHashV1);
+            writer.beginObject();
+            writeFields(writer, torrent, allFields);
+            writer.endObject();
+        }
+        writer.endObject();
+    }
+
+    // simulates the torrent state after one refresh interval
+    SerializedTorrent updateTorrent(SerializedTorrent torrent)
+    {
+        torrent.downloadSpeed += 512;
+        torrent.amountDownloaded += 512;
+        torrent.amountLeft -= 512;
+        torrent.progress += 0.001;
+        torrent.lastActivity += 1;
+        return torrent;
+    }
+}
+
+class TestWebUISerializeTorrent final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestWebUISerializeTorrent)
+
+public:
+    TestWebUISerializeTorrent() = default;
+
+private slots:
+    void testChangedFields() const
+    {
+        using Field = SerializedTorrent::Field;
+
+        const SerializedTorrent torrent = makeTorrent(1);
+        QVERIFY(changedFields(torrent, torrent).none());
+
+        SerializedTorrent changedTorrent = torrent;
+        changedTorrent.state = BitTorrent::TorrentState::StoppedDownloading;
+        changedTorrent.tags.insert(Tag(u"new tag"_s));
+        changedTorrent.isPrivate.reset();
+
+        SerializedTorrent::Fields expectedFields;
+        expectedFields.set(static_cast<std::size_t>(Field::State));
+        expectedFields.set(static_cast<std::size_t>(Field::Tags));
+        expectedFields.set(static_cast<std::size_t>(Field::Private));
+        QCOMPARE(changedFields(torrent, changedTorrent), expectedFields);
+    }
+
+    void testWriteFields() const
+    {
+        const SerializedTorrent torrent = makeTorrent(2);
+
+        Utils::Json::Writer writer;
+        writer.beginObject();
+        writeFields(writer, torrent, SerializedTorrent::Fields().set());
+        writer.endObject();
+
+        QJsonParseError error;
+        const QJsonDocument doc = QJsonDocument::fromJson(writer.data(), &error);
+        QCOMPARE(error.error, QJsonParseError::NoError);
+        QCOMPARE(doc.object(), QJsonObject::fromVariantMap(toVariantMap(torrent)));
+    }
+
+    void testWriteChangedFields() const
+    {
+        const SerializedTorrent torrent = makeTorrent(3);
+        const SerializedTorrent updatedTorrent = updateTorrent(torrent);
+
+        Utils::Json::Writer writer;
+        writer.beginObject();
+        writeFields(writer, updatedTorrent, changedFields(torrent, updatedTorrent));
+        writer.endObject();
+
+        const QJsonObject object = QJsonDocument::fromJson(writer.data()).object();
+        QCOMPARE(object.size(), 5);
+        QCOMPARE(object.value(KEY_TORRENT_DLSPEED).toInt(), updatedTorrent.downloadSpeed);
+        QCOMPARE(object.value(KEY_TORRENT_PROGRESS).toDouble(), updatedTorrent.progress);
+    }
+
+    void testPageRange() const
+    {
+        using Range = std::pair<qsizetype, qsizetype>;
+
+        QCOMPARE(pageRange(5, 0, 0), Range(0, 5));
+        QCOMPARE(pageRange(5, 1, 2), Range(1, 3));
+        QCOMPARE(pageRange(5, -2, 0), Range(3, 5));
+        QCOMPARE(pageRange(5, 5, 2), Range(0, 2));
+        QCOMPARE(pageRange(5, 1, std::numeric_limits<int>::max()), Range(1, 5));
+        QCOMPARE(pageRange(5, std::numeric_limits<int>::min(), std::numeric_limits<int>::max()), Range(0, 5));
+        QCOMPARE(pageRange(0, 1, 1), Range(0, 0));
+    }
+
+    void testSortedPageIndexes_data() const
+    {
+        QTest::addColumn<bool>("reverse");
+        QTest::addColumn<int>("offset");
+        QTest::addColumn<int>("limit");
+        QTest::addColumn<QList<qsizetype>>("expectedIndexes");
+
+        QTest::newRow("all") << false << 0 << 0 << QList<qsizetype> {1, 3, 2, 0, 4};
+        QTest::newRow("first page") << false << 0 << 2 << QList<qsizetype> {1, 3};
+        QTest::newRow("second page") << false << 2 << 2 << QList<qsizetype> {2, 0};
+        QTest::newRow("last page") << false << 4 << 2 << QList<qsizetype> {4};
+        QTest::newRow("from end") << false << -2 << 0 << QList<qsizetype> {0, 4};
+        QTest::newRow("offset past end") << false << 5 << 2 << QList<qsizetype> {1, 3};
+        QTest::newRow("huge limit") << false << 1 << std::numeric_limits<int>::max() << QList<qsizetype> {3, 2, 0, 4};
+        QTest::newRow("huge negative offset") << false << std::numeric_limits<int>::min() << 1 << QList<qsizetype> {1};
+        QTest::newRow("reverse") << true << 0 << 0 << QList<qsizetype> {4, 0, 2, 1, 3};
+        QTest::newRow("reverse page") << true << 2 << 2 << QList<qsizetype> {2, 1};
+    }
+
+    void testSortedPageIndexes() const
+    {
+        QFETCH(bool, reverse);
+        QFETCH(int, offset);
+        QFETCH(int, limit);
+        QFETCH(QList<qsizetype>, expectedIndexes);
+
+        const QList<SerializedTorrentSortKey> sortKeys {30LL, 10LL, 20LL, 10LL, 40LL};
+        QCOMPARE(sortedPageIndexes(sortKeys, reverse, offset, limit), expectedIndexes);
+    }
+
+    void benchmarkChangesOfManyTorrents() const
+    {
+        QList<SerializedTorrent> torrents;
+        QList<SerializedTorrent> updatedTorrents;
+        torrents.reserve(BENCHMARK_TORRENTS_COUNT);
+        updatedTorrents.reserve(BENCHMARK_TORRENTS_COUNT);
+        for (int i = 0; i < BENCHMARK_TORRENTS_COUNT; ++i)
+        {
+            torrents.append(makeTorrent(i));
+            updatedTorrents.append(updateTorrent(torrents.last()));
+        }
+
+        QBENCHMARK
+        {
+            Utils::Json::Writer writer {BENCHMARK_TORRENTS_COUNT * 128};
+            writer.beginObject();
+            for (qsizetype i = 0; i < torrents.size(); ++i)
+            {
+                writer.writeKey(torrents[i].infoHashV1);
+                writer.beginObject();
+                writeFields(writer, updatedTorrents[i], changedFields(torrents[i], updatedTorrents[i]));
+                writer.endObject();
+            }
+            writer.endObject();
+            QVERIFY(!writer.data().isEmpty());
+        }
+    }
+
+    void benchmarkFullDataOfManyTorrents_data() const
+    {
+        QTest::addColumn<QString>("format");
+
+        QTest::newRow("JSON") << u"JSON"_s;
+        QTest::newRow("CBOR") << u"CBOR"_s;
+    }
+
+    void benchmarkFullDataOfManyTorrents() const
+    {
+        QFETCH(QString, format);
+
+        QList<SerializedTorrent> torrents;
+        torrents.reserve(BENCHMARK_TORRENTS_COUNT);
+        for (int i = 0; i < BENCHMARK_TORRENTS_COUNT; ++i)
+            torrents.append(makeTorrent(i));
+
+        qsizetype size = 0;
+        if (format == u"CBOR")
+        {
+            QBENCHMARK
+            {
+                Utils::Cbor::Writer writer {BENCHMARK_TORRENTS_COUNT * 1024};
+                writeTorrents(writer, torrents);
+                size = writer.data().size();
+            }
+        }
+        else
+        {
+            QBENCHMARK
+            {
+                Utils::Json::Writer writer {BENCHMARK_TORRENTS_COUNT * 1024};
+                writeTorrents(writer, torrents);
+                size = writer.data().size();
+            }
+        }
+
+        QVERIFY(size > 0);
+        qInfo("%s size: %lld bytes", qUtf8Printable(format), static_cast<long long>(size));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestWebUISerializeTorrent)
+#include "testwebuiserializetorrent.moc"